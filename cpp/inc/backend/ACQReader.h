@@ -0,0 +1,91 @@
+#ifndef ACQREADER_H
+#define ACQREADER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <iosfwd>
+#include "ACQMetadata.h"
+
+/**
+ * @brief Native in-process reader for BIOPAC AcqKnowledge (.acq) files
+ *
+ * Parses the graph header, the per-channel headers and the channel data type
+ * headers, then decodes the interleaved sample stream (honouring each
+ * channel's sample divider) straight into ChannelData objects.
+ *
+ * Only uncompressed files are decoded. Layouts that fail validation are
+ * rejected with an error so the caller can fall back to the Python converter.
+ */
+class ACQReader {
+public:
+    ACQReader();
+    ~ACQReader();
+
+    /**
+     * @brief Read an ACQ file and decode all channels
+     * @param acqFilePath Path to .acq file
+     * @return File metadata with loaded channels, or nullptr on failure
+     */
+    std::shared_ptr<ACQFileMetadata> readFile(const std::string& acqFilePath);
+
+    std::string getLastError() const { return lastError; }
+
+private:
+    /**
+     * @brief Fields of the graph (file) header used by the reader
+     */
+    struct GraphHeader {
+        int32_t version;
+        int32_t headerLength;
+        int16_t numChannels;
+        double sampleTimeMs;  // Milliseconds per base-rate tick
+    };
+
+    /**
+     * @brief Fields of a per-channel header used by the reader
+     */
+    struct ChannelHeader {
+        int32_t headerLength;
+        int16_t number;
+        std::string name;
+        std::string units;
+        int32_t numSamples;
+        double amplScale;
+        double amplOffset;
+        int16_t divider;
+    };
+
+    /**
+     * @brief Per-channel sample encoding
+     */
+    struct ChannelDType {
+        int16_t size;  // Bytes per sample
+        int16_t type;  // 1 = double, 2 = int16
+    };
+
+    std::string lastError;
+    bool bigEndian;
+
+    bool parseHeaders(std::ifstream& file,
+                      int64_t fileSize,
+                      GraphHeader& graph,
+                      std::vector<ChannelHeader>& channels,
+                      std::vector<ChannelDType>& dtypes,
+                      int64_t& dataOffset);
+
+    bool decodeSamples(std::ifstream& file,
+                       const std::vector<ChannelHeader>& channels,
+                       const std::vector<ChannelDType>& dtypes,
+                       std::vector<std::vector<float>>& samples);
+
+    int16_t readInt16(const char* p) const;
+    int32_t readInt32(const char* p) const;
+    double readDouble(const char* p) const;
+    std::string readString(const char* p, size_t maxLen) const;
+    bool readBlock(std::ifstream& file, int64_t offset, size_t length,
+                   std::vector<char>& block);
+};
+
+#endif // ACQREADER_H
@@ -0,0 +1,91 @@
+#ifndef ARRAYFILEREADER_H
+#define ARRAYFILEREADER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ACQMetadata.h"
+
+class MappedFile;
+
+/**
+ * @brief Loads channels from NumPy .npy/.npz and raw float32 files
+ *
+ * Reads what ArrayFileWriter writes, and plain np.save / np.savez output:
+ * - .npy: a 1-D array is one channel; a 2-D array is split along its shorter
+ *   axis (so both (channels, samples) and (samples, channels) work).
+ * - .npz: every stored '<name>.npy' member becomes a channel, with rates
+ *   from '_sample_rates.npy' if present. Compressed members
+ *   (np.savez_compressed) are rejected.
+ * - .f32: arrays described by the .json header next to it.
+ *
+ * Contiguous aligned little-endian float32 data is not copied: the file is
+ * memory-mapped and channels wrap the mapping, so loading is near-instant
+ * however long the recording is. Other dtypes (f8, i2, u2, i4) and strided
+ * layouts are converted to float32 once.
+ */
+class ArrayFileReader {
+public:
+    // Used when the file carries no sample rate (.npy, foreign .npz)
+    static constexpr float DEFAULT_SAMPLE_RATE = 1000.0f;
+
+    ArrayFileReader();
+    ~ArrayFileReader();
+
+    /**
+     * @brief True for extensions this reader handles (.npy, .npz, .f32)
+     */
+    static bool isArrayFile(const std::string& path);
+
+    /**
+     * @brief Read all arrays of a file as channels
+     * @return File metadata with loaded channels, or nullptr on failure
+     */
+    std::shared_ptr<ACQFileMetadata> readFile(const std::string& path);
+
+    std::string getLastError() const { return lastError; }
+
+private:
+    /**
+     * @brief Parsed .npy header
+     */
+    struct NpyArray {
+        char kind;           // 'f', 'i' or 'u'
+        size_t itemSize;
+        bool fortranOrder;
+        std::vector<size_t> shape;
+        size_t dataOffset;   // From the start of the .npy data
+    };
+
+    /**
+     * @brief One channel to be loaded from the mapping
+     */
+    struct ArraySource {
+        std::string name;
+        std::string units;
+        float sampleRate;
+        size_t offset;       // Byte offset of the first sample in the mapping
+        size_t count;
+        size_t stride;       // In elements
+        char kind;
+        size_t itemSize;
+    };
+
+    std::string lastError;
+
+    bool parseNpyHeader(const char* data, size_t size, NpyArray& array);
+    bool addNpyArrays(const NpyArray& array, size_t base, const std::string& name,
+                      std::vector<ArraySource>& sources);
+    bool readNpy(const MappedFile& file, const std::string& name, std::vector<ArraySource>& sources);
+    bool readNpz(const MappedFile& file, std::vector<ArraySource>& sources);
+    bool readRaw(const std::string& dataPath, const MappedFile& file, std::vector<ArraySource>& sources);
+
+    /**
+     * @brief Wrap or convert one source's samples
+     */
+    static SampleBuffer::Ptr makeBuffer(const std::shared_ptr<const MappedFile>& file,
+                                        const ArraySource& source);
+};
+
+#endif // ARRAYFILEREADER_H
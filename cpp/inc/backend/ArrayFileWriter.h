@@ -0,0 +1,100 @@
+#ifndef ARRAYFILEWRITER_H
+#define ARRAYFILEWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SampleBuffer.h"
+
+class BufferedWriter;
+
+/**
+ * @brief Writes sample arrays as NumPy .npy/.npz or raw float32 files
+ *
+ * Formats that numpy reads without parsing text:
+ * - .npy: one '<f4' array. Several arrays of equal length become one 2-D
+ *   (arrays x samples) array; ragged arrays need .npz or raw.
+ * - .npz: a stored (uncompressed) zip with one '<name>.npy' member per
+ *   array, plus '_sample_rates.npy' (float64, same order). Member data is
+ *   64-byte aligned, so ArrayFileReader can map it in place. Zip64 is used
+ *   when a member or the archive passes 4 GB.
+ * - raw: packed '<f4' arrays back to back in x.f32, described by x.json
+ *   (name, units, sample_rate, byte offset and count of each array).
+ *
+ * Samples go from the SampleBuffer to the file in one write per array, with
+ * no per-sample formatting. Data is written in host byte order, which is
+ * little-endian on every platform we build for.
+ */
+class ArrayFileWriter {
+public:
+    ArrayFileWriter();
+    ~ArrayFileWriter();
+
+    /**
+     * @brief Add samples [start, end) of buffer as a named array
+     *
+     * Names are made unique and reduced to [A-Za-z0-9_] for .npz keys.
+     */
+    void addArray(const std::string& name, SampleBuffer::Ptr buffer,
+                  size_t start, size_t end,
+                  double sampleRate, const std::string& units = std::string());
+
+    /**
+     * @brief Add a whole buffer as a named array
+     */
+    void addArray(const std::string& name, SampleBuffer::Ptr buffer,
+                  double sampleRate, const std::string& units = std::string());
+
+    size_t getNumArrays() const { return arrays.size(); }
+
+    bool writeNpy(const std::string& path);
+    bool writeNpz(const std::string& path);
+
+    /**
+     * @brief Write path (.f32 data) and its .json header next to it
+     */
+    bool writeRaw(const std::string& path);
+
+    /**
+     * @brief Write by extension: .npy, .npz, otherwise raw
+     */
+    bool writeFile(const std::string& path);
+
+    /**
+     * @brief Header file that writeRaw() pairs with a data path
+     */
+    static std::string rawHeaderPath(const std::string& dataPath);
+
+    /**
+     * @brief CRC-32 (IEEE, as in zip and zlib) of data, continuing from crc
+     *
+     * Also used by the channel cache to checksum its blocks.
+     */
+    static uint32_t crc32(uint32_t crc, const void* data, size_t size);
+
+    const std::string& getLastError() const { return lastError; }
+
+    // Alignment of array data inside .npy and .npz files
+    static constexpr size_t DATA_ALIGNMENT = 64;
+
+private:
+    struct Array {
+        std::string name;
+        SampleBuffer::Ptr buffer;
+        SampleView samples;
+        double sampleRate;
+        std::string units;
+    };
+
+    std::vector<Array> arrays;
+    std::string lastError;
+
+    static std::string npyHeader(const char* descr, const std::string& shape);
+
+    bool writeZipMember(BufferedWriter& out, const std::string& name,
+                        const std::string& header, const void* data, size_t dataSize,
+                        std::vector<char>& directory, uint64_t& numEntries);
+};
+
+#endif // ARRAYFILEWRITER_H
@@ -0,0 +1,82 @@
+#ifndef BLOCKCODEC_H
+#define BLOCKCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Lossless compression of one block of samples for the channel cache
+ *
+ * Samples from an ADC sit on a grid: value = offset + level * step. A block
+ * whose samples all decode from a grid level to bit-identical floats is
+ * stored as level deltas, zigzag-mapped and Rice coded with the best
+ * parameter k for that block. Noisy 16-bit signals typically need 4-8 bits
+ * per sample. Every other block (filtered or floating-point data, or
+ * samples the grid reproduces only approximately) is kept as raw float32,
+ * so decoding always returns exactly the encoded samples.
+ *
+ * The grid is the ADC scaling the reader applied (adcGrid()), decoded with
+ * the same float expression as ACQReader. Channels without a known scaling
+ * (converter output, filtered or floating-point data) have no grid and are
+ * stored raw: a grid estimated from float samples is never precise enough
+ * to reproduce them bit for bit.
+ *
+ * Every block is self-contained (the first level is stored verbatim), so
+ * blocks decode independently and in any order.
+ */
+class BlockCodec {
+public:
+    enum Mode : uint8_t {
+        RAW_FLOAT = 0,
+        RICE_DELTA = 1
+    };
+
+    // Added to signed 16-bit ADC codes to make them levels
+    static constexpr int32_t ADC_LEVEL_BIAS = 32768;
+
+    // Levels are limited to 24 bits so deltas always fit the escape code
+    static constexpr uint32_t MAX_LEVELS = 1u << 24;
+
+    /**
+     * @brief Per-block summary, also used as a min/max index
+     */
+    struct BlockInfo {
+        uint8_t mode;
+        uint8_t riceParameter;
+        float min;
+        float max;
+    };
+
+    /**
+     * @brief Grid of a channel's samples
+     *
+     * Level decodes to float(level - ADC_LEVEL_BIAS) * float(step) +
+     * float(offset) in float arithmetic.
+     */
+    struct Grid {
+        double offset;
+        double step;   // 0 if the samples are not on a usable grid
+    };
+
+    /**
+     * @brief Grid of 16-bit samples decoded as raw * scale + offset in float
+     */
+    static Grid adcGrid(float scale, float offset);
+
+    /**
+     * @brief Encode one block
+     * @param out Encoded bytes are appended
+     */
+    static BlockInfo encode(const float* samples, size_t count, const Grid& grid,
+                            std::vector<uint8_t>& out);
+
+    /**
+     * @brief Decode one block of count samples
+     * @return False if the data is truncated or corrupt
+     */
+    static bool decode(const uint8_t* data, size_t size, const BlockInfo& info,
+                       const Grid& grid, size_t count, float* out);
+};
+
+#endif // BLOCKCODEC_H
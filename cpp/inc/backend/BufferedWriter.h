@@ -0,0 +1,103 @@
+#ifndef BUFFEREDWRITER_H
+#define BUFFEREDWRITER_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Buffered file output with locale-free number formatting
+ *
+ * Text and numbers are collected in one large buffer and handed to the file
+ * in buffer-sized writes, so exporters never flush per value or per line.
+ * Numbers go through std::to_chars: floats use the shortest representation
+ * that reads back to the same value, which is both exact and several times
+ * faster than iostream formatting.
+ *
+ * Write errors are sticky: after the first failure further writes are
+ * dropped, and close() reports it through getLastError().
+ */
+class BufferedWriter {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+
+    // Longest to_chars output for any float, double or 64-bit integer
+    static constexpr size_t MAX_NUMBER_CHARS = 32;
+
+    explicit BufferedWriter(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    /**
+     * @brief Create (truncate) path for binary writing
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Flush and close
+     * @return False if any write failed since open()
+     */
+    bool close();
+
+    bool isOpen() const { return file.is_open(); }
+    bool good() const { return !failed; }
+
+    void write(const char* data, size_t size);
+    void write(std::string_view text) { write(text.data(), text.size()); }
+
+    void put(char c) {
+        if (used == buffer.size()) {
+            flush();
+        }
+        buffer[used++] = c;
+    }
+
+    /**
+     * @brief Shortest round-trip decimal form ("nan"/"inf" if not finite)
+     */
+    void writeFloat(float value);
+    void writeDouble(double value);
+
+    template <typename T>
+    void writeInteger(T value) {
+        static_assert(std::is_integral<T>::value, "writeInteger needs an integer type");
+        reserve(MAX_NUMBER_CHARS);
+        used = std::to_chars(&buffer[used], &buffer[0] + buffer.size(), value).ptr - &buffer[0];
+    }
+
+    /**
+     * @brief Write buffered data to the file
+     */
+    void flush();
+
+    /**
+     * @brief Bytes accepted since open(), buffered or not
+     */
+    uint64_t getBytesWritten() const { return flushed + used; }
+
+    const std::string& getLastError() const { return lastError; }
+
+private:
+    std::ofstream file;
+    std::vector<char> buffer;
+    size_t used;
+    uint64_t flushed;
+    bool failed;
+    std::string path;
+    std::string lastError;
+
+    void reserve(size_t size) {
+        if (buffer.size() - used < size) {
+            flush();
+        }
+    }
+};
+
+#endif // BUFFEREDWRITER_H
@@ -0,0 +1,95 @@
+#ifndef CHANNELCACHEREADER_H
+#define CHANNELCACHEREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ACQMetadata.h"
+#include "BlockCodec.h"
+
+class MappedFile;
+
+/**
+ * @brief Reads channel cache files written by ChannelCacheWriter
+ *
+ * open() maps the file and reads only the block index. Blocks decode
+ * independently, either one at a time with decodeBlock() or all of them in
+ * parallel with readFile().
+ */
+class ChannelCacheReader {
+public:
+    /**
+     * @brief One encoded block and its summary
+     */
+    struct Block {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t crc;
+        BlockCodec::BlockInfo info;
+    };
+
+    /**
+     * @brief One cached channel
+     */
+    struct Channel {
+        std::string name;
+        std::string units;
+        float sampleRate;
+        uint64_t numSamples;
+        uint32_t blockSamples;
+        BlockCodec::Grid grid;
+        std::vector<Block> blocks;
+    };
+
+    ChannelCacheReader();
+    ~ChannelCacheReader();
+
+    /**
+     * @brief Map a cache file and read its index
+     */
+    bool open(const std::string& path);
+    void close();
+
+    /**
+     * @brief True if the cache was made from a source of this size and mtime
+     */
+    bool matchesSource(uint64_t size, int64_t modified) const;
+
+    const std::vector<Channel>& getChannels() const { return channels; }
+
+    /**
+     * @brief Decode one block of a channel
+     * @param out Receives up to blockSamples samples (fewer in the last block)
+     * @return False if the block fails its checksum or doesn't decode
+     */
+    bool decodeBlock(size_t channel, size_t block, float* out) const;
+
+    /**
+     * @brief Load every channel if the cache is present and up to date
+     *
+     * Blocks decode in parallel; statistics are computed from the decoded
+     * samples with DataAnalyzer::computeMoments(), as ACQReader does.
+     * The source file name is left for the caller to set.
+     * @return File metadata with loaded channels, or nullptr if the cache is
+     *         missing, stale or corrupt (see getLastError())
+     */
+    std::shared_ptr<ACQFileMetadata> readFile(const std::string& path, uint64_t expectedSize,
+                                              int64_t expectedModified);
+
+    void setNumThreads(unsigned threads) { numThreads = threads; }
+    std::string getLastError() const { return lastError; }
+
+private:
+    std::shared_ptr<MappedFile> file;
+    std::vector<Channel> channels;
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    unsigned numThreads;
+    std::string lastError;
+
+    bool parseIndex();
+};
+
+#endif // CHANNELCACHEREADER_H
@@ -0,0 +1,75 @@
+#ifndef CHANNELCACHEWRITER_H
+#define CHANNELCACHEWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ACQMetadata.h"
+
+/**
+ * @brief Writes decoded channels to a compact cache file (.acqc)
+ *
+ * Each channel is cut into blocks of BLOCK_SAMPLES samples and every block
+ * is compressed on its own by BlockCodec, on all cores. The index at the end
+ * of the file lists each block's position, min and max, so readers can
+ * seek to any block and get a coarse min/max overview without decoding
+ * anything. Mean and std are recomputed from the decoded samples, exactly
+ * as a fresh decode computes them.
+ *
+ * Layout (little-endian):
+ *   header   "ACQC", u32 version, u64 source size, i64 source mtime
+ *   blocks   encoded block payloads, channel after channel
+ *   index    u32 channels; per channel: u16+name, u16+units, f32 rate,
+ *            u64 samples, u32 block samples, f64 grid offset, f64 grid step
+ *            (0: no grid), then per block: u64 offset, u32 size,
+ *            u32 payload CRC-32, u8 mode, u8 rice k, f32 min, f32 max
+ *   footer   u64 index offset, u32 index CRC-32, "ACQC", u32 version
+ *
+ * Channels with a known ADC scaling (ChannelData::hasAdcScale()) use it
+ * as their grid; others are stored as raw float32. BlockCodec only
+ * compresses blocks that decode bit-exactly, so a cached channel loads
+ * identical to the decoded one.
+ *
+ * The source size and modification time identify the recording the cache
+ * was made from; ChannelCacheReader rejects the cache when they change.
+ * The CRCs catch corrupted index entries and payloads. The file is written
+ * under a temporary name unique to this process and write, and renamed
+ * when complete, so concurrent writers of the same cache never mix.
+ */
+class ChannelCacheWriter {
+public:
+    static constexpr uint32_t VERSION = 5;
+    static constexpr size_t BLOCK_SAMPLES = 4096;
+
+    // Blocks encoded in parallel before they are written out
+    static constexpr size_t BATCH_BLOCKS = 256;
+
+    ChannelCacheWriter();
+    ~ChannelCacheWriter();
+
+    /**
+     * @brief Identify the source recording (size in bytes, mtime in ms)
+     */
+    void setSource(uint64_t size, int64_t modified);
+
+    void addChannel(std::shared_ptr<ChannelData> channel);
+    void addChannels(const ACQFileMetadata& file);
+    void setNumThreads(unsigned threads) { numThreads = threads; }
+
+    bool writeFile(const std::string& path);
+
+    uint64_t getBytesWritten() const { return bytesWritten; }
+    const std::string& getLastError() const { return lastError; }
+
+private:
+    std::vector<std::shared_ptr<ChannelData>> channels;
+    uint64_t sourceSize;
+    int64_t sourceModified;
+    unsigned numThreads;
+    uint64_t bytesWritten;
+    std::string lastError;
+};
+
+#endif // CHANNELCACHEWRITER_H
@@ -0,0 +1,119 @@
+#ifndef CSVEXPORTER_H
+#define CSVEXPORTER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "SampleBuffer.h"
+
+/**
+ * @brief Parallel CSV writer for one or more channels
+ *
+ * The exported rows are cut into chunks whose worst-case text fits in
+ * CHUNK_BYTES, so wide exports get fewer rows per chunk. Worker threads
+ * format chunks with std::to_chars into their own memory buffers, and the
+ * calling thread writes the finished chunks to the file strictly in order.
+ * Each thread owns one buffer plus slotsPerThread (2) ring slots, so memory
+ * stays at about 3 * CHUNK_BYTES per thread whatever the export size or
+ * channel count, and formatting runs ahead of the disk on every core.
+ *
+ * Rows are "time, channel..., [label]". Time is sampleIndex / sampleRate
+ * with 6 decimals, and samples use the shortest round-trip form. Channels
+ * recorded at an integer fraction of the fastest rate (ACQ dividers) repeat
+ * their last sample on the rows in between. A sample past a channel's end
+ * leaves its field empty.
+ *
+ * Without ranges every row is exported. With addRange() only the given
+ * sample ranges (row-rate indices) are exported, in the order they were
+ * added, and a range's label fills the label column.
+ */
+class CsvExporter {
+public:
+    static constexpr size_t CHUNK_BYTES = 1 << 20;
+
+    CsvExporter();
+    ~CsvExporter();
+
+    /**
+     * @brief Add a channel column
+     * @param sampleRate The channel's own rate in Hz
+     */
+    void addColumn(const std::string& header, SampleBuffer::Ptr buffer, double sampleRate);
+
+    /**
+     * @brief Export only rows [start, end), tagged with label
+     */
+    void addRange(size_t start, size_t end, const std::string& label = std::string());
+
+    void setTimeHeader(const std::string& header) { timeHeader = header; }
+    void setNumThreads(unsigned threads) { numThreads = threads; }
+
+    /**
+     * @brief Row rate in Hz: the fastest channel's rate
+     */
+    double getRowRate() const;
+
+    /**
+     * @brief Number of rows at the row rate
+     */
+    size_t getNumRows() const;
+
+    /**
+     * @brief Write the CSV file
+     * @return False on an empty export or a write error (see getLastError())
+     */
+    bool exportToFile(const std::string& path);
+
+    size_t getRowsWritten() const { return rowsWritten; }
+    const std::string& getLastError() const { return lastError; }
+
+private:
+    struct Column {
+        std::string header;
+        SampleBuffer::Ptr buffer;
+        double sampleRate;
+        size_t divider;  // Rows per sample of this channel
+    };
+
+    struct Range {
+        size_t start;
+        size_t end;
+        std::string label;
+    };
+
+    struct Chunk {
+        size_t range;
+        size_t start;
+        size_t end;
+    };
+
+    /**
+     * @brief Reusable, uninitialised output buffer
+     *
+     * Unlike std::vector::resize(), growing it doesn't zero-fill memory
+     * that the formatter overwrites anyway.
+     */
+    struct Text {
+        std::unique_ptr<char[]> data;
+        size_t capacity = 0;
+        size_t size = 0;
+
+        // Room for at least bytes, emptied; keeps the memory it already has
+        void reserve(size_t bytes);
+    };
+
+    std::vector<Column> columns;
+    std::vector<Range> ranges;
+    std::string timeHeader;
+    unsigned numThreads;
+    size_t rowsWritten;
+    std::string lastError;
+
+    std::string header(bool withLabels) const;
+    size_t maxRowChars(size_t labelSize, bool withLabels) const;
+    void formatChunk(const Chunk& chunk, double rate, const std::string& label,
+                     bool withLabels, Text& out) const;
+};
+
+#endif // CSVEXPORTER_H
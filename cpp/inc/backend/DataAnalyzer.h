@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 #include "ChannelData.h"
 
 /**
@@ -25,20 +26,121 @@ public:
         float median;
     };
 
+    /**
+     * @brief Exact moments of a signal, accumulated in double
+     */
+    struct Moments {
+        size_t count = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+        double m2 = 0.0;  // Sum of squared deviations from the mean
+
+        double variance() const { return count > 0 ? m2 / count : 0.0; }
+        double stdDev() const;
+        double rms() const;
+    };
+
     /**
      * @brief Calculate statistics for signal data
+     *
+     * Min/max/mean/std/RMS come from computeMoments(), the median from
+     * calculateMedian().
      * @param data Input signal data
      * @return Statistics structure
      */
-    Statistics calculateStatistics(const std::vector<float>& data);
+    Statistics calculateStatistics(SampleView data);
+
+    /**
+     * @brief Min, max, mean, variance and RMS in one pass over memory
+     *
+     * Works through L1-sized blocks: each block is reduced with SIMD into
+     * double accumulators (min/max and sum, then squared deviations from
+     * the block mean while the block is still cached), and blocks are
+     * merged with Chan's pairwise update. No float accumulator ever sees
+     * more than a block, so 10^8 samples keep full precision.
+     */
+    static Moments computeMoments(SampleView data);
+
+    /**
+     * @brief Median (mean of the two middle values for even counts)
+     *
+     * Up to EXACT_MEDIAN_LIMIT samples: nth_element on a copy held in a
+     * reusable scratch arena. Larger inputs: a streaming histogram over
+     * [min, max] locates the median's bin, and only that bin's samples are
+     * selected exactly, so memory stays bounded. If that bin alone exceeds
+     * the limit (heavily repeated values) its centre is returned, which is
+     * within one bin width (range / HISTOGRAM_BINS) of the true median.
+     */
+    float calculateMedian(SampleView data);
 
     /**
-     * @brief Calculate power spectrum density (simplified)
+     * @brief Mean/std/RMS/min/max of samples [start, end) of a buffer
+     *
+     * Answered from the buffer's RangeIndex (built once per buffer), so
+     * repeated queries, e.g. for thousands of labelled segments, cost
+     * O(log n) each instead of a pass over the segment.
+     * @return False if the range is empty after clamping
+     */
+    static bool calculateRangeStatistics(const SampleBuffer& buffer,
+                                         size_t start,
+                                         size_t end,
+                                         RangeStats& stats);
+
+    static constexpr size_t EXACT_MEDIAN_LIMIT = size_t(1) << 24;
+    static constexpr size_t HISTOGRAM_BINS = size_t(1) << 16;
+
+    /**
+     * @brief Window applied to each Welch segment (periodic form)
+     */
+    enum WindowType {
+        WINDOW_RECTANGULAR,
+        WINDOW_HANN,
+        WINDOW_HAMMING,
+        WINDOW_BLACKMAN
+    };
+
+    /**
+     * @brief Welch PSD settings
+     */
+    struct WelchParams {
+        size_t segmentLength = DEFAULT_SEGMENT_LENGTH;  // Zero-padded to a power of two
+        float overlap = 0.5f;                           // Fraction shared by neighbours, [0, 1)
+        WindowType window = WINDOW_HANN;
+        unsigned numThreads = 0;                        // 0 = hardware concurrency
+    };
+
+    /**
+     * @brief One-sided power spectral density
+     */
+    struct Spectrum {
+        std::vector<float> frequencies;  // Hz, DC to Nyquist
+        std::vector<float> power;        // units^2 / Hz
+        size_t numSegments = 0;
+    };
+
+    static constexpr size_t DEFAULT_SEGMENT_LENGTH = 1024;
+
+    /**
+     * @brief Power spectral density with the default Welch settings
+     * @param data Input signal data
+     * @param sampleRate Sample rate in Hz
+     * @return Vector of power values (units^2 / Hz), DC to Nyquist
+     */
+    std::vector<float> calculatePSD(SampleView data, float sampleRate);
+
+    /**
+     * @brief Welch power spectral density
+     *
+     * Averages the windowed, mean-removed periodograms of overlapping
+     * segments. Segments are spread over worker threads, so hour-long
+     * channels and short labelled segments (pass a subview) both work.
      * @param data Input signal data
      * @param sampleRate Sample rate in Hz
-     * @return Vector of power values
+     * @param params Window, segment length and overlap
+     * @return Empty spectrum on invalid input (see getLastError())
      */
-    std::vector<float> calculatePSD(const std::vector<float>& data, float sampleRate);
+    Spectrum calculateWelchPSD(SampleView data, float sampleRate, const WelchParams& params);
 
     /**
      * @brief Detect signal activity periods
@@ -56,8 +158,14 @@ public:
      */
     float calculateZeroCrossingRate(const std::vector<float>& data);
 
+    std::string getLastError() const { return lastError; }
+
 private:
-    float median(std::vector<float> data);  // Note: takes copy for sorting
+    std::string lastError;
+    std::vector<float> scratch;  // Selection arena, reused across calls
+
+    static std::vector<float> makeWindow(WindowType type, size_t length);
+    float medianByHistogram(SampleView data, double minVal, double maxVal);
 };
 
 #endif // DATAANALYZER_H
@@ -0,0 +1,115 @@
+#ifndef EDFREADER_H
+#define EDFREADER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ACQMetadata.h"
+
+class MappedFile;
+
+/**
+ * @brief Reads EDF and EDF+ files
+ *
+ * The file is memory-mapped and only the header is parsed on open(); data
+ * records are decoded on request, so signals can be read piecewise without
+ * touching the rest of the file. readFile() loads every ordinary signal as a
+ * channel, converting BLOCK_RECORDS data records at a time from the mapping
+ * into an in-memory float32 buffer. The conversion itself needs no extra
+ * memory, but the loaded channels hold every sample: about twice the size
+ * of the file's 16-bit data.
+ *
+ * EDF+ annotations ("EDF Annotations" signals) are collected by
+ * readAnnotations(); the per-record time-keeping entries are skipped. EDF+D
+ * (discontinuous) files are read as if the records were contiguous.
+ */
+class EdfReader {
+public:
+    // Data records decoded per step by readFile() and readAnnotations()
+    static constexpr size_t BLOCK_RECORDS = 64;
+
+    /**
+     * @brief One signal as described in the header
+     */
+    struct Signal {
+        std::string label;
+        std::string units;
+        double physicalMin;
+        double physicalMax;
+        int digitalMin;
+        int digitalMax;
+        size_t samplesPerRecord;
+        size_t offsetInRecord;   // Bytes from the start of a data record
+        double gain;             // Physical value = digital * gain + offset
+        double offset;
+        bool isAnnotation;
+    };
+
+    /**
+     * @brief EDF+ annotation (times in seconds from the recording start)
+     */
+    struct Annotation {
+        double onset;
+        double duration;
+        std::string text;
+    };
+
+    EdfReader();
+    ~EdfReader();
+
+    /**
+     * @brief True for .edf files (by extension)
+     */
+    static bool isEdfFile(const std::string& path);
+
+    /**
+     * @brief Map a file and parse its header
+     */
+    bool open(const std::string& path);
+    void close();
+
+    bool isEdfPlus() const { return edfPlus; }
+    size_t getNumRecords() const { return numRecords; }
+    double getRecordDuration() const { return recordDuration; }
+    const std::vector<Signal>& getSignals() const { return edfSignals; }
+
+    /**
+     * @brief Decode a run of data records of one signal to physical values
+     * @param out Receives count * samplesPerRecord samples
+     * @return Number of samples written (fewer at the end of the file)
+     */
+    size_t readSamples(size_t signal, size_t firstRecord, size_t count, float* out) const;
+
+    /**
+     * @brief All annotations of all annotation signals, in file order
+     */
+    std::vector<Annotation> readAnnotations() const;
+
+    /**
+     * @brief Open a file and load all ordinary signals as channels
+     *
+     * Annotations are kept and available from getAnnotations() afterwards.
+     * @return File metadata with loaded channels, or nullptr on failure
+     */
+    std::shared_ptr<ACQFileMetadata> readFile(const std::string& path);
+
+    const std::vector<Annotation>& getAnnotations() const { return annotations; }
+    std::string getLastError() const { return lastError; }
+
+private:
+    std::shared_ptr<MappedFile> file;
+    std::vector<Signal> edfSignals;
+    std::vector<Annotation> annotations;
+    size_t headerBytes;
+    size_t recordBytes;
+    size_t numRecords;
+    double recordDuration;
+    bool edfPlus;
+    std::string lastError;
+
+    bool parseHeader();
+    static void parseTals(const char* data, size_t size, std::vector<Annotation>& out);
+};
+
+#endif // EDFREADER_H
@@ -0,0 +1,79 @@
+#ifndef EDFWRITER_H
+#define EDFWRITER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ACQMetadata.h"
+
+/**
+ * @brief Streaming EDF+ (continuous) writer
+ *
+ * Each channel becomes an EDF signal scaled to the full int16 range between
+ * its rounded-out physical min and max. Labels become EDF+ annotations
+ * ("EDF Annotations" signal, one TAL per label placed in the data record
+ * containing its onset).
+ *
+ * The data record duration is derived from the sample rates: the longest
+ * multiple of the shortest duration holding a whole number of samples of
+ * every channel (lcm of the rate denominators over gcd of the numerators,
+ * e.g. 32 ms for 2000 Hz and 31.25 Hz) that stays within 1 s and
+ * MAX_RECORD_BYTES, preferring durations that print exactly in the header.
+ * Records are converted and written one at a
+ * time, so memory stays at one record however long the recording is. The
+ * last record is padded with each channel's final sample.
+ */
+class EdfWriter {
+public:
+    // EDF+ recommends data records of at most 61440 bytes
+    static constexpr size_t MAX_RECORD_BYTES = 61440;
+
+    /**
+     * @brief EDF+ annotation (times in seconds from the recording start)
+     */
+    struct Annotation {
+        double onset;
+        double duration;
+        std::string text;
+    };
+
+    EdfWriter();
+    ~EdfWriter();
+
+    void addChannel(std::shared_ptr<ChannelData> channel);
+    void addChannels(const ACQFileMetadata& file);
+    void addAnnotation(double onset, double duration, const std::string& text);
+
+    /**
+     * @brief EDF+ patient and recording identification fields
+     *
+     * Default to the anonymous "X X X X" and "Startdate X X X X".
+     */
+    void setPatient(const std::string& patient) { patientId = patient; }
+    void setRecording(const std::string& recording) { recordingId = recording; }
+
+    bool writeFile(const std::string& path);
+
+    double getRecordDuration() const { return recordDuration; }
+    const std::string& getLastError() const { return lastError; }
+
+private:
+    struct Signal {
+        std::shared_ptr<ChannelData> channel;
+        size_t samplesPerRecord;
+        double physicalMin;
+        double physicalMax;
+    };
+
+    std::vector<std::shared_ptr<ChannelData>> channels;
+    std::vector<Annotation> annotations;
+    std::string patientId;
+    std::string recordingId;
+    double recordDuration;
+    std::string lastError;
+
+    bool chooseRecordDuration(std::vector<Signal>& edfSignals);
+};
+
+#endif // EDFWRITER_H
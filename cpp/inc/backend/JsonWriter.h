@@ -0,0 +1,78 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "BufferedWriter.h"
+#include "SampleView.h"
+
+/**
+ * @brief Streaming JSON writer
+ *
+ * Emits a document token by token straight into a BufferedWriter, so
+ * nothing but the output buffer is held in memory however large the
+ * document gets. Objects and arrays are indented like nlohmann's dump(2);
+ * sample arrays written with floatArray() stay on one line.
+ *
+ * Floats are written in shortest round-trip form. JSON has no NaN or
+ * infinity, so non-finite values are written as null (as nlohmann does).
+ * The caller is responsible for well-formed nesting.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(BufferedWriter& out, int indent = 2);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /**
+     * @brief Name of the next object member
+     */
+    void key(std::string_view name);
+
+    void value(std::string_view text);
+    void value(const char* text) { value(std::string_view(text)); }
+    void value(float number);
+    void value(double number);
+    void value(bool flag);
+    void null();
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type
+    value(T number) {
+        separate();
+        out.writeInteger(number);
+    }
+
+    /**
+     * @brief Array of samples on a single line
+     */
+    void floatArray(SampleView values);
+
+    /**
+     * @brief key(name) followed by value(v)
+     */
+    template <typename T>
+    void member(std::string_view name, const T& v) {
+        key(name);
+        value(v);
+    }
+
+private:
+    BufferedWriter& out;
+    int indent;
+    std::vector<bool> hasMembers;  // One entry per open object/array
+    bool afterKey;
+
+    void separate();
+    void newline();
+    void close(char bracket);
+    void writeString(std::string_view text);
+    void writeFloat(float number);
+};
+
+#endif // JSONWRITER_H
@@ -0,0 +1,71 @@
+#ifndef REALFFT_H
+#define REALFFT_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Self-contained FFT of real-valued signals
+ *
+ * A size-N real transform is computed as a size-N/2 complex Stockham
+ * transform (no bit-reversal pass) followed by a split step that separates
+ * the even/odd spectra. Twiddle factors are precomputed once per size and
+ * shared through a process-wide plan cache, so constructing a RealFFT is
+ * cheap. Butterflies use SSE on x86 and a scalar path elsewhere.
+ *
+ * Sizes must be powers of two. An instance owns scratch buffers and is not
+ * thread-safe; give each thread its own RealFFT (they share the plan).
+ */
+class RealFFT {
+public:
+    /**
+     * @brief Prepare a transform of the given size
+     * @param size Number of real input samples (power of two, >= 2)
+     */
+    explicit RealFFT(size_t size);
+    ~RealFFT();
+
+    bool isValid() const { return plan != nullptr; }
+    size_t size() const { return n; }
+
+    /**
+     * @brief Number of output bins (size / 2 + 1, DC to Nyquist)
+     */
+    size_t getNumBins() const { return n / 2 + 1; }
+
+    /**
+     * @brief Forward transform
+     * @param input size() real samples
+     * @param output getNumBins() complex bins, interleaved re/im
+     * @return False if the instance is invalid
+     */
+    bool forward(const float* input, float* output);
+
+    /**
+     * @brief Squared magnitude of the forward transform
+     * @param input size() real samples
+     * @param power getNumBins() values |X[k]|^2
+     * @return False if the instance is invalid
+     */
+    bool powerSpectrum(const float* input, float* power);
+
+    static bool isPowerOfTwo(size_t value) { return value != 0 && (value & (value - 1)) == 0; }
+    static size_t nextPowerOfTwo(size_t value);
+
+private:
+    struct Plan;
+
+    size_t n;
+    std::shared_ptr<const Plan> plan;
+
+    // Complex scratch (interleaved), ping-ponged by the Stockham stages
+    std::vector<float> bufferA;
+    std::vector<float> bufferB;
+    std::vector<float> spectrum;
+
+    static std::shared_ptr<const Plan> getCachedPlan(size_t size);
+    const float* transformHalf(const float* input);
+};
+
+#endif // REALFFT_H
@@ -0,0 +1,85 @@
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include "SampleBuffer.h"
+
+/**
+ * @brief One block of STFT columns
+ *
+ * Column c of the whole spectrogram is the Hann-windowed FFT of nfft
+ * samples centred on sample c * hop. A tile holds TILE_COLUMNS consecutive
+ * columns, stored column by column, each numBins values of power in dB
+ * (DC first).
+ */
+struct SpectrogramTile {
+    size_t firstColumn;
+    size_t numColumns;
+    size_t numBins;
+    std::vector<float> powerDb;
+
+    float at(size_t column, size_t bin) const { return powerDb[column * numBins + bin]; }
+};
+
+/**
+ * @brief Incremental STFT spectrogram with an LRU tile cache
+ *
+ * Nothing is computed up front: getTile() transforms only the columns of
+ * the requested tile, so a view only ever pays for the tiles it shows.
+ * Tiles are cached by (buffer version, hop, nfft, tile index); since a
+ * SampleBuffer never changes, a cached tile stays valid for as long as
+ * anyone asks for that version, and filtered versions get their own tiles.
+ *
+ * getTile() may be called from several threads (e.g. async image loads).
+ */
+class Spectrogram {
+public:
+    static constexpr size_t TILE_COLUMNS = 256;
+    static constexpr size_t DEFAULT_CACHE_TILES = 256;
+
+    explicit Spectrogram(size_t maxCachedTiles = DEFAULT_CACHE_TILES);
+    ~Spectrogram();
+
+    /**
+     * @brief Tile tileIndex of the spectrogram of buffer
+     * @param nfft FFT length (power of two, >= 2)
+     * @param hop Samples between columns (>= 1)
+     * @return Null for invalid parameters or a tile past the end
+     */
+    std::shared_ptr<const SpectrogramTile> getTile(const SampleBuffer::Ptr& buffer,
+                                                   size_t nfft,
+                                                   size_t hop,
+                                                   size_t tileIndex);
+
+    /**
+     * @brief Number of columns / tiles covering numSamples samples
+     */
+    static size_t getNumColumns(size_t numSamples, size_t hop);
+    static size_t getNumTiles(size_t numSamples, size_t hop);
+
+    size_t getCachedTileCount() const;
+    void clearCache();
+
+private:
+    using Key = std::tuple<uint64_t, size_t, size_t, size_t>;  // version, hop, nfft, tile
+    using Entry = std::pair<Key, std::shared_ptr<const SpectrogramTile>>;
+
+    mutable std::mutex cacheMutex;
+    std::list<Entry> lru;  // Most recently used first
+    std::map<Key, std::list<Entry>::iterator> index;
+    size_t maxTiles;
+
+    static std::shared_ptr<SpectrogramTile> computeTile(SampleView samples,
+                                                        size_t nfft,
+                                                        size_t hop,
+                                                        size_t tileIndex);
+};
+
+#endif // SPECTROGRAM_H
@@ -5,14 +5,29 @@
 #include <QString>
 #include <QProcess>
 #include <QVariantList>
+#include <QVariantMap>
+#include <QPointer>
+#include <QThreadPool>
 #include <memory>
+#include <vector>
 #include "ChannelData.h"
 #include "ACQMetadata.h"
 #include "ACQDataLoader.h"
+#include "ACQReader.h"
+#include "CsvExporter.h"
+#include "ArrayFileWriter.h"
+#include "ArrayFileReader.h"
+#include "EdfWriter.h"
+#include "EdfReader.h"
+#include "ChannelCacheWriter.h"
+#include "ChannelCacheReader.h"
+
+class FilterController;
 
 /**
  * @brief Main application controller
- * Handles ACQ file loading, Python conversion, and data management
+ * Handles ACQ file loading (native reader with Python conversion fallback)
+ * and data management
  */
 class ApplicationController : public QObject {
     Q_OBJECT
@@ -42,12 +57,43 @@ public:
     void setChannelData(std::shared_ptr<ChannelData> data);
 
     /**
-     * @brief Load ACQ file (automatically converts using Python)
+     * @brief Controller whose filter results commitFilterResult() applies
+     */
+    void setFilterController(FilterController* controller) { m_filterController = controller; }
+
+    // All channels of the loaded recording (current and unfiltered)
+    const std::vector<std::shared_ptr<ChannelData>>& getChannels() const { return m_channels; }
+    const std::vector<std::shared_ptr<ChannelData>>& getOriginalChannels() const { return m_originalChannels; }
+
+    /**
+     * @brief Replace all channels with filtered versions (from C++)
+     *
+     * The first channel becomes the displayed one.
+     */
+    void updateChannels(const std::vector<std::shared_ptr<ChannelData>>& channels);
+
+    /**
+     * @brief Load ACQ file
+     *
+     * Decodes the file in-process with ACQReader on a worker thread; if the
+     * native reader rejects the file, falls back to the Python converter.
+     * Decoded channels are kept in a compressed channel cache, so reopening
+     * an unchanged recording skips decoding and conversion altogether.
      * @param acqFilePath Path to .acq file
      * @return true if loading started successfully
      */
     Q_INVOKABLE bool loadACQFile(const QString& acqFilePath);
 
+    /**
+     * @brief Load an ACQ file, an EDF/EDF+ file or a previous NumPy/raw export
+     *
+     * .npy, .npz and .f32 files are memory-mapped by ArrayFileReader and
+     * .edf files decoded by EdfReader, both on a worker thread; anything else
+     * goes through loadACQFile(). EDF+ annotations are reported through
+     * annotationsLoaded() once the channels are in place.
+     */
+    Q_INVOKABLE bool loadFile(const QString& filePath);
+
     /**
      * @brief Get waveform data for plotting
      * @param maxPoints Maximum points to return (for downsampling)
@@ -60,13 +106,44 @@ public:
      */
     Q_INVOKABLE QVariantList getCurrentWaveformData(int maxPoints = 10000);
 
+    /**
+     * @brief Get the min/max envelope of a sample range for display
+     *
+     * Answered from the channel's min/max pyramid, so the cost depends on
+     * pixelWidth rather than on the range length, and spikes narrower than
+     * a pixel are kept. Each pixel contributes its min and max point.
+     * @param startSample First sample of the range
+     * @param endSample One past the last sample of the range
+     * @param pixelWidth Number of buckets (<= 0 returns every sample)
+     * @return QVariantList of QPointF (x = sample index)
+     */
+    Q_INVOKABLE QVariantList getWaveformRange(qint64 startSample, qint64 endSample, int pixelWidth);
+
+    /**
+     * @brief Get min/max of a sample range (for Y axis autoscale)
+     * @return QVariantMap with "min" and "max", empty if the range is empty
+     */
+    Q_INVOKABLE QVariantMap getWaveformExtent(qint64 startSample, qint64 endSample);
+
     /**
      * @brief Update waveform with filtered data (from C++)
      */
     void updateWaveform(const std::vector<float>& filteredData);
+    void updateWaveform(std::vector<float>&& filteredData);
+
+    /**
+     * @brief Replace the channel's samples with a finished filter job's result
+     *
+     * The samples stay in C++ and are moved into the channel, so QML only
+     * handles the job id from FilterController::filterFinished.
+     * @return False if the result is gone or doesn't match the channel
+     */
+    Q_INVOKABLE bool commitFilterResult(int resultId);
 
     /**
      * @brief Update waveform with filtered data (from QML)
+     *
+     * Unboxes every point; prefer commitFilterResult() for full-length data.
      */
     Q_INVOKABLE void applyFilteredData(const QVariantList& filteredPoints);
 
@@ -77,8 +154,45 @@ public:
 
     /**
      * @brief Export waveform data to CSV file
+     *
+     * Rows are formatted in parallel and written in order (see CsvExporter).
+     * @param allChannels One column per channel instead of the displayed one
+     * @param startTime Start of the exported range in seconds (< 0: start)
+     * @param endTime End of the exported range in seconds (< 0: end)
+     */
+    Q_INVOKABLE bool exportToCSV(const QString& filePath, bool allChannels = false,
+                                 double startTime = -1.0, double endTime = -1.0);
+
+    /**
+     * @brief Export only labelled segments to CSV, with a label column
+     * @param labels Label maps as returned by LabelManager (startIndex,
+     *        endIndex and label; indices of the displayed channel)
+     */
+    Q_INVOKABLE bool exportLabelsToCSV(const QString& filePath, const QVariantList& labels,
+                                       bool allChannels = false);
+
+    /**
+     * @brief Export samples as .npy, .npz or raw .f32 (+ .json), by extension
+     *
+     * Each channel is written from its sample buffer in a single write.
+     * @param allChannels Every channel instead of the displayed one
+     */
+    Q_INVOKABLE bool exportArrays(const QString& filePath, bool allChannels = false);
+
+    /**
+     * @brief Export each labelled segment as its own array (.npz or raw)
+     * @param labels Label maps as returned by LabelManager
      */
-    Q_INVOKABLE bool exportToCSV(const QString& filePath);
+    Q_INVOKABLE bool exportLabelArrays(const QString& filePath, const QVariantList& labels,
+                                       bool allChannels = false);
+
+    /**
+     * @brief Export all channels as EDF+, with labels as annotations
+     *
+     * Streamed one data record at a time (see EdfWriter).
+     * @param labels Label maps as returned by LabelManager
+     */
+    Q_INVOKABLE bool exportToEDF(const QString& filePath, const QVariantList& labels = QVariantList());
 
 signals:
     void currentFileChanged();
@@ -92,6 +206,13 @@ signals:
     void conversionFailed(const QString& error);
     void waveformUpdated();
 
+    /**
+     * @brief Annotations of a loaded EDF+ file
+     * @param labels Maps with startIndex, endIndex (samples of the displayed
+     *        channel) and label
+     */
+    void annotationsLoaded(const QVariantList& labels);
+
 private slots:
     void onPythonProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
     void onPythonProcessError(QProcess::ProcessError error);
@@ -103,16 +224,54 @@ private:
     QString m_statusMessage;
     std::shared_ptr<ChannelData> m_channelData;
     std::shared_ptr<ChannelData> m_originalData;  // Keep original for reset
+    std::vector<std::shared_ptr<ChannelData>> m_channels;
+    std::vector<std::shared_ptr<ChannelData>> m_originalChannels;
 
     QProcess* m_pythonProcess;
     QString m_tempOutputDir;
+    QString m_conversionDir;  // Output of the latest conversion, inside m_tempOutputDir
+    QString m_cacheDir;  // Channel cache files, kept across conversions
     ACQDataLoader m_loader;
+    int m_loadGeneration;  // Discards results of superseded native reads
+    int m_conversionGeneration;  // Load the running converter belongs to
+    QThreadPool m_readPool;  // File reads; drained before the controller goes away
+
+    // Size and mtime of m_currentFile taken before it was read; the channel
+    // cache is stamped with these rather than with a later stat
+    uint64_t m_sourceSize;
+    int64_t m_sourceModified;
+
+    // Recording and stamp the running conversion was started for
+    QString m_conversionFile;
+    uint64_t m_conversionSourceSize;
+    int64_t m_conversionSourceModified;
+
+    QPointer<FilterController> m_filterController;
 
     void setStatusMessage(const QString& message);
+    void addCsvColumns(CsvExporter& exporter, bool allChannels) const;
+    bool writeCsv(CsvExporter& exporter, const QString& filePath);
+    bool writeArrays(ArrayFileWriter& writer, const QString& filePath);
+    void readDataFile(const QString& filePath);
+    int beginLoad();
+    void stopPythonConverter();
     void setIsLoading(bool loading);
-    bool callPythonConverter(const QString& acqFilePath);
+    void readNativeACQ(const QString& acqFilePath);
+    void onNativeReadFinished(int generation,
+                              std::shared_ptr<ACQFileMetadata> fileMetadata,
+                              const QString& error,
+                              const QString& acqFilePath,
+                              bool fromCache);
+    static void buildPyramids(const std::shared_ptr<ACQFileMetadata>& fileMetadata);
+    QString channelCachePath(const QString& acqFilePath) const;
+    void writeChannelCache(const std::vector<std::shared_ptr<ChannelData>>& channels,
+                           const QString& acqFilePath,
+                           uint64_t sourceSize,
+                           int64_t sourceModified);
+    bool callPythonConverter(const QString& acqFilePath, int generation);
     bool loadConvertedData();
-    QVariantList vectorToVariantList(const std::vector<float>& data, int maxPoints);
+    bool loadFileMetadata(std::shared_ptr<ACQFileMetadata> fileMetadata);
+    static QVariantList bucketsToVariantList(const std::vector<WaveformBucket>& buckets);
 };
 
 #endif // APPLICATIONCONTROLLER_H
@@ -41,7 +41,7 @@ private:
     int m_dataSize;
     std::shared_ptr<ChannelData> m_channelData;
 
-    QVariantList downsampleData(const std::vector<float>& data, int targetPoints);
+    QVariantList downsampleData(const ChannelData& channel, int targetPoints);
 };
 
 #endif // CHARTCONTROLLER_H
@@ -4,7 +4,11 @@
 #include <QObject>
 #include <QString>
 #include <QVariantList>
+#include <QThreadPool>
+#include <QTimer>
 #include <memory>
+#include <vector>
+#include <atomic>
 #include "DSPFilters.h"
 #include "ChannelData.h"
 
@@ -18,6 +22,7 @@ class FilterController : public QObject {
 
     Q_PROPERTY(bool hasData READ hasData NOTIFY hasDataChanged)
     Q_PROPERTY(QString lastError READ lastError NOTIFY lastErrorChanged)
+    Q_PROPERTY(bool isFiltering READ isFiltering NOTIFY isFilteringChanged)
 
 public:
     explicit FilterController(QObject *parent = nullptr);
@@ -26,6 +31,7 @@ public:
     // Property getters
     bool hasData() const { return m_channelData != nullptr; }
     QString lastError() const { return m_lastError; }
+    bool isFiltering() const { return m_isFiltering; }
 
     /**
      * @brief Set the channel data to filter
@@ -37,54 +43,181 @@ public:
      */
     std::shared_ptr<ChannelData> getChannelData() const { return m_channelData; }
 
+    /**
+     * @brief Set all channels of the recording (for whole-file filtering)
+     */
+    void setChannels(const std::vector<std::shared_ptr<ChannelData>>& channels);
+
+    /**
+     * @brief Channels produced by the last startFilterAllChannels() job
+     */
+    const std::vector<std::shared_ptr<ChannelData>>& getFilteredChannels() const { return m_filteredChannels; }
+
     // Invokable filter methods (callable from QML)
 
     /**
      * @brief Apply lowpass filter
      * @param cutoffFreq Cutoff frequency in Hz
-     * @param order Filter order (1-8)
+     * @param order Filter order (1-10)
+     * @param zeroPhase Filter forward and backward (no phase shift)
      * @return Filtered data as QVariantList of QPointF
      */
-    Q_INVOKABLE QVariantList applyLowpass(float cutoffFreq, int order = 4);
+    Q_INVOKABLE QVariantList applyLowpass(float cutoffFreq, int order = 4, bool zeroPhase = false);
 
     /**
      * @brief Apply highpass filter
      * @param cutoffFreq Cutoff frequency in Hz
-     * @param order Filter order (1-8)
+     * @param order Filter order (1-10)
+     * @param zeroPhase Filter forward and backward (no phase shift)
      * @return Filtered data as QVariantList of QPointF
      */
-    Q_INVOKABLE QVariantList applyHighpass(float cutoffFreq, int order = 4);
+    Q_INVOKABLE QVariantList applyHighpass(float cutoffFreq, int order = 4, bool zeroPhase = false);
 
     /**
      * @brief Apply bandpass filter
      * @param lowCutoff Low cutoff frequency in Hz
      * @param highCutoff High cutoff frequency in Hz
-     * @param order Filter order (1-8)
+     * @param order Filter order (1-10)
+     * @param zeroPhase Filter forward and backward (no phase shift)
      * @return Filtered data as QVariantList of QPointF
      */
-    Q_INVOKABLE QVariantList applyBandpass(float lowCutoff, float highCutoff, int order = 4);
+    Q_INVOKABLE QVariantList applyBandpass(float lowCutoff, float highCutoff, int order = 4,
+                                          bool zeroPhase = false);
 
     /**
      * @brief Apply notch filter
      * @param lowCutoff Low cutoff frequency in Hz
      * @param highCutoff High cutoff frequency in Hz
-     * @param order Filter order (1-8)
+     * @param order Filter order (1-10)
+     * @param zeroPhase Filter forward and backward (no phase shift)
      * @return Filtered data as QVariantList of QPointF
      */
-    Q_INVOKABLE QVariantList applyNotch(float lowCutoff, float highCutoff, int order = 4);
+    Q_INVOKABLE QVariantList applyNotch(float lowCutoff, float highCutoff, int order = 4,
+                                       bool zeroPhase = false);
+
+    /**
+     * @brief Apply narrow powerline notch filter
+     * @param frequency Frequency to reject in Hz (typically 50 or 60)
+     * @param q Quality factor; -3 dB bandwidth is frequency / q
+     * @param zeroPhase Filter forward and backward (no phase shift)
+     * @return Filtered data as QVariantList of QPointF
+     */
+    Q_INVOKABLE QVariantList applyPowerlineNotch(float frequency, float q = 30.0f, bool zeroPhase = false);
 
     /**
      * @brief Apply generic filter
-     * @param filterType "lowpass", "highpass", "bandpass", or "notch"
+     * @param filterType "lowpass", "highpass", "bandpass", "notch" or "powerline"
      * @param freq1 First frequency parameter
-     * @param freq2 Second frequency parameter (for bandpass/notch)
+     * @param freq2 Second frequency parameter (for bandpass/notch), or Q (powerline)
      * @param order Filter order
+     * @param zeroPhase Filter forward and backward (filtfilt), so filtered
+     *        features stay aligned with the raw trace and its labels
      * @return Filtered data as QVariantList of QPointF
      */
     Q_INVOKABLE QVariantList applyFilter(const QString& filterType,
                                          float freq1,
                                          float freq2 = 0.0f,
-                                         int order = 4);
+                                         int order = 4,
+                                         bool zeroPhase = false);
+
+    /**
+     * @brief Filter every channel of the recording on a worker thread
+     *
+     * Channels sharing a sample rate and length are filtered together, one
+     * per SIMD lane. Runs as a job like startFilter(): it supersedes any
+     * running job, stops between channel groups once superseded, and
+     * reports filterProgress. Results are available from
+     * getFilteredChannels() once allChannelsFiltered is emitted.
+     * @param filterType "lowpass", "highpass", "bandpass", "notch" or "powerline"
+     * @return Job id, or -1 if the parameters are invalid
+     */
+    Q_INVOKABLE int startFilterAllChannels(const QString& filterType,
+                                           float freq1,
+                                           float freq2 = 0.0f,
+                                           int order = 4);
+
+    /**
+     * @brief Filter the channel on a worker thread
+     *
+     * Supersedes any job still running: that job stops at its next progress
+     * check and its result is dropped, so a new parameter value never waits
+     * behind a stale one. Progress and completion arrive as filterProgress
+     * and filterFinished with the returned job id.
+     * @param filterType "lowpass", "highpass", "bandpass", "notch" or "powerline"
+     * @return Job id, or -1 if the parameters are invalid
+     */
+    Q_INVOKABLE int startFilter(const QString& filterType,
+                                float freq1,
+                                float freq2 = 0.0f,
+                                int order = 4,
+                                bool zeroPhase = false);
+
+    /**
+     * @brief Cancel the running filter job, if any
+     */
+    Q_INVOKABLE void cancelFilter();
+
+    /**
+     * @brief Filtered samples of a finished job
+     * @return Null unless jobId is the most recent finished job
+     */
+    SampleBuffer::Ptr getResult(int jobId) const;
+
+    /**
+     * @brief Hand over a finished job's samples and forget them
+     *
+     * Used by ApplicationController::commitFilterResult(), which installs
+     * the buffer in the channel as is.
+     * @return Null unless jobId is the most recent finished job
+     */
+    SampleBuffer::Ptr takeResult(int jobId);
+
+    /**
+     * @brief Filtered samples of a finished job for QML display
+     *
+     * To apply the result, pass the job id to
+     * ApplicationController::commitFilterResult() instead.
+     * @param maxPoints Maximum number of points (0 = all samples)
+     * @return QVariantList of QPointF, empty if the result is gone
+     */
+    Q_INVOKABLE QVariantList getResultData(int jobId, int maxPoints = 0);
+
+    /**
+     * @brief Set the sample range shown in the waveform view
+     *
+     * While a preview is shown, a changed range re-runs it with the last
+     * updatePreview() parameters once the view has been still for
+     * PREVIEW_DEBOUNCE_MS, so panning and zooming don't filter every frame.
+     * @param startSample First visible sample
+     * @param endSample One past the last visible sample
+     * @param pixelWidth Width of the plot in pixels (preview resolution)
+     */
+    Q_INVOKABLE void setPreviewRange(qint64 startSample, qint64 endSample, int pixelWidth);
+
+    /**
+     * @brief Filter only the visible range and emit it as previewUpdated
+     *
+     * Uses DSPFilters::applyFilterRange(), so the cost follows the visible
+     * range plus the filter's warm-up rather than the recording length.
+     * Views wider than MAX_PREVIEW_SAMPLES are not previewed, and the
+     * warm-up is capped at MAX_PREVIEW_WARMUP, which keeps a preview within
+     * about 16 ms even for very low cut-offs.
+     * @return True if a preview was emitted
+     */
+    Q_INVOKABLE bool updatePreview(const QString& filterType,
+                                   float freq1,
+                                   float freq2 = 0.0f,
+                                   int order = 4,
+                                   bool zeroPhase = false);
+
+    /**
+     * @brief Remove the preview trace and stop following the visible range
+     */
+    Q_INVOKABLE void clearPreview();
+
+    static constexpr qint64 MAX_PREVIEW_SAMPLES = 1 << 19;
+    static constexpr size_t MAX_PREVIEW_WARMUP = 1 << 16;
+    static constexpr int PREVIEW_DEBOUNCE_MS = 20;
 
     /**
      * @brief Get original (unfiltered) data
@@ -118,15 +251,64 @@ signals:
     void hasDataChanged();
     void lastErrorChanged();
     void filterApplied(const QString& filterType);
+    void allChannelsFiltered(const QString& filterType);
     void filterError(const QString& error);
+    void isFilteringChanged();
+    void filterProgress(int jobId, int percent);
+    void filterFinished(int jobId, const QString& filterType);
+    void filterCancelled(int jobId);
+    void previewUpdated(const QVariantList& points);
+    void previewCleared();
 
 private:
     std::shared_ptr<ChannelData> m_channelData;
+    std::vector<std::shared_ptr<ChannelData>> m_channels;
+    std::vector<std::shared_ptr<ChannelData>> m_filteredChannels;
     DSPFilters m_dspFilters;
     QString m_lastError;
 
+    // Async jobs: workers keep running only while their id is current.
+    // They run on their own pool so shutdown waits for them and nothing else
+    QThreadPool m_jobPool;
+    std::shared_ptr<std::atomic<int>> m_currentJob;
+    int m_nextJobId;
+    bool m_isFiltering;
+    int m_resultJobId;
+    SampleBuffer::Ptr m_result;
+
+    // Visible range for previews
+    qint64 m_previewStart;
+    qint64 m_previewEnd;
+    int m_previewWidth;
+
+    // Parameters of the shown preview, re-run when the range changes
+    QTimer m_previewTimer;
+    bool m_previewActive;
+    QString m_previewType;
+    float m_previewFreq1;
+    float m_previewFreq2;
+    int m_previewOrder;
+    bool m_previewZeroPhase;
+
+    void setIsFiltering(bool filtering);
+    bool refreshPreview();
+    void onFilterJobFinished(int jobId,
+                             bool success,
+                             const QString& error,
+                             SampleBuffer::Ptr result,
+                             const QString& filterType);
+    void onAllChannelsJobFinished(int jobId,
+                                  bool success,
+                                  const QString& error,
+                                  const std::vector<std::shared_ptr<ChannelData>>& filtered,
+                                  const QString& filterType);
+
     // Helper to convert vector<float> to QVariantList of QPointF
-    QVariantList vectorToVariantList(const std::vector<float>& data, int maxPoints = 0);
+    QVariantList vectorToVariantList(SampleView data, int maxPoints = 0);
+    static QVariantList bucketsToVariantList(const std::vector<WaveformBucket>& buckets);
+
+    // Map a filter type string to DSPFilters::FilterType
+    static bool parseFilterType(const QString& filterType, DSPFilters::FilterType& type);
 
     // Helper to set error message
     void setError(const QString& error);
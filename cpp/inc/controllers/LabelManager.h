@@ -8,6 +8,8 @@
 #include <vector>
 #include <memory>
 #include "SegmentLabel.h"
+#include "LabelIntervalIndex.h"
+#include "SampleBuffer.h"
 
 /**
  * @brief Manages segment labels for waveform annotation
@@ -40,9 +42,13 @@ public:
     void setSampleRate(float sampleRate) { m_sampleRate = sampleRate; }
 
     /**
-     * @brief Set voltage data for extracting segment voltages
+     * @brief Set the channel buffer labels refer to
+     *
+     * Shares the channel's buffer and rebinds existing labels to it, so
+     * statistics and exported samples follow the displayed (possibly
+     * filtered) data.
      */
-    void setVoltageData(const std::vector<float>& data) { m_voltageData = data; }
+    void setVoltageData(SampleBuffer::Ptr data);
 
     /**
      * @brief Remove label by ID
@@ -61,9 +67,20 @@ public:
 
     /**
      * @brief Get label at specific index
+     *
+     * O(log n) via the interval index; with overlapping labels the
+     * earliest-created one wins.
      */
     Q_INVOKABLE QVariantMap getLabelAt(int sampleIndex);
 
+    /**
+     * @brief Labels overlapping [startIndex, endIndex], ordered by start
+     *
+     * Used by the waveform view to create overlays for the visible range
+     * only.
+     */
+    Q_INVOKABLE QVariantList getLabelsInRange(qint64 startIndex, qint64 endIndex);
+
     /**
      * @brief Get all labels as QVariantList for QML
      */
@@ -71,8 +88,14 @@ public:
 
     /**
      * @brief Save labels to JSON file
+     *
+     * Streams one label at a time into a buffered file, so memory use does
+     * not grow with the number of labelled samples.
+     * @param binarySidecar Write voltages to a packed float32 file next to
+     *        the JSON ("x.json" -> "x.f32") instead of inline arrays; each
+     *        label then records voltage_offset (bytes) and voltage_count
      */
-    Q_INVOKABLE bool saveToFile(const QString& filePath);
+    Q_INVOKABLE bool saveToFile(const QString& filePath, bool binarySidecar = false);
 
     /**
      * @brief Load labels from JSON file
@@ -92,9 +115,21 @@ signals:
 private:
     std::vector<std::shared_ptr<SegmentLabel>> m_labels;
     float m_sampleRate;
-    std::vector<float> m_voltageData;
+    SampleBuffer::Ptr m_voltageData;
+
+    // Rebuilt lazily on the first query after any change to m_labels
+    mutable LabelIntervalIndex m_index;
+    mutable bool m_indexDirty;
+
+    const LabelIntervalIndex& labelIndex() const;
+    static QVariantMap labelToVariant(const SegmentLabel& label);
 
     std::shared_ptr<SegmentLabel> findLabelById(int id);
+
+    /**
+     * @brief Min/max/mean/std/RMS of a label's segment
+     */
+    bool segmentStatistics(const SegmentLabel& label, RangeStats& stats) const;
 };
 
 #endif // LABELMANAGER_H
@@ -0,0 +1,97 @@
+#ifndef SPECTROGRAMCONTROLLER_H
+#define SPECTROGRAMCONTROLLER_H
+
+#include <QObject>
+#include <QString>
+#include <QVariantList>
+#include <QImage>
+#include <memory>
+#include <mutex>
+#include "ChannelData.h"
+#include "Spectrogram.h"
+
+/**
+ * @brief Spectrogram of the current channel for the waveform view
+ *
+ * QML asks getVisibleTiles() for the tiles covering the visible sample
+ * range and shows each one as an Image whose source points at the
+ * "spectrogram" image provider (SpectrogramImageProvider). The provider
+ * calls renderTile() on a loader thread, so tiles are computed only when
+ * they scroll into view and never block the GUI.
+ *
+ * Tile URLs carry the buffer version, FFT size, hop, dB range and tile
+ * index, so any change produces new URLs and Qt's image cache never
+ * serves a stale tile.
+ */
+class SpectrogramController : public QObject {
+    Q_OBJECT
+
+    Q_PROPERTY(bool hasData READ hasData NOTIFY spectrogramChanged)
+    Q_PROPERTY(int fftSize READ fftSize WRITE setFftSize NOTIFY spectrogramChanged)
+    Q_PROPERTY(double minDb READ minDb WRITE setMinDb NOTIFY spectrogramChanged)
+    Q_PROPERTY(double maxDb READ maxDb WRITE setMaxDb NOTIFY spectrogramChanged)
+    Q_PROPERTY(double maxFrequency READ maxFrequency NOTIFY spectrogramChanged)
+
+public:
+    static constexpr int DEFAULT_FFT_SIZE = 256;
+    static constexpr int MIN_FFT_SIZE = 16;
+    static constexpr int MAX_FFT_SIZE = 8192;
+
+    explicit SpectrogramController(QObject *parent = nullptr);
+    ~SpectrogramController();
+
+    bool hasData() const;
+    int fftSize() const { return m_fftSize; }
+    double minDb() const { return m_minDb; }
+    double maxDb() const { return m_maxDb; }
+    double maxFrequency() const;
+
+    /**
+     * @brief FFT length, rounded up to a power of two in [MIN, MAX]_FFT_SIZE
+     */
+    void setFftSize(int size);
+    void setMinDb(double value);
+    void setMaxDb(double value);
+
+    /**
+     * @brief Show the spectrogram of this channel (shares its sample buffer)
+     */
+    void setChannelData(std::shared_ptr<ChannelData> channel);
+
+    /**
+     * @brief Tiles covering the visible range at the current zoom
+     *
+     * The hop is the power of two nearest to one column per pixel, so
+     * small zoom steps reuse the cached tiles.
+     * @param startSample First visible sample
+     * @param endSample One past the last visible sample
+     * @param pixelWidth Width of the plot area in pixels
+     * @return List of {source, startSample, endSample} maps
+     */
+    Q_INVOKABLE QVariantList getVisibleTiles(qint64 startSample, qint64 endSample, int pixelWidth);
+
+    /**
+     * @brief Colour image of one tile (called from image loader threads)
+     * @param id "<version>/<nfft>/<hop>/<minDb>/<maxDb>/<tile>" as built by getVisibleTiles()
+     * @return Null image if the id is malformed or refers to a replaced buffer
+     */
+    QImage renderTile(const QString& id);
+
+signals:
+    void spectrogramChanged();
+
+private:
+    mutable std::mutex m_mutex;  // Guards m_buffer/m_sampleRate against loader threads
+    SampleBuffer::Ptr m_buffer;
+    float m_sampleRate;
+
+    int m_fftSize;
+    double m_minDb;
+    double m_maxDb;
+
+    Spectrogram m_spectrogram;
+
+    static QRgb colorMap(double position);
+};
+
+#endif // SPECTROGRAMCONTROLLER_H
@@ -0,0 +1,24 @@
+#ifndef SPECTROGRAMIMAGEPROVIDER_H
+#define SPECTROGRAMIMAGEPROVIDER_H
+
+#include <QQuickImageProvider>
+#include "SpectrogramController.h"
+
+/**
+ * @brief Serves spectrogram tiles to QML as image://spectrogram/<id>
+ *
+ * Loads are forced asynchronous, so tiles are computed on Qt's image
+ * loader threads. The engine owns the provider; the controller must
+ * outlive the engine.
+ */
+class SpectrogramImageProvider : public QQuickImageProvider {
+public:
+    explicit SpectrogramImageProvider(SpectrogramController* controller);
+
+    QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
+
+private:
+    SpectrogramController* m_controller;
+};
+
+#endif // SPECTROGRAMIMAGEPROVIDER_H
@@ -0,0 +1,82 @@
+#ifndef WAVEFORMITEM_H
+#define WAVEFORMITEM_H
+
+#include <QQuickItem>
+#include <QColor>
+#include <QPointer>
+#include <memory>
+#include "ChannelData.h"
+#include "ApplicationController.h"
+
+/**
+ * @brief Scene-graph waveform renderer for QML
+ *
+ * Draws the current channel of an ApplicationController as a single line
+ * strip built on the render thread. Samples are read straight from the
+ * channel's SampleBuffer: when the visible range has more samples than pixels, the
+ * strip alternates the min and max of each pixel column from the buffer's
+ * WaveformPyramid, otherwise it connects the raw samples. Vertex count is
+ * therefore bounded by the item width, independent of channel length.
+ *
+ * The item only draws the trace; axes, grid and hit-testing stay with the
+ * surrounding ChartView, which drives startSample/endSample and
+ * minValue/maxValue from its axes.
+ */
+class WaveformItem : public QQuickItem {
+    Q_OBJECT
+
+    Q_PROPERTY(ApplicationController* controller READ controller WRITE setController NOTIFY controllerChanged)
+    Q_PROPERTY(qreal startSample READ startSample WRITE setStartSample NOTIFY startSampleChanged)
+    Q_PROPERTY(qreal endSample READ endSample WRITE setEndSample NOTIFY endSampleChanged)
+    Q_PROPERTY(qreal minValue READ minValue WRITE setMinValue NOTIFY minValueChanged)
+    Q_PROPERTY(qreal maxValue READ maxValue WRITE setMaxValue NOTIFY maxValueChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+
+public:
+    explicit WaveformItem(QQuickItem *parent = nullptr);
+    ~WaveformItem();
+
+    // Property getters
+    ApplicationController* controller() const { return m_controller; }
+    qreal startSample() const { return m_startSample; }
+    qreal endSample() const { return m_endSample; }
+    qreal minValue() const { return m_minValue; }
+    qreal maxValue() const { return m_maxValue; }
+    QColor color() const { return m_color; }
+
+    // Property setters
+    void setController(ApplicationController* controller);
+    void setStartSample(qreal sample);
+    void setEndSample(qreal sample);
+    void setMinValue(qreal value);
+    void setMaxValue(qreal value);
+    void setColor(const QColor& color);
+
+signals:
+    void controllerChanged();
+    void startSampleChanged();
+    void endSampleChanged();
+    void minValueChanged();
+    void maxValueChanged();
+    void colorChanged();
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+    void geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+
+private slots:
+    void onWaveformUpdated();
+
+private:
+    QPointer<ApplicationController> m_controller;
+    SampleBuffer::Ptr m_buffer;  // Pinned while drawn
+
+    qreal m_startSample;
+    qreal m_endSample;
+    qreal m_minValue;
+    qreal m_maxValue;
+    QColor m_color;
+    bool m_colorChanged;
+};
+
+#endif // WAVEFORMITEM_H
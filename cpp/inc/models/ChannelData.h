@@ -3,9 +3,16 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include "SampleView.h"
+#include "SampleBuffer.h"
 
 /**
  * @brief Represents a single channel's data from an ACQ file
+ *
+ * Samples live in a shared, immutable SampleBuffer, either owned or a
+ * read-only mapping of the converted .bin file. Copies of a ChannelData
+ * share the same buffer until one of them is given new samples.
  */
 class ChannelData {
 public:
@@ -21,7 +28,30 @@ public:
     float getDuration() const { return duration; }
     std::string getBinaryFile() const { return binaryFile; }
 
-    const std::vector<float>& getData() const { return data; }
+    SampleView getData() const { return buffer ? buffer->view() : SampleView(); }
+    bool isMapped() const { return buffer && buffer->isMapped(); }
+
+    /**
+     * @brief Shared sample buffer (null until data is loaded)
+     */
+    SampleBuffer::Ptr getBuffer() const { return buffer; }
+
+    /**
+     * @brief Min/max pyramid for display, built once per sample buffer
+     */
+    const WaveformPyramid& getPyramid() const;
+
+    /**
+     * @brief ADC scaling the samples were decoded with, if known
+     *
+     * ACQReader sets it for 16-bit channels, whose samples are then exactly
+     * raw * scale + offset in float, so the channel cache can store the raw
+     * codes losslessly. Giving the channel new samples clears it.
+     */
+    bool hasAdcScale() const { return adcScaled; }
+    float getAdcScale() const { return adcScale; }
+    float getAdcOffset() const { return adcOffset; }
+    void setAdcScale(float scale, float offset);
 
     // Statistics
     float getMin() const { return min; }
@@ -39,9 +69,11 @@ public:
     void setBinaryFile(const std::string& file) { binaryFile = file; }
     void setStatistics(float minVal, float maxVal, float meanVal, float stdVal);
 
-    // Data loading
+    // Data loading (maps the file read-only, falls back to reading it)
     bool loadBinaryData(const std::string& filepath);
     void setData(const std::vector<float>& newData);
+    void setData(std::vector<float>&& newData);
+    void setBuffer(SampleBuffer::Ptr newBuffer);
 
 private:
     int index;
@@ -52,7 +84,13 @@ private:
     float duration;
     std::string binaryFile;
 
-    std::vector<float> data;
+    SampleBuffer::Ptr buffer;  // Shared between copies
+
+    bool adcScaled;
+    float adcScale;
+    float adcOffset;
+
+    bool readBinaryData(const std::string& filepath);
 
     // Statistics
     float min;
@@ -0,0 +1,64 @@
+#ifndef LABELINTERVALINDEX_H
+#define LABELINTERVALINDEX_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "SegmentLabel.h"
+
+/**
+ * @brief Static augmented interval tree over segment labels
+ *
+ * Labels are sorted by start index and viewed as an implicit balanced
+ * binary tree (the middle of each range is the node), with every node
+ * storing the largest end index in its subtree. Point and range queries
+ * then skip any subtree that ends before the query or starts after it:
+ * O(log n + k) for k hits.
+ *
+ * Ranges are inclusive on both ends, like SegmentLabel::contains() and
+ * SegmentLabel::overlaps(). The index holds no ordering of its own beyond
+ * the snapshot given to build(); rebuild it after labels change.
+ */
+class LabelIntervalIndex {
+public:
+    LabelIntervalIndex();
+
+    /**
+     * @brief Index a snapshot of labels (O(n log n))
+     */
+    void build(const std::vector<std::shared_ptr<SegmentLabel>>& labels);
+
+    void clear();
+
+    size_t size() const { return nodes.size(); }
+    bool empty() const { return nodes.empty(); }
+
+    /**
+     * @brief Earliest-created label containing index
+     *
+     * Matches the first hit of a linear scan over labels in creation order.
+     * @return Null if no label contains index
+     */
+    std::shared_ptr<SegmentLabel> findAt(size_t index) const;
+
+    /**
+     * @brief All labels overlapping [start, end], ordered by start index
+     */
+    std::vector<std::shared_ptr<SegmentLabel>> findOverlapping(size_t start, size_t end) const;
+
+private:
+    struct Node {
+        size_t start;
+        size_t end;
+        size_t maxEnd;  // Largest end in this node's subtree
+        std::shared_ptr<SegmentLabel> label;
+    };
+
+    std::vector<Node> nodes;
+
+    size_t buildMaxEnd(size_t lo, size_t hi);
+    void collect(size_t lo, size_t hi, size_t start, size_t end,
+                 std::vector<std::shared_ptr<SegmentLabel>>& hits) const;
+};
+
+#endif // LABELINTERVALINDEX_H
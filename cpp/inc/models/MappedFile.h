@@ -0,0 +1,50 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Pages are faulted in on demand by the OS and can be dropped under memory
+ * pressure without swapping, since they are backed by the file itself.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file read-only
+     * @param filepath Path to the file
+     * @return True if successful
+     */
+    bool open(const std::string& filepath);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close();
+
+    bool isOpen() const { return mappedData != nullptr; }
+    const char* data() const { return static_cast<const char*>(mappedData); }
+    size_t size() const { return mappedSize; }
+
+    std::string getLastError() const { return lastError; }
+
+private:
+    void* mappedData;
+    size_t mappedSize;
+    std::string lastError;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,89 @@
+#ifndef RANGEINDEX_H
+#define RANGEINDEX_H
+
+#include <cstddef>
+#include <vector>
+#include "SampleView.h"
+#include "WaveformPyramid.h"
+
+/**
+ * @brief Statistics of one sample range
+ */
+struct RangeStats {
+    size_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double std = 0.0;  // Population standard deviation
+    double rms = 0.0;
+};
+
+/**
+ * @brief Range-query index for mean/std/RMS/min/max of any sample range
+ *
+ * Stores the mean and sum of squared deviations (M2) of every
+ * BLOCK_SIZE-sample block, and of every pair, quad, ... of blocks above
+ * it, computed two-pass and merged with Chan et al.'s formula like
+ * DataAnalyzer::computeMoments(). No sum of squares is ever subtracted
+ * from another, so the variance stays accurate on signals with a large
+ * offset or a tiny spread. A query merges O(log n) tree nodes with the
+ * (two-pass) moments of at most 2 * BLOCK_SIZE boundary samples; ranges
+ * shorter than SCAN_BLOCKS blocks are scanned directly, two-pass. Min/max
+ * come from the WaveformPyramid (O(log n)). The tree takes two doubles
+ * per block per level, about 1/8 of a float per sample.
+ *
+ * Like the pyramid, the index keeps a view of the samples and a pointer to
+ * the pyramid; the owner (SampleBuffer) keeps all three alive together.
+ */
+class RangeIndex {
+public:
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr size_t SCAN_BLOCKS = 4;
+
+    RangeIndex();
+
+    /**
+     * @brief (Re)build the block tree over data
+     * @param pyramid Min/max pyramid over the same samples
+     */
+    void build(SampleView data, const WaveformPyramid* pyramid);
+
+    void clear();
+
+    size_t size() const { return data.size(); }
+    bool empty() const { return data.empty(); }
+
+    /**
+     * @brief Statistics of samples [start, end)
+     * @return False if the range is empty after clamping
+     */
+    bool getStats(size_t start, size_t end, RangeStats& stats) const;
+
+private:
+    /**
+     * @brief Count, mean and sum of squared deviations of some samples
+     */
+    struct Moments {
+        double count = 0.0;
+        double mean = 0.0;
+        double m2 = 0.0;
+
+        void merge(double otherCount, double otherMean, double otherM2);
+    };
+
+    struct Node {
+        double mean;
+        double m2;
+    };
+
+    SampleView data;
+    const WaveformPyramid* pyramid;
+
+    // levels[l][i] covers samples [i, i + 1) * (BLOCK_SIZE << l); only
+    // whole nodes are stored
+    std::vector<std::vector<Node>> levels;
+
+    Moments scan(size_t start, size_t end) const;
+};
+
+#endif // RANGEINDEX_H
@@ -0,0 +1,88 @@
+#ifndef SAMPLEBUFFER_H
+#define SAMPLEBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "SampleView.h"
+#include "WaveformPyramid.h"
+#include "RangeIndex.h"
+
+class MappedFile;
+
+/**
+ * @brief Immutable, reference-counted block of channel samples
+ *
+ * Every holder of a recording (ApplicationController's current and original
+ * channel, FilterController, ChartController, LabelManager) keeps a
+ * SampleBuffer::Ptr to the same buffer instead of its own copy, so a
+ * recording occupies memory once, plus one buffer per distinct filtered
+ * version.
+ *
+ * The samples never change after construction; new data (a filter result,
+ * a reload) always goes into a new buffer.
+ */
+class SampleBuffer {
+public:
+    using Ptr = std::shared_ptr<const SampleBuffer>;
+
+    /**
+     * @brief Wrap an owned vector without copying it
+     */
+    static Ptr create(std::vector<float>&& samples);
+
+    /**
+     * @brief Wrap count floats of a read-only file mapping
+     */
+    static Ptr create(std::shared_ptr<const MappedFile> mapping, size_t count);
+
+    /**
+     * @brief Wrap count floats starting byteOffset bytes into a mapping
+     *
+     * byteOffset must be a multiple of sizeof(float) (returns null
+     * otherwise); count is clamped to the end of the mapping.
+     */
+    static Ptr create(std::shared_ptr<const MappedFile> mapping, size_t byteOffset, size_t count);
+
+    SampleBuffer(const SampleBuffer&) = delete;
+    SampleBuffer& operator=(const SampleBuffer&) = delete;
+
+    SampleView view() const { return samples; }
+    const float* data() const { return samples.data(); }
+    size_t size() const { return samples.size(); }
+    bool empty() const { return samples.empty(); }
+    bool isMapped() const { return mapping != nullptr; }
+
+    /**
+     * @brief Process-wide unique id, so caches can tell versions apart
+     */
+    uint64_t getVersion() const { return version; }
+
+    /**
+     * @brief Min/max pyramid, built on first use (thread-safe)
+     */
+    const WaveformPyramid& getPyramid() const;
+
+    /**
+     * @brief Range statistics index, built on first use (thread-safe)
+     */
+    const RangeIndex& getRangeIndex() const;
+
+private:
+    SampleBuffer();
+
+    std::vector<float> owned;
+    std::shared_ptr<const MappedFile> mapping;
+    SampleView samples;
+    uint64_t version;
+
+    mutable std::once_flag pyramidOnce;
+    mutable WaveformPyramid pyramid;
+
+    mutable std::once_flag rangeIndexOnce;
+    mutable RangeIndex rangeIndex;
+};
+
+#endif // SAMPLEBUFFER_H
@@ -0,0 +1,50 @@
+#ifndef SAMPLEVIEW_H
+#define SAMPLEVIEW_H
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief Read-only, non-owning view over contiguous float samples
+ *
+ * A minimal span type. The object handing out the view (ChannelData, a
+ * std::vector, a file mapping) must outlive it.
+ */
+class SampleView {
+public:
+    SampleView() : ptr(nullptr), count(0) {}
+    SampleView(const float* data, size_t size) : ptr(data), count(size) {}
+    SampleView(const std::vector<float>& data) : ptr(data.data()), count(data.size()) {}
+
+    const float* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const float& operator[](size_t i) const { return ptr[i]; }
+    const float& front() const { return ptr[0]; }
+    const float& back() const { return ptr[count - 1]; }
+
+    const float* begin() const { return ptr; }
+    const float* end() const { return ptr + count; }
+
+    /**
+     * @brief View of [offset, offset + length), clamped to this view
+     */
+    SampleView subview(size_t offset, size_t length) const {
+        offset = std::min(offset, count);
+        length = std::min(length, count - offset);
+        return SampleView(ptr + offset, length);
+    }
+
+    /**
+     * @brief Copy the viewed samples into a new vector
+     */
+    std::vector<float> toVector() const { return std::vector<float>(begin(), end()); }
+
+private:
+    const float* ptr;
+    size_t count;
+};
+
+#endif // SAMPLEVIEW_H
@@ -1,11 +1,18 @@
 #ifndef SEGMENTLABEL_H
 #define SEGMENTLABEL_H
 
+#include <cstdint>
 #include <string>
-#include <vector>
+#include "SampleBuffer.h"
 
 /**
  * @brief Represents a labeled segment in the waveform
+ *
+ * A label stores no samples of its own: it references [startIndex, endIndex)
+ * of a shared channel buffer, so a label costs the same regardless of its
+ * length. LabelManager rebinds every label to the new buffer when the
+ * channel changes (e.g. a filter is applied), and getSamples() always
+ * reflects the label's current indices.
  */
 class SegmentLabel {
 public:
@@ -21,7 +28,24 @@ public:
     int getId() const { return id; }
     float getStartTime() const { return startTime; }
     float getEndTime() const { return endTime; }
-    const std::vector<float>& getVoltageData() const { return voltageData; }
+
+    /**
+     * @brief Buffer the indices refer to (null if none)
+     */
+    const SampleBuffer::Ptr& getSource() const { return source; }
+
+    /**
+     * @brief Version of the referenced buffer, 0 if none
+     */
+    uint64_t getSourceVersion() const { return source ? source->getVersion() : 0; }
+
+    /**
+     * @brief View of samples [startIndex, endIndex) in the source buffer
+     *
+     * Valid while the label keeps its source. Empty if there is no source or
+     * the range doesn't fit in it.
+     */
+    SampleView getSamples() const;
 
     // Setters
     void setStartIndex(size_t start) { startIndex = start; }
@@ -30,7 +54,7 @@ public:
     void setColor(const std::string& col) { color = col; }
     void setStartTime(float time) { startTime = time; }
     void setEndTime(float time) { endTime = time; }
-    void setVoltageData(const std::vector<float>& data) { voltageData = data; }
+    void setSource(SampleBuffer::Ptr buffer) { source = std::move(buffer); }
 
     // Utility
     size_t getLength() const { return endIndex - startIndex; }
@@ -45,7 +69,7 @@ private:
     std::string color;  // Hex color code like "#FF0000"
     float startTime;    // Start time in seconds
     float endTime;      // End time in seconds
-    std::vector<float> voltageData;  // Voltage values in the segment
+    SampleBuffer::Ptr source;  // Channel buffer the indices refer to
 
     static int nextId;
 };
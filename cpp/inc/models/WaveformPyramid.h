@@ -0,0 +1,82 @@
+#ifndef WAVEFORMPYRAMID_H
+#define WAVEFORMPYRAMID_H
+
+#include <cstddef>
+#include <vector>
+#include "SampleView.h"
+
+/**
+ * @brief Min/max envelope of one display bucket
+ */
+struct WaveformBucket {
+    size_t index;   // First sample of the bucket
+    float min;
+    float max;
+};
+
+/**
+ * @brief Multi-resolution min/max pyramid over a channel's samples
+ *
+ * Level 0 stores the min/max of every BASE_BIN_SIZE samples, each further
+ * level halves the resolution. The min/max of any sample range is answered
+ * from at most two bins per level plus the unaligned head and tail, so an
+ * envelope of N pixels costs O(N log n) instead of a pass over the data,
+ * and single-sample spikes survive at every zoom level.
+ *
+ * The pyramid keeps a view of the samples it was built from; whoever owns
+ * those samples must keep them alive (ChannelData holds both together).
+ */
+class WaveformPyramid {
+public:
+    static constexpr size_t BASE_BIN_SIZE = 16;
+
+    WaveformPyramid();
+    explicit WaveformPyramid(SampleView data);
+
+    /**
+     * @brief (Re)build all levels from the given samples
+     */
+    void build(SampleView data);
+
+    void clear();
+
+    size_t size() const { return data.size(); }
+    bool empty() const { return data.empty(); }
+    size_t getNumLevels() const { return levels.size(); }
+
+    /**
+     * @brief Min/max of samples [start, end)
+     * @return False if the range is empty
+     */
+    bool getMinMax(size_t start, size_t end, float& minVal, float& maxVal) const;
+
+    /**
+     * @brief Split [start, end) into numBuckets equal buckets and return the
+     * true min/max of each. Ranges shorter than numBuckets return one bucket
+     * per sample (min == max).
+     */
+    std::vector<WaveformBucket> getEnvelope(size_t start, size_t end, size_t numBuckets) const;
+
+    /**
+     * @brief Same as getEnvelope(), but by scanning the samples directly
+     *
+     * For one-off buffers (e.g. a freshly filtered signal) where building a
+     * pyramid would cost more than the single pass it saves.
+     */
+    static std::vector<WaveformBucket> scanEnvelope(SampleView data,
+                                                    size_t start,
+                                                    size_t end,
+                                                    size_t numBuckets);
+
+private:
+    struct Level {
+        size_t binSize;
+        std::vector<float> mins;
+        std::vector<float> maxs;
+    };
+
+    SampleView data;
+    std::vector<Level> levels;
+};
+
+#endif // WAVEFORMPYRAMID_H
@@ -0,0 +1,451 @@
+#include "ACQReader.h"
+#include "DataAnalyzer.h"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <numeric>
+#include <algorithm>
+
+namespace {
+
+// File revisions (graph header lVersion) at which layout changes
+const int32_t kRevisionMin = 30;            // AcqKnowledge 2.0a
+const int32_t kRevisionSampleDivider = 37;  // AcqKnowledge 3.7: nVarSampleDivider
+const int32_t kRevisionPost4 = 61;          // AcqKnowledge 4.0 beta: 32-bit foreign length
+const int32_t kRevisionMax = 1000;
+
+// Offsets into the graph header
+const size_t kGraphVersionOffset = 2;
+const size_t kGraphHeaderLenOffset = 6;
+const size_t kGraphChannelsOffset = 10;
+const size_t kGraphSampleTimeOffset = 16;
+const size_t kGraphMinLength = 24;
+
+// Offsets into a channel header
+const size_t kChanHeaderLenOffset = 0;
+const size_t kChanNumOffset = 4;
+const size_t kChanCommentOffset = 6;
+const size_t kChanCommentLength = 40;
+const size_t kChanUnitsOffset = 68;
+const size_t kChanUnitsLength = 20;
+const size_t kChanBufLengthOffset = 88;
+const size_t kChanAmplScaleOffset = 92;
+const size_t kChanAmplOffsetOffset = 100;
+const size_t kChanDividerOffset = 250;
+const size_t kChanMinLength = 108;
+
+// Channel data type header
+const size_t kDTypeHeaderLength = 4;
+const int16_t kDTypeDouble = 1;
+const int16_t kDTypeInt16 = 2;
+
+const size_t kReadChunkBytes = 8 * 1024 * 1024;
+
+/**
+ * @brief Buffered sequential reader over the interleaved data section
+ */
+class ChunkReader {
+public:
+    explicit ChunkReader(std::ifstream& file) : file(file), pos(0), end(0) {}
+
+    const char* take(size_t n) {
+        if (end - pos < n && !refill(n)) {
+            return nullptr;
+        }
+        const char* p = buffer.data() + pos;
+        pos += n;
+        return p;
+    }
+
+private:
+    bool refill(size_t n) {
+        size_t remaining = end - pos;
+        size_t capacity = std::max(kReadChunkBytes, n);
+        std::vector<char> next(capacity);
+        std::memcpy(next.data(), buffer.data() + pos, remaining);
+        file.read(next.data() + remaining, capacity - remaining);
+        end = remaining + static_cast<size_t>(file.gcount());
+        pos = 0;
+        buffer.swap(next);
+        return end >= n;
+    }
+
+    std::ifstream& file;
+    std::vector<char> buffer;
+    size_t pos;
+    size_t end;
+};
+
+std::string currentTimestamp() {
+    std::time_t now = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    return buf;
+}
+
+std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+} // namespace
+
+ACQReader::ACQReader()
+    : bigEndian(false)
+{
+}
+
+ACQReader::~ACQReader() {
+}
+
+int16_t ACQReader::readInt16(const char* p) const {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    uint16_t v = bigEndian ? static_cast<uint16_t>((b[0] << 8) | b[1])
+                           : static_cast<uint16_t>((b[1] << 8) | b[0]);
+    return static_cast<int16_t>(v);
+}
+
+int32_t ACQReader::readInt32(const char* p) const {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) {
+        v |= static_cast<uint32_t>(b[bigEndian ? i : 3 - i]) << (8 * (3 - i));
+    }
+    return static_cast<int32_t>(v);
+}
+
+double ACQReader::readDouble(const char* p) const {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) {
+        v |= static_cast<uint64_t>(b[bigEndian ? i : 7 - i]) << (8 * (7 - i));
+    }
+    double d;
+    std::memcpy(&d, &v, sizeof(d));
+    return d;
+}
+
+std::string ACQReader::readString(const char* p, size_t maxLen) const {
+    size_t len = 0;
+    while (len < maxLen && p[len] != '\0') {
+        ++len;
+    }
+    std::string s(p, len);
+    size_t last = s.find_last_not_of(' ');
+    return last == std::string::npos ? std::string() : s.substr(0, last + 1);
+}
+
+bool ACQReader::readBlock(std::ifstream& file, int64_t offset, size_t length,
+                          std::vector<char>& block) {
+    block.resize(length);
+    file.clear();
+    file.seekg(offset, std::ios::beg);
+    file.read(block.data(), length);
+    if (static_cast<size_t>(file.gcount()) != length) {
+        lastError = "Unexpected end of file while reading headers";
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<ACQFileMetadata> ACQReader::readFile(const std::string& acqFilePath) {
+    lastError.clear();
+
+    std::ifstream file(acqFilePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        lastError = "Failed to open ACQ file: " + acqFilePath;
+        std::cerr << lastError << std::endl;
+        return nullptr;
+    }
+    int64_t fileSize = static_cast<int64_t>(file.tellg());
+
+    GraphHeader graph;
+    std::vector<ChannelHeader> channelHeaders;
+    std::vector<ChannelDType> dtypes;
+    int64_t dataOffset = 0;
+
+    if (!parseHeaders(file, fileSize, graph, channelHeaders, dtypes, dataOffset)) {
+        std::cerr << "ACQReader: " << lastError << std::endl;
+        return nullptr;
+    }
+
+    // Uncompressed payload must fit in the file; compressed files fail here
+    int64_t payloadBytes = 0;
+    for (size_t i = 0; i < channelHeaders.size(); ++i) {
+        payloadBytes += static_cast<int64_t>(channelHeaders[i].numSamples) * dtypes[i].size;
+    }
+    if (dataOffset + payloadBytes > fileSize) {
+        lastError = "Data section is shorter than channel headers declare (compressed file?)";
+        std::cerr << "ACQReader: " << lastError << std::endl;
+        return nullptr;
+    }
+
+    file.clear();
+    file.seekg(dataOffset, std::ios::beg);
+
+    std::vector<std::vector<float>> samples;
+    if (!decodeSamples(file, channelHeaders, dtypes, samples)) {
+        std::cerr << "ACQReader: " << lastError << std::endl;
+        return nullptr;
+    }
+
+    auto fileMetadata = std::make_shared<ACQFileMetadata>();
+    fileMetadata->setSourceFile(baseName(acqFilePath));
+    fileMetadata->setTimestamp(currentTimestamp());
+    fileMetadata->setNumChannels(static_cast<int>(channelHeaders.size()));
+
+    double baseRate = 1000.0 / graph.sampleTimeMs;
+
+    for (size_t i = 0; i < channelHeaders.size(); ++i) {
+        const ChannelHeader& header = channelHeaders[i];
+        std::vector<float>& data = samples[i];
+
+        // Same fields as the converter (population std), one pass in double
+        DataAnalyzer::Moments moments = DataAnalyzer::computeMoments(data);
+
+        auto channel = std::make_shared<ChannelData>();
+        float sampleRate = static_cast<float>(baseRate / header.divider);
+        channel->setIndex(static_cast<int>(i));
+        channel->setName(header.name);
+        channel->setUnits(header.units);
+        channel->setSampleRate(sampleRate);
+        channel->setDuration(static_cast<float>(data.size() / (baseRate / header.divider)));
+        channel->setStatistics(static_cast<float>(moments.min), static_cast<float>(moments.max),
+                               static_cast<float>(moments.mean), static_cast<float>(moments.stdDev()));
+        channel->setData(std::move(data));
+        if (dtypes[i].type == kDTypeInt16) {
+            // The exact float scaling decodeSamples() applied
+            channel->setAdcScale(static_cast<float>(header.amplScale), static_cast<float>(header.amplOffset));
+        }
+
+        fileMetadata->addChannel(channel);
+    }
+
+    std::cout << "ACQReader: loaded " << channelHeaders.size() << " channels from "
+              << acqFilePath << " (revision " << graph.version << ")" << std::endl;
+
+    return fileMetadata;
+}
+
+bool ACQReader::parseHeaders(std::ifstream& file,
+                             int64_t fileSize,
+                             GraphHeader& graph,
+                             std::vector<ChannelHeader>& channels,
+                             std::vector<ChannelDType>& dtypes,
+                             int64_t& dataOffset) {
+    std::vector<char> block;
+
+    // Graph header
+    if (fileSize < static_cast<int64_t>(kGraphMinLength) ||
+        !readBlock(file, 0, kGraphMinLength, block)) {
+        lastError = "File too small to be an ACQ file";
+        return false;
+    }
+
+    // Byte order: Windows files are little-endian, classic Mac files big-endian
+    bigEndian = false;
+    graph.version = readInt32(&block[kGraphVersionOffset]);
+    if (graph.version < kRevisionMin || graph.version >= kRevisionMax) {
+        bigEndian = true;
+        graph.version = readInt32(&block[kGraphVersionOffset]);
+        if (graph.version < kRevisionMin || graph.version >= kRevisionMax) {
+            lastError = "Unrecognized ACQ file revision";
+            return false;
+        }
+    }
+
+    graph.headerLength = readInt32(&block[kGraphHeaderLenOffset]);
+    graph.numChannels = readInt16(&block[kGraphChannelsOffset]);
+    graph.sampleTimeMs = readDouble(&block[kGraphSampleTimeOffset]);
+
+    if (graph.numChannels <= 0 || graph.headerLength < static_cast<int32_t>(kGraphMinLength) ||
+        graph.headerLength >= fileSize) {
+        lastError = "Invalid graph header";
+        return false;
+    }
+    if (!(graph.sampleTimeMs > 0.0) || !std::isfinite(graph.sampleTimeMs)) {
+        lastError = "Invalid sample interval in graph header";
+        return false;
+    }
+
+    // Channel headers: all share the length of the first one
+    int64_t offset = graph.headerLength;
+    if (!readBlock(file, offset, 4, block)) {
+        return false;
+    }
+    int32_t chanHeaderLength = readInt32(&block[kChanHeaderLenOffset]);
+    if (chanHeaderLength < static_cast<int32_t>(kChanMinLength) || chanHeaderLength > 65536) {
+        lastError = "Unsupported channel header layout";
+        return false;
+    }
+
+    channels.clear();
+    for (int c = 0; c < graph.numChannels; ++c) {
+        if (!readBlock(file, offset, chanHeaderLength, block)) {
+            return false;
+        }
+
+        ChannelHeader header;
+        header.headerLength = chanHeaderLength;
+        header.number = readInt16(&block[kChanNumOffset]);
+        header.name = readString(&block[kChanCommentOffset], kChanCommentLength);
+        header.units = readString(&block[kChanUnitsOffset], kChanUnitsLength);
+        header.numSamples = readInt32(&block[kChanBufLengthOffset]);
+        header.amplScale = readDouble(&block[kChanAmplScaleOffset]);
+        header.amplOffset = readDouble(&block[kChanAmplOffsetOffset]);
+        header.divider = 1;
+        if (graph.version >= kRevisionSampleDivider &&
+            chanHeaderLength >= static_cast<int32_t>(kChanDividerOffset + 2)) {
+            header.divider = readInt16(&block[kChanDividerOffset]);
+        }
+
+        if (header.numSamples < 0 || header.divider <= 0) {
+            lastError = "Invalid channel header for channel " + std::to_string(c);
+            return false;
+        }
+
+        channels.push_back(header);
+        offset += chanHeaderLength;
+    }
+
+    // Foreign data header: length prefix (16-bit before 4.0, 32-bit after)
+    if (!readBlock(file, offset, 4, block)) {
+        return false;
+    }
+    int64_t foreignLength = graph.version >= kRevisionPost4
+                                ? readInt32(&block[0])
+                                : readInt16(&block[0]);
+    if (foreignLength < 0 || offset + foreignLength >= fileSize) {
+        lastError = "Invalid foreign data header";
+        return false;
+    }
+    offset += foreignLength;
+
+    // Channel data type headers
+    size_t dtypeBytes = kDTypeHeaderLength * channels.size();
+    if (!readBlock(file, offset, dtypeBytes, block)) {
+        return false;
+    }
+
+    dtypes.clear();
+    for (size_t c = 0; c < channels.size(); ++c) {
+        ChannelDType dtype;
+        dtype.size = readInt16(&block[c * kDTypeHeaderLength]);
+        dtype.type = readInt16(&block[c * kDTypeHeaderLength + 2]);
+
+        bool valid = (dtype.type == kDTypeDouble && dtype.size == 8) ||
+                     (dtype.type == kDTypeInt16 && dtype.size == 2);
+        if (!valid) {
+            lastError = "Unsupported sample type for channel " + std::to_string(c);
+            return false;
+        }
+        dtypes.push_back(dtype);
+    }
+
+    dataOffset = offset + static_cast<int64_t>(dtypeBytes);
+    return true;
+}
+
+bool ACQReader::decodeSamples(std::ifstream& file,
+                              const std::vector<ChannelHeader>& channels,
+                              const std::vector<ChannelDType>& dtypes,
+                              std::vector<std::vector<float>>& samples) {
+    const size_t numChannels = channels.size();
+
+    samples.assign(numChannels, std::vector<float>());
+    for (size_t c = 0; c < numChannels; ++c) {
+        samples[c].resize(channels[c].numSamples);
+    }
+
+    // Channels are interleaved on a base-rate tick: channel c contributes a
+    // sample on every tick divisible by its divider. The pattern repeats
+    // every lcm(dividers) ticks.
+    int64_t period = 1;
+    for (const auto& header : channels) {
+        period = std::lcm(period, static_cast<int64_t>(header.divider));
+        if (period > 65536) {
+            lastError = "Sample divider pattern too long";
+            return false;
+        }
+    }
+
+    struct Slot {
+        size_t channel;
+        size_t size;
+    };
+    std::vector<Slot> pattern;
+    size_t patternBytes = 0;
+    std::vector<size_t> perPeriod(numChannels, 0);
+    for (int64_t tick = 0; tick < period; ++tick) {
+        for (size_t c = 0; c < numChannels; ++c) {
+            if (tick % channels[c].divider == 0) {
+                pattern.push_back({c, static_cast<size_t>(dtypes[c].size)});
+                patternBytes += dtypes[c].size;
+                perPeriod[c]++;
+            }
+        }
+    }
+
+    std::vector<float> scale(numChannels), offset(numChannels);
+    std::vector<bool> isInt16(numChannels);
+    for (size_t c = 0; c < numChannels; ++c) {
+        isInt16[c] = dtypes[c].type == kDTypeInt16;
+        scale[c] = static_cast<float>(channels[c].amplScale);
+        offset[c] = static_cast<float>(channels[c].amplOffset);
+    }
+
+    auto decode = [&](size_t c, const char* p) -> float {
+        if (isInt16[c]) {
+            return readInt16(p) * scale[c] + offset[c];
+        }
+        return static_cast<float>(readDouble(p));
+    };
+
+    ChunkReader reader(file);
+    std::vector<size_t> filled(numChannels, 0);
+
+    // Fast path: whole periods while every channel still needs a full period
+    auto fullPeriodFits = [&]() {
+        for (size_t c = 0; c < numChannels; ++c) {
+            if (samples[c].size() - filled[c] < perPeriod[c]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    while (fullPeriodFits()) {
+        const char* p = reader.take(patternBytes);
+        if (!p) {
+            lastError = "Unexpected end of data section";
+            return false;
+        }
+        for (const Slot& slot : pattern) {
+            samples[slot.channel][filled[slot.channel]++] = decode(slot.channel, p);
+            p += slot.size;
+        }
+    }
+
+    // Tail: channels drop out of the stream once their buffers are full
+    bool pending = true;
+    while (pending) {
+        pending = false;
+        for (const Slot& slot : pattern) {
+            size_t c = slot.channel;
+            if (filled[c] >= samples[c].size()) {
+                continue;
+            }
+            const char* p = reader.take(slot.size);
+            if (!p) {
+                lastError = "Unexpected end of data section";
+                return false;
+            }
+            samples[c][filled[c]++] = decode(c, p);
+            pending = true;
+        }
+    }
+
+    return true;
+}
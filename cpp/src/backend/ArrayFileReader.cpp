@@ -0,0 +1,469 @@
+#include "ArrayFileReader.h"
+#include "ArrayFileWriter.h"
+#include "DataAnalyzer.h"
+#include "MappedFile.h"
+#include "json.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using json = nlohmann::json;
+
+namespace {
+
+const uint32_t zipCentralSignature = 0x02014b50;
+const uint32_t zipEndSignature = 0x06054b50;
+const uint32_t zip64LocatorSignature = 0x07064b50;
+const uint32_t zip64EndSignature = 0x06064b50;
+const size_t zipEndSize = 22;
+const uint32_t zip32Max = 0xFFFFFFFFu;
+
+const std::string sampleRatesMember = "_sample_rates.npy";
+
+uint16_t read16(const char* p) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint16_t>(b[0] | (b[1] << 8));
+}
+
+uint32_t read32(const char* p) {
+    return read16(p) | (static_cast<uint32_t>(read16(p + 2)) << 16);
+}
+
+uint64_t read64(const char* p) {
+    return read32(p) | (static_cast<uint64_t>(read32(p + 4)) << 32);
+}
+
+std::string lowerExtension(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return std::string();
+    }
+    std::string ext = path.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+// Value following 'key': in a .npy header dict
+bool findDictValue(const std::string& dict, const std::string& key, size_t& pos) {
+    size_t at = dict.find("'" + key + "'");
+    if (at == std::string::npos) {
+        return false;
+    }
+    at = dict.find(':', at);
+    if (at == std::string::npos) {
+        return false;
+    }
+    pos = dict.find_first_not_of(' ', at + 1);
+    return pos != std::string::npos;
+}
+
+}
+
+ArrayFileReader::ArrayFileReader() {
+}
+
+ArrayFileReader::~ArrayFileReader() {
+}
+
+bool ArrayFileReader::isArrayFile(const std::string& path) {
+    std::string ext = lowerExtension(path);
+    return ext == ".npy" || ext == ".npz" || ext == ".f32";
+}
+
+std::shared_ptr<ACQFileMetadata> ArrayFileReader::readFile(const std::string& path) {
+    lastError.clear();
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+        lastError = "Failed to map " + path + ": " + file->getLastError();
+        return nullptr;
+    }
+
+    std::vector<ArraySource> sources;
+    std::string ext = lowerExtension(path);
+    bool ok = false;
+    if (ext == ".npy") {
+        ok = readNpy(*file, baseName(path), sources);
+    } else if (ext == ".npz") {
+        ok = readNpz(*file, sources);
+    } else if (ext == ".f32") {
+        ok = readRaw(path, *file, sources);
+    } else {
+        lastError = "Unsupported file type: " + path;
+    }
+
+    if (!ok) {
+        return nullptr;
+    }
+    if (sources.empty()) {
+        lastError = "No arrays found in " + path;
+        return nullptr;
+    }
+
+    auto fileMetadata = std::make_shared<ACQFileMetadata>();
+    fileMetadata->setSourceFile(baseName(path));
+    fileMetadata->setNumChannels(static_cast<int>(sources.size()));
+
+    std::shared_ptr<const MappedFile> mapping = file;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const ArraySource& source = sources[i];
+        SampleBuffer::Ptr buffer = makeBuffer(mapping, source);
+        DataAnalyzer::Moments moments = DataAnalyzer::computeMoments(buffer->view());
+
+        auto channel = std::make_shared<ChannelData>();
+        channel->setIndex(static_cast<int>(i));
+        channel->setName(source.name);
+        channel->setUnits(source.units);
+        channel->setSampleRate(source.sampleRate);
+        channel->setDuration(static_cast<float>(buffer->size() / source.sampleRate));
+        channel->setStatistics(static_cast<float>(moments.min), static_cast<float>(moments.max),
+                               static_cast<float>(moments.mean), static_cast<float>(moments.stdDev()));
+        channel->setBuffer(std::move(buffer));
+
+        fileMetadata->addChannel(channel);
+    }
+
+    std::cout << "ArrayFileReader: loaded " << sources.size() << " channels from " << path << std::endl;
+    return fileMetadata;
+}
+
+bool ArrayFileReader::parseNpyHeader(const char* data, size_t size, NpyArray& array) {
+    if (size < 10 || std::memcmp(data, "\x93NUMPY", 6) != 0) {
+        lastError = "Not a .npy array";
+        return false;
+    }
+
+    const int major = static_cast<unsigned char>(data[6]);
+    size_t headerLength;
+    size_t prefix;
+    if (major == 1) {
+        headerLength = read16(data + 8);
+        prefix = 10;
+    } else if ((major == 2 || major == 3) && size >= 12) {
+        headerLength = read32(data + 8);
+        prefix = 12;
+    } else {
+        lastError = "Unsupported .npy version " + std::to_string(major);
+        return false;
+    }
+
+    if (prefix + headerLength > size) {
+        lastError = "Truncated .npy header";
+        return false;
+    }
+    const std::string dict(data + prefix, headerLength);
+
+    // descr: byte order, kind, item size, e.g. '<f4'
+    size_t pos;
+    if (!findDictValue(dict, "descr", pos) || dict.size() < pos + 5 || dict[pos] != '\'') {
+        lastError = "Missing dtype in .npy header";
+        return false;
+    }
+    std::string descr = dict.substr(pos + 1, dict.find('\'', pos + 1) - pos - 1);
+    if (descr.size() < 3 || descr[0] == '>') {
+        lastError = "Unsupported dtype '" + descr + "' (need little-endian)";
+        return false;
+    }
+    array.kind = descr[1];
+    array.itemSize = static_cast<size_t>(std::atoi(descr.c_str() + 2));
+    bool supported = (array.kind == 'f' && (array.itemSize == 4 || array.itemSize == 8)) ||
+                     (array.kind == 'i' && (array.itemSize == 2 || array.itemSize == 4)) ||
+                     (array.kind == 'u' && array.itemSize == 2);
+    if (!supported) {
+        lastError = "Unsupported dtype '" + descr + "'";
+        return false;
+    }
+
+    array.fortranOrder = findDictValue(dict, "fortran_order", pos) && dict.compare(pos, 4, "True") == 0;
+
+    if (!findDictValue(dict, "shape", pos) || dict[pos] != '(') {
+        lastError = "Missing shape in .npy header";
+        return false;
+    }
+    array.shape.clear();
+    size_t close = dict.find(')', pos);
+    std::string dims = dict.substr(pos + 1, close - pos - 1);
+    for (size_t i = 0; i < dims.size();) {
+        if (std::isdigit(static_cast<unsigned char>(dims[i]))) {
+            size_t used = 0;
+            array.shape.push_back(static_cast<size_t>(std::stoull(dims.substr(i), &used)));
+            i += used;
+        } else {
+            ++i;
+        }
+    }
+    if (array.shape.empty() || array.shape.size() > 2) {
+        lastError = "Only 1-D and 2-D arrays can be loaded";
+        return false;
+    }
+
+    array.dataOffset = prefix + headerLength;
+    size_t elements = array.shape[0] * (array.shape.size() == 2 ? array.shape[1] : 1);
+    if (array.dataOffset + elements * array.itemSize > size) {
+        lastError = "Truncated .npy data";
+        return false;
+    }
+    return true;
+}
+
+bool ArrayFileReader::addNpyArrays(const NpyArray& array, size_t base, const std::string& name,
+                                   std::vector<ArraySource>& sources) {
+    ArraySource source;
+    source.units = "";
+    source.sampleRate = DEFAULT_SAMPLE_RATE;
+    source.kind = array.kind;
+    source.itemSize = array.itemSize;
+    source.offset = base + array.dataOffset;
+
+    if (array.shape.size() == 1) {
+        source.name = name;
+        source.count = array.shape[0];
+        source.stride = 1;
+        sources.push_back(source);
+        return true;
+    }
+
+    // 2-D: channels along the shorter axis
+    const size_t rows = array.shape[0];
+    const size_t cols = array.shape[1];
+    const bool channelsAreRows = rows <= cols;
+    const size_t numChannels = channelsAreRows ? rows : cols;
+    source.count = channelsAreRows ? cols : rows;
+
+    // Element (r, c) lives at r * cols + c (C order) or r + c * rows (Fortran)
+    const size_t rowStep = array.fortranOrder ? 1 : cols;
+    const size_t colStep = array.fortranOrder ? rows : 1;
+    for (size_t k = 0; k < numChannels; ++k) {
+        size_t first = channelsAreRows ? k * rowStep : k * colStep;
+        source.name = name + "_" + std::to_string(k);
+        source.offset = base + array.dataOffset + first * array.itemSize;
+        source.stride = channelsAreRows ? colStep : rowStep;
+        sources.push_back(source);
+    }
+    return true;
+}
+
+bool ArrayFileReader::readNpy(const MappedFile& file, const std::string& name,
+                              std::vector<ArraySource>& sources) {
+    NpyArray array;
+    if (!parseNpyHeader(file.data(), file.size(), array)) {
+        return false;
+    }
+
+    std::cout << "ArrayFileReader: .npy stores no sample rate, assuming "
+              << DEFAULT_SAMPLE_RATE << " Hz" << std::endl;
+    return addNpyArrays(array, 0, name, sources);
+}
+
+bool ArrayFileReader::readNpz(const MappedFile& file, std::vector<ArraySource>& sources) {
+    const char* data = file.data();
+    const size_t size = file.size();
+
+    // End of central directory: last record, before an optional comment
+    if (size < zipEndSize) {
+        lastError = "Not a zip archive";
+        return false;
+    }
+    size_t end = size - zipEndSize;
+    const size_t lowest = size > zipEndSize + 0xFFFF ? size - zipEndSize - 0xFFFF : 0;
+    while (read32(data + end) != zipEndSignature) {
+        if (end == lowest) {
+            lastError = "Not a zip archive";
+            return false;
+        }
+        --end;
+    }
+
+    uint64_t numEntries = read16(data + end + 10);
+    uint64_t directoryOffset = read32(data + end + 16);
+    if (end >= 20 && read32(data + end - 20) == zip64LocatorSignature) {
+        uint64_t recordOffset = read64(data + end - 20 + 8);
+        if (recordOffset + 56 > size || read32(data + recordOffset) != zip64EndSignature) {
+            lastError = "Corrupt zip64 end record";
+            return false;
+        }
+        numEntries = read64(data + recordOffset + 32);
+        directoryOffset = read64(data + recordOffset + 48);
+    }
+
+    std::vector<double> rates;
+    size_t firstSource = sources.size();
+    size_t p = directoryOffset;
+    for (uint64_t i = 0; i < numEntries; ++i) {
+        if (p + 46 > size || read32(data + p) != zipCentralSignature) {
+            lastError = "Corrupt zip central directory";
+            return false;
+        }
+
+        const uint16_t method = read16(data + p + 10);
+        uint64_t memberSize = read32(data + p + 24);
+        const uint16_t nameLength = read16(data + p + 28);
+        const uint16_t extraLength = read16(data + p + 30);
+        const uint16_t commentLength = read16(data + p + 32);
+        uint64_t localOffset = read32(data + p + 42);
+        if (p + 46 + nameLength + extraLength > size) {
+            lastError = "Corrupt zip central directory";
+            return false;
+        }
+        const std::string name(data + p + 46, nameLength);
+
+        // Zip64 extra holds the 64-bit values of the fields set to 0xFFFFFFFF
+        const char* extra = data + p + 46 + nameLength;
+        for (size_t e = 0; e + 4 <= extraLength;) {
+            uint16_t id = read16(extra + e);
+            uint16_t length = read16(extra + e + 2);
+            if (id == 0x0001) {
+                size_t field = e + 4;
+                if (memberSize == zip32Max && field + 8 <= e + 4 + length) {
+                    memberSize = read64(extra + field);
+                    field += 8;
+                }
+                if (read32(data + p + 20) == zip32Max && field + 8 <= e + 4 + length) {
+                    field += 8;  // Compressed size; equal for stored members
+                }
+                if (localOffset == zip32Max && field + 8 <= e + 4 + length) {
+                    localOffset = read64(extra + field);
+                }
+            }
+            e += 4 + length;
+        }
+        p += 46 + nameLength + extraLength + commentLength;
+
+        if (name.size() < 4 || name.compare(name.size() - 4, 4, ".npy") != 0) {
+            continue;
+        }
+        if (method != 0) {
+            lastError = "Compressed .npz members are not supported (save with np.savez)";
+            return false;
+        }
+
+        if (localOffset + 30 > size) {
+            lastError = "Corrupt zip local header";
+            return false;
+        }
+        size_t memberData = localOffset + 30 + read16(data + localOffset + 26) + read16(data + localOffset + 28);
+        if (memberData + memberSize > size) {
+            lastError = "Truncated zip member " + name;
+            return false;
+        }
+
+        NpyArray array;
+        if (!parseNpyHeader(data + memberData, memberSize, array)) {
+            lastError = name + ": " + lastError;
+            return false;
+        }
+
+        if (name == sampleRatesMember) {
+            if (array.kind == 'f' && array.itemSize == 8 && array.shape.size() == 1) {
+                rates.resize(array.shape[0]);
+                std::memcpy(rates.data(), data + memberData + array.dataOffset, rates.size() * sizeof(double));
+            }
+            continue;
+        }
+
+        if (!addNpyArrays(array, memberData, name.substr(0, name.size() - 4), sources)) {
+            return false;
+        }
+    }
+
+    // Rates are stored in member order, one per 1-D array
+    for (size_t i = 0; i < rates.size() && firstSource + i < sources.size(); ++i) {
+        if (rates[i] > 0.0) {
+            sources[firstSource + i].sampleRate = static_cast<float>(rates[i]);
+        }
+    }
+    return true;
+}
+
+bool ArrayFileReader::readRaw(const std::string& dataPath, const MappedFile& file,
+                              std::vector<ArraySource>& sources) {
+    const std::string headerPath = ArrayFileWriter::rawHeaderPath(dataPath);
+    try {
+        std::ifstream stream(headerPath);
+        if (!stream.is_open()) {
+            lastError = "Missing header file " + headerPath;
+            return false;
+        }
+
+        json header;
+        stream >> header;
+
+        if (header.value("format", std::string("float32le")) != "float32le") {
+            lastError = "Unsupported raw format in " + headerPath;
+            return false;
+        }
+
+        for (const auto& item : header.at("arrays")) {
+            ArraySource source;
+            source.name = item.value("name", std::string("Channel ") + std::to_string(sources.size()));
+            source.units = item.value("units", std::string());
+            source.sampleRate = item.value("sample_rate", DEFAULT_SAMPLE_RATE);
+            source.offset = item.at("offset").get<size_t>();
+            source.count = item.at("count").get<size_t>();
+            source.stride = 1;
+            source.kind = 'f';
+            source.itemSize = sizeof(float);
+
+            if (source.offset + source.count * sizeof(float) > file.size()) {
+                lastError = "Array '" + source.name + "' runs past the end of " + dataPath;
+                return false;
+            }
+            if (source.sampleRate <= 0.0f) {
+                source.sampleRate = DEFAULT_SAMPLE_RATE;
+            }
+            sources.push_back(source);
+        }
+    } catch (const std::exception& e) {
+        lastError = "Invalid header " + headerPath + ": " + e.what();
+        return false;
+    }
+    return true;
+}
+
+SampleBuffer::Ptr ArrayFileReader::makeBuffer(const std::shared_ptr<const MappedFile>& file,
+                                              const ArraySource& source) {
+    // The common case needs no copy at all
+    if (source.kind == 'f' && source.itemSize == sizeof(float) && source.stride == 1 &&
+        source.offset % sizeof(float) == 0) {
+        SampleBuffer::Ptr mapped = SampleBuffer::create(file, source.offset, source.count);
+        if (mapped) {
+            return mapped;
+        }
+    }
+
+    std::vector<float> samples(source.count);
+    const char* p = file->data() + source.offset;
+    const size_t step = source.stride * source.itemSize;
+
+    for (size_t i = 0; i < source.count; ++i, p += step) {
+        if (source.kind == 'f' && source.itemSize == 4) {
+            float value;
+            std::memcpy(&value, p, sizeof(value));
+            samples[i] = value;
+        } else if (source.kind == 'f') {
+            double value;
+            std::memcpy(&value, p, sizeof(value));
+            samples[i] = static_cast<float>(value);
+        } else if (source.kind == 'i' && source.itemSize == 2) {
+            samples[i] = static_cast<int16_t>(read16(p));
+        } else if (source.kind == 'i') {
+            samples[i] = static_cast<float>(static_cast<int32_t>(read32(p)));
+        } else {
+            samples[i] = read16(p);
+        }
+    }
+    return SampleBuffer::create(std::move(samples));
+}
@@ -0,0 +1,391 @@
+#include "ArrayFileWriter.h"
+#include "BufferedWriter.h"
+#include "JsonWriter.h"
+#include <algorithm>
+#include <cctype>
+#include <set>
+
+namespace {
+
+const uint32_t zipLocalSignature = 0x04034b50;
+const uint32_t zipCentralSignature = 0x02014b50;
+const uint32_t zipEndSignature = 0x06054b50;
+const uint32_t zip64EndSignature = 0x06064b50;
+const uint32_t zip64LocatorSignature = 0x07064b50;
+const uint16_t zip64ExtraId = 0x0001;
+const uint16_t zipPaddingExtraId = 0xD935;  // Alignment padding, as zipalign writes it
+const uint16_t zipVersion = 20;
+const uint16_t zip64Version = 45;
+const uint16_t zipDosDate = (0 << 9) | (1 << 5) | 1;  // 1980-01-01
+const uint32_t zip32Max = 0xFFFFFFFFu;
+
+const char* sampleRatesName = "_sample_rates";
+
+void put16(std::vector<char>& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void put32(std::vector<char>& out, uint32_t value) {
+    put16(out, static_cast<uint16_t>(value & 0xFFFF));
+    put16(out, static_cast<uint16_t>(value >> 16));
+}
+
+void put64(std::vector<char>& out, uint64_t value) {
+    put32(out, static_cast<uint32_t>(value & 0xFFFFFFFFu));
+    put32(out, static_cast<uint32_t>(value >> 32));
+}
+
+std::string validKey(const std::string& name) {
+    std::string key;
+    for (char c : name) {
+        bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        key += valid ? c : '_';
+    }
+    return key.empty() ? std::string("array") : key;
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    if (text.size() < suffix.size()) {
+        return false;
+    }
+    return std::equal(suffix.rbegin(), suffix.rend(), text.rbegin(),
+                      [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+}
+
+}
+
+ArrayFileWriter::ArrayFileWriter() {
+}
+
+ArrayFileWriter::~ArrayFileWriter() {
+}
+
+void ArrayFileWriter::addArray(const std::string& name, SampleBuffer::Ptr buffer,
+                               size_t start, size_t end,
+                               double sampleRate, const std::string& units) {
+    SampleView samples = buffer ? buffer->view() : SampleView();
+    end = std::min(end, samples.size());
+    start = std::min(start, end);
+
+    // Unique .npz-safe name; the reserved sample-rate key is taken
+    std::set<std::string> taken = {sampleRatesName};
+    for (const auto& array : arrays) {
+        taken.insert(array.name);
+    }
+    std::string key = validKey(name);
+    std::string unique = key;
+    for (int n = 2; taken.count(unique); ++n) {
+        unique = key + "_" + std::to_string(n);
+    }
+
+    arrays.push_back({unique, std::move(buffer), samples.subview(start, end - start), sampleRate, units});
+}
+
+void ArrayFileWriter::addArray(const std::string& name, SampleBuffer::Ptr buffer,
+                               double sampleRate, const std::string& units) {
+    size_t size = buffer ? buffer->size() : 0;
+    addArray(name, std::move(buffer), 0, size, sampleRate, units);
+}
+
+std::string ArrayFileWriter::rawHeaderPath(const std::string& dataPath) {
+    if (endsWith(dataPath, ".f32")) {
+        return dataPath.substr(0, dataPath.size() - 4) + ".json";
+    }
+    return dataPath + ".json";
+}
+
+bool ArrayFileWriter::writeFile(const std::string& path) {
+    if (endsWith(path, ".npy")) {
+        return writeNpy(path);
+    }
+    if (endsWith(path, ".npz")) {
+        return writeNpz(path);
+    }
+    return writeRaw(path);
+}
+
+std::string ArrayFileWriter::npyHeader(const char* descr, const std::string& shape) {
+    // Format 1.0: magic, version, little-endian header length, then a dict
+    // padded with spaces so the data starts on a DATA_ALIGNMENT boundary
+    std::string dict = std::string("{'descr': '") + descr + "', 'fortran_order': False, 'shape': " + shape + ", }";
+    const size_t prefix = 10;
+    size_t total = prefix + dict.size() + 1;
+    total = (total + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+    dict.append(total - prefix - dict.size() - 1, ' ');
+    dict += '\n';
+
+    uint16_t length = static_cast<uint16_t>(dict.size());
+    std::string header = "\x93NUMPY";
+    header += '\x01';
+    header += '\x00';
+    header += static_cast<char>(length & 0xFF);
+    header += static_cast<char>(length >> 8);
+    return header + dict;
+}
+
+uint32_t ArrayFileWriter::crc32(uint32_t crc, const void* data, size_t size) {
+    // Slicing-by-8 over the reflected IEEE polynomial
+    static const auto tables = []() {
+        std::vector<uint32_t> t(8 * 256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            t[i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int s = 1; s < 8; ++s) {
+                t[s * 256 + i] = (t[(s - 1) * 256 + i] >> 8) ^ t[t[(s - 1) * 256 + i] & 0xFF];
+            }
+        }
+        return t;
+    }();
+    const uint32_t* t = tables.data();
+
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    while (size >= 8) {
+        uint32_t lo = crc ^ (uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24);
+        crc = t[7 * 256 + (lo & 0xFF)] ^ t[6 * 256 + ((lo >> 8) & 0xFF)] ^
+              t[5 * 256 + ((lo >> 16) & 0xFF)] ^ t[4 * 256 + (lo >> 24)] ^
+              t[3 * 256 + p[4]] ^ t[2 * 256 + p[5]] ^ t[1 * 256 + p[6]] ^ t[p[7]];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = t[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+bool ArrayFileWriter::writeNpy(const std::string& path) {
+    if (arrays.empty()) {
+        lastError = "No arrays to write";
+        return false;
+    }
+
+    // Several arrays only fit one .npy as a 2-D array of equal-length rows
+    const size_t length = arrays[0].samples.size();
+    for (const auto& array : arrays) {
+        if (array.samples.size() != length) {
+            lastError = "Arrays differ in length; .npy holds one array, use .npz or raw";
+            return false;
+        }
+    }
+
+    std::string shape = arrays.size() == 1
+        ? "(" + std::to_string(length) + ",)"
+        : "(" + std::to_string(arrays.size()) + ", " + std::to_string(length) + ")";
+
+    BufferedWriter out;
+    if (!out.open(path)) {
+        lastError = out.getLastError();
+        return false;
+    }
+    out.write(npyHeader("<f4", shape));
+    for (const auto& array : arrays) {
+        out.write(reinterpret_cast<const char*>(array.samples.data()), array.samples.size() * sizeof(float));
+    }
+
+    if (!out.close()) {
+        lastError = out.getLastError();
+        return false;
+    }
+    return true;
+}
+
+bool ArrayFileWriter::writeZipMember(BufferedWriter& out, const std::string& name,
+                                     const std::string& header, const void* data, size_t dataSize,
+                                     std::vector<char>& directory, uint64_t& numEntries) {
+    const uint64_t offset = out.getBytesWritten();
+    const uint64_t size = header.size() + dataSize;
+    const uint32_t crc = crc32(crc32(0, header.data(), header.size()), data, dataSize);
+    const bool zip64 = size >= zip32Max || offset >= zip32Max;
+
+    // Local header, padded so the member's data is aligned in the archive
+    std::vector<char> local;
+    size_t extraSize = zip64 ? 20 : 0;
+    size_t dataStart = offset + 30 + name.size() + extraSize + 4;
+    size_t padding = (DATA_ALIGNMENT - dataStart % DATA_ALIGNMENT) % DATA_ALIGNMENT;
+    extraSize += 4 + padding;
+
+    put32(local, zipLocalSignature);
+    put16(local, zip64 ? zip64Version : zipVersion);
+    put16(local, 0);  // Flags
+    put16(local, 0);  // Stored
+    put16(local, 0);  // Time
+    put16(local, zipDosDate);
+    put32(local, crc);
+    put32(local, zip64 ? zip32Max : static_cast<uint32_t>(size));
+    put32(local, zip64 ? zip32Max : static_cast<uint32_t>(size));
+    put16(local, static_cast<uint16_t>(name.size()));
+    put16(local, static_cast<uint16_t>(extraSize));
+    local.insert(local.end(), name.begin(), name.end());
+    if (zip64) {
+        put16(local, zip64ExtraId);
+        put16(local, 16);
+        put64(local, size);
+        put64(local, size);
+    }
+    put16(local, zipPaddingExtraId);
+    put16(local, static_cast<uint16_t>(padding));
+    local.insert(local.end(), padding, '\0');
+
+    out.write(local.data(), local.size());
+    out.write(header);
+    out.write(static_cast<const char*>(data), dataSize);
+
+    // Matching central directory entry
+    put32(directory, zipCentralSignature);
+    put16(directory, zip64Version);  // Made by
+    put16(directory, zip64 ? zip64Version : zipVersion);
+    put16(directory, 0);
+    put16(directory, 0);
+    put16(directory, 0);
+    put16(directory, zipDosDate);
+    put32(directory, crc);
+    put32(directory, zip64 ? zip32Max : static_cast<uint32_t>(size));
+    put32(directory, zip64 ? zip32Max : static_cast<uint32_t>(size));
+    put16(directory, static_cast<uint16_t>(name.size()));
+    put16(directory, static_cast<uint16_t>(zip64 ? 28 : 0));
+    put16(directory, 0);  // Comment
+    put16(directory, 0);  // Disk
+    put16(directory, 0);  // Internal attributes
+    put32(directory, 0);  // External attributes
+    put32(directory, zip64 ? zip32Max : static_cast<uint32_t>(offset));
+    directory.insert(directory.end(), name.begin(), name.end());
+    if (zip64) {
+        put16(directory, zip64ExtraId);
+        put16(directory, 24);
+        put64(directory, size);
+        put64(directory, size);
+        put64(directory, offset);
+    }
+
+    ++numEntries;
+    return out.good();
+}
+
+bool ArrayFileWriter::writeNpz(const std::string& path) {
+    if (arrays.empty()) {
+        lastError = "No arrays to write";
+        return false;
+    }
+
+    BufferedWriter out;
+    if (!out.open(path)) {
+        lastError = out.getLastError();
+        return false;
+    }
+
+    std::vector<char> directory;
+    uint64_t numEntries = 0;
+
+    for (const auto& array : arrays) {
+        std::string header = npyHeader("<f4", "(" + std::to_string(array.samples.size()) + ",)");
+        writeZipMember(out, array.name + ".npy", header, array.samples.data(),
+                       array.samples.size() * sizeof(float), directory, numEntries);
+    }
+
+    std::vector<double> rates;
+    for (const auto& array : arrays) {
+        rates.push_back(array.sampleRate);
+    }
+    writeZipMember(out, std::string(sampleRatesName) + ".npy",
+                   npyHeader("<f8", "(" + std::to_string(rates.size()) + ",)"),
+                   rates.data(), rates.size() * sizeof(double), directory, numEntries);
+
+    const uint64_t directoryOffset = out.getBytesWritten();
+    const uint64_t directorySize = directory.size();
+    const bool zip64 = directoryOffset >= zip32Max || directorySize >= zip32Max || numEntries >= 0xFFFF;
+
+    std::vector<char> end;
+    if (zip64) {
+        const uint64_t zip64EndOffset = directoryOffset + directorySize;
+        put32(end, zip64EndSignature);
+        put64(end, 44);  // Size of the rest of the record
+        put16(end, zip64Version);
+        put16(end, zip64Version);
+        put32(end, 0);
+        put32(end, 0);
+        put64(end, numEntries);
+        put64(end, numEntries);
+        put64(end, directorySize);
+        put64(end, directoryOffset);
+
+        put32(end, zip64LocatorSignature);
+        put32(end, 0);
+        put64(end, zip64EndOffset);
+        put32(end, 1);
+    }
+
+    put32(end, zipEndSignature);
+    put16(end, 0);
+    put16(end, 0);
+    put16(end, zip64 ? 0xFFFF : static_cast<uint16_t>(numEntries));
+    put16(end, zip64 ? 0xFFFF : static_cast<uint16_t>(numEntries));
+    put32(end, zip64 ? zip32Max : static_cast<uint32_t>(directorySize));
+    put32(end, zip64 ? zip32Max : static_cast<uint32_t>(directoryOffset));
+    put16(end, 0);  // Comment
+
+    out.write(directory.data(), directory.size());
+    out.write(end.data(), end.size());
+
+    if (!out.close()) {
+        lastError = out.getLastError();
+        return false;
+    }
+    return true;
+}
+
+bool ArrayFileWriter::writeRaw(const std::string& path) {
+    if (arrays.empty()) {
+        lastError = "No arrays to write";
+        return false;
+    }
+
+    BufferedWriter data;
+    BufferedWriter header;
+    const std::string headerPath = rawHeaderPath(path);
+    if (!data.open(path)) {
+        lastError = data.getLastError();
+        return false;
+    }
+    if (!header.open(headerPath)) {
+        lastError = header.getLastError();
+        return false;
+    }
+
+    size_t slash = path.find_last_of("/\\");
+    JsonWriter json(header);
+    json.beginObject();
+    json.member("format", "float32le");
+    json.member("data_file", slash == std::string::npos ? path : path.substr(slash + 1));
+    json.key("arrays");
+    json.beginArray();
+    for (const auto& array : arrays) {
+        json.beginObject();
+        json.member("name", array.name);
+        json.member("units", array.units);
+        json.member("sample_rate", array.sampleRate);
+        json.member("offset", data.getBytesWritten());
+        json.member("count", array.samples.size());
+        json.endObject();
+
+        data.write(reinterpret_cast<const char*>(array.samples.data()), array.samples.size() * sizeof(float));
+    }
+    json.endArray();
+    json.endObject();
+
+    bool ok = data.close();
+    if (!ok) {
+        lastError = data.getLastError();
+    }
+    if (!header.close()) {
+        lastError = header.getLastError();
+        ok = false;
+    }
+    return ok;
+}
@@ -0,0 +1,266 @@
+#include "BlockCodec.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Unary quotients this long switch to a verbatim 25-bit value
+const uint32_t escapeQuotient = 32;
+const unsigned escapeBits = 25;
+const unsigned maxRiceParameter = 24;
+
+inline uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+inline unsigned countTrailingOnes(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return ~bits == 0 ? 64 : static_cast<unsigned>(__builtin_ctzll(~bits));
+#else
+    unsigned count = 0;
+    while (count < 64 && (bits >> count) & 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief LSB-first bit packer
+ */
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out), bits(0), count(0) {}
+
+    // Up to 32 bits
+    void put(uint32_t value, unsigned width) {
+        bits |= static_cast<uint64_t>(value) << count;
+        count += width;
+        if (count >= 32) {
+            for (int i = 0; i < 4; ++i) {
+                out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+            }
+            bits >>= 32;
+            count -= 32;
+        }
+    }
+
+    void finish() {
+        for (; count > 0; count = count > 8 ? count - 8 : 0) {
+            out.push_back(static_cast<uint8_t>(bits));
+            bits >>= 8;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    uint64_t bits;
+    unsigned count;
+};
+
+/**
+ * @brief LSB-first bit reader; reads past the end as zeros and reports it
+ */
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : data(data), size(size), pos(0), bits(0), count(0), consumed(0) {}
+
+    // Ensures at least 57 bits are buffered
+    void refill() {
+        while (count <= 56) {
+            uint64_t byte = pos < size ? data[pos] : 0;
+            ++pos;
+            bits |= byte << count;
+            count += 8;
+        }
+    }
+
+    uint64_t peek() const { return bits; }
+
+    void skip(unsigned width) {
+        bits >>= width;
+        count -= width;
+        consumed += width;
+    }
+
+    uint32_t take(unsigned width) {
+        uint32_t value = static_cast<uint32_t>(bits & ((uint64_t(1) << width) - 1));
+        skip(width);
+        return value;
+    }
+
+    bool overrun() const { return consumed > 8 * static_cast<uint64_t>(size); }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint64_t bits;
+    unsigned count;
+    uint64_t consumed;
+};
+
+// The sample a grid level decodes to; encode() checks candidates with the
+// same function decode() uses, so accepted blocks round-trip bit for bit
+inline float gridValue(const BlockCodec::Grid& grid, int32_t level) {
+    return static_cast<float>(level - BlockCodec::ADC_LEVEL_BIAS) * static_cast<float>(grid.step) +
+           static_cast<float>(grid.offset);
+}
+
+inline bool sameBits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+uint64_t riceCost(const std::vector<uint32_t>& values, unsigned k) {
+    uint64_t cost = 0;
+    for (uint32_t value : values) {
+        uint32_t quotient = value >> k;
+        cost += quotient < escapeQuotient ? quotient + 1 + k : escapeQuotient + escapeBits;
+    }
+    return cost;
+}
+
+}
+
+BlockCodec::Grid BlockCodec::adcGrid(float scale, float offset) {
+    if (scale == 0.0f || !std::isfinite(scale) || !std::isfinite(offset)) {
+        return {0.0, 0.0};
+    }
+    return {offset, scale};
+}
+
+BlockCodec::BlockInfo BlockCodec::encode(const float* samples, size_t count, const Grid& grid,
+                                         std::vector<uint8_t>& out) {
+    BlockInfo info;
+    info.mode = RAW_FLOAT;
+    info.riceParameter = 0;
+    info.min = count > 0 ? samples[0] : 0.0f;
+    info.max = info.min;
+
+    bool onGrid = grid.step != 0.0 && count > 0;
+    std::vector<int32_t> levels(onGrid ? count : 0);
+    for (size_t i = 0; i < count; ++i) {
+        const float value = samples[i];
+        info.min = std::min(info.min, value);
+        info.max = std::max(info.max, value);
+
+        if (onGrid) {
+            // Only levels that reproduce the sample exactly are accepted
+            double level = std::round((value - grid.offset) / grid.step) + ADC_LEVEL_BIAS;
+            if (!(level >= 0.0 && level < MAX_LEVELS) ||
+                !sameBits(gridValue(grid, static_cast<int32_t>(level)), value)) {
+                onGrid = false;
+                continue;
+            }
+            levels[i] = static_cast<int32_t>(level);
+        }
+    }
+
+    if (!onGrid) {
+        size_t start = out.size();
+        out.resize(start + count * sizeof(float));
+        if (count > 0) {
+            std::memcpy(out.data() + start, samples, count * sizeof(float));
+        }
+        return info;
+    }
+
+    std::vector<uint32_t> deltas(count - 1);
+    uint64_t total = 0;
+    for (size_t i = 1; i < count; ++i) {
+        deltas[i - 1] = zigzag(levels[i] - levels[i - 1]);
+        total += deltas[i - 1];
+    }
+
+    // Best k is near log2 of the mean delta; check its neighbours exactly
+    unsigned guess = 0;
+    double mean = deltas.empty() ? 0.0 : static_cast<double>(total) / deltas.size();
+    while (guess < maxRiceParameter && (uint64_t(1) << (guess + 1)) <= mean) {
+        ++guess;
+    }
+    unsigned k = guess;
+    uint64_t best = riceCost(deltas, k);
+    for (unsigned candidate : {guess > 0 ? guess - 1 : guess, std::min(guess + 1, maxRiceParameter)}) {
+        uint64_t cost = riceCost(deltas, candidate);
+        if (cost < best) {
+            best = cost;
+            k = candidate;
+        }
+    }
+
+    info.mode = RICE_DELTA;
+    info.riceParameter = static_cast<uint8_t>(k);
+
+    const uint32_t first = static_cast<uint32_t>(levels[0]);
+    out.push_back(static_cast<uint8_t>(first));
+    out.push_back(static_cast<uint8_t>(first >> 8));
+    out.push_back(static_cast<uint8_t>(first >> 16));
+
+    BitWriter writer(out);
+    const uint32_t mask = (uint32_t(1) << k) - 1;
+    for (uint32_t value : deltas) {
+        uint32_t quotient = value >> k;
+        if (quotient < escapeQuotient) {
+            // quotient ones, a zero, then the k low bits
+            writer.put((uint32_t(1) << quotient) - 1, quotient + 1);
+            if (k > 0) {
+                writer.put(value & mask, k);
+            }
+        } else {
+            writer.put(0xFFFFFFFFu, escapeQuotient);
+            writer.put(value, escapeBits);
+        }
+    }
+    writer.finish();
+    return info;
+}
+
+bool BlockCodec::decode(const uint8_t* data, size_t size, const BlockInfo& info,
+                        const Grid& grid, size_t count, float* out) {
+    if (count == 0) {
+        return true;
+    }
+
+    if (info.mode == RAW_FLOAT) {
+        if (size < count * sizeof(float)) {
+            return false;
+        }
+        std::memcpy(out, data, count * sizeof(float));
+        return true;
+    }
+
+    if (info.mode != RICE_DELTA || size < 3 || info.riceParameter > maxRiceParameter || grid.step == 0.0) {
+        return false;
+    }
+
+    const unsigned k = info.riceParameter;
+    int32_t level = data[0] | (data[1] << 8) | (data[2] << 16);
+    out[0] = gridValue(grid, level);
+
+    BitReader reader(data + 3, size - 3);
+    for (size_t i = 1; i < count; ++i) {
+        reader.refill();
+        unsigned quotient = std::min(countTrailingOnes(reader.peek()), escapeQuotient);
+        uint32_t value;
+        if (quotient < escapeQuotient) {
+            reader.skip(quotient + 1);
+            value = (quotient << k) | (k > 0 ? reader.take(k) : 0);
+        } else {
+            reader.skip(escapeQuotient);
+            value = reader.take(escapeBits);
+        }
+
+        level += unzigzag(value);
+        if (level < 0 || static_cast<uint32_t>(level) >= MAX_LEVELS) {
+            return false;
+        }
+        out[i] = gridValue(grid, level);
+    }
+    return !reader.overrun();
+}
@@ -0,0 +1,102 @@
+#include "BufferedWriter.h"
+#include <algorithm>
+#include <cstring>
+
+BufferedWriter::BufferedWriter(size_t bufferSize)
+    : buffer(std::max(bufferSize, MAX_NUMBER_CHARS))
+    , used(0)
+    , flushed(0)
+    , failed(false)
+{
+}
+
+BufferedWriter::~BufferedWriter() {
+    if (file.is_open()) {
+        close();
+    }
+}
+
+bool BufferedWriter::open(const std::string& filePath) {
+    if (file.is_open()) {
+        close();
+    }
+
+    path = filePath;
+    used = 0;
+    flushed = 0;
+    failed = false;
+    lastError.clear();
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        failed = true;
+        lastError = "Failed to open file for writing: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool BufferedWriter::close() {
+    if (!file.is_open()) {
+        return !failed;
+    }
+
+    flush();
+    file.close();
+    if (file.fail() && !failed) {
+        failed = true;
+        lastError = "Failed to write to file: " + path;
+    }
+    return !failed;
+}
+
+void BufferedWriter::write(const char* data, size_t size) {
+    if (size <= buffer.size() - used) {
+        std::memcpy(&buffer[used], data, size);
+        used += size;
+        return;
+    }
+
+    // Large blocks (e.g. raw sample arrays) bypass the buffer
+    flush();
+    if (size < buffer.size()) {
+        std::memcpy(&buffer[0], data, size);
+        used = size;
+        return;
+    }
+
+    if (!failed && file.is_open()) {
+        file.write(data, static_cast<std::streamsize>(size));
+        if (file.fail()) {
+            failed = true;
+            lastError = "Failed to write to file: " + path;
+        }
+    }
+    flushed += size;
+}
+
+void BufferedWriter::writeFloat(float value) {
+    reserve(MAX_NUMBER_CHARS);
+    used = std::to_chars(&buffer[used], &buffer[0] + buffer.size(), value).ptr - &buffer[0];
+}
+
+void BufferedWriter::writeDouble(double value) {
+    reserve(MAX_NUMBER_CHARS);
+    used = std::to_chars(&buffer[used], &buffer[0] + buffer.size(), value).ptr - &buffer[0];
+}
+
+void BufferedWriter::flush() {
+    if (used == 0) {
+        return;
+    }
+
+    if (!failed && file.is_open()) {
+        file.write(buffer.data(), static_cast<std::streamsize>(used));
+        if (file.fail()) {
+            failed = true;
+            lastError = "Failed to write to file: " + path;
+        }
+    }
+    flushed += used;
+    used = 0;
+}
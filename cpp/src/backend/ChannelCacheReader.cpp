@@ -0,0 +1,262 @@
+#include "ChannelCacheReader.h"
+#include "ArrayFileWriter.h"
+#include "ChannelCacheWriter.h"
+#include "DataAnalyzer.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+const size_t headerSize = 24;
+const size_t footerSize = 20;
+const size_t blockEntrySize = 22;
+
+/**
+ * @brief Bounds-checked little-endian reader over the index
+ */
+class IndexReader {
+public:
+    IndexReader(const char* data, size_t size) : data(data), size(size), pos(0), failed(false) {}
+
+    template <typename T>
+    T read() {
+        T value = T();
+        if (pos + sizeof(T) > size) {
+            failed = true;
+            return value;
+        }
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    std::string readString() {
+        uint16_t length = read<uint16_t>();
+        if (pos + length > size) {
+            failed = true;
+            return std::string();
+        }
+        std::string text(data + pos, length);
+        pos += length;
+        return text;
+    }
+
+    bool remaining(size_t bytes) const { return !failed && pos + bytes <= size; }
+    bool ok() const { return !failed; }
+
+private:
+    const char* data;
+    size_t size;
+    size_t pos;
+    bool failed;
+};
+
+}
+
+ChannelCacheReader::ChannelCacheReader()
+    : sourceSize(0)
+    , sourceModified(0)
+    , numThreads(0)
+{
+}
+
+ChannelCacheReader::~ChannelCacheReader() {
+}
+
+bool ChannelCacheReader::open(const std::string& path) {
+    close();
+    lastError.clear();
+
+    auto mapping = std::make_shared<MappedFile>();
+    if (!mapping->open(path)) {
+        lastError = "Failed to map " + path + ": " + mapping->getLastError();
+        return false;
+    }
+    file = mapping;
+
+    if (!parseIndex()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ChannelCacheReader::close() {
+    file.reset();
+    channels.clear();
+    sourceSize = 0;
+    sourceModified = 0;
+}
+
+bool ChannelCacheReader::matchesSource(uint64_t size, int64_t modified) const {
+    return file && size == sourceSize && modified == sourceModified;
+}
+
+bool ChannelCacheReader::parseIndex() {
+    const char* data = file->data();
+    const size_t size = file->size();
+
+    if (size < headerSize + footerSize || std::memcmp(data, "ACQC", 4) != 0 ||
+        std::memcmp(data + size - 8, "ACQC", 4) != 0) {
+        lastError = "Not a channel cache file";
+        return false;
+    }
+
+    IndexReader header(data, headerSize);
+    header.read<uint32_t>();  // Magic
+    uint32_t version = header.read<uint32_t>();
+    sourceSize = header.read<uint64_t>();
+    sourceModified = header.read<int64_t>();
+    if (version != ChannelCacheWriter::VERSION) {
+        lastError = "Unsupported cache version " + std::to_string(version);
+        return false;
+    }
+
+    uint64_t indexOffset;
+    uint32_t indexCrc;
+    std::memcpy(&indexOffset, data + size - footerSize, sizeof(indexOffset));
+    std::memcpy(&indexCrc, data + size - footerSize + sizeof(indexOffset), sizeof(indexCrc));
+    if (indexOffset < headerSize || indexOffset > size - footerSize) {
+        lastError = "Corrupt cache footer";
+        return false;
+    }
+    if (ArrayFileWriter::crc32(0, data + indexOffset, size - footerSize - indexOffset) != indexCrc) {
+        lastError = "Cache index checksum mismatch";
+        return false;
+    }
+
+    IndexReader index(data + indexOffset, size - footerSize - indexOffset);
+    uint32_t numChannels = index.read<uint32_t>();
+    for (uint32_t c = 0; c < numChannels && index.ok(); ++c) {
+        Channel channel;
+        channel.name = index.readString();
+        channel.units = index.readString();
+        channel.sampleRate = index.read<float>();
+        channel.numSamples = index.read<uint64_t>();
+        channel.blockSamples = index.read<uint32_t>();
+        channel.grid.offset = index.read<double>();
+        channel.grid.step = index.read<double>();
+        if (!index.ok() || channel.blockSamples == 0 || !(channel.sampleRate > 0.0f)) {
+            break;
+        }
+
+        const uint64_t numBlocks = (channel.numSamples + channel.blockSamples - 1) / channel.blockSamples;
+        if (!index.remaining(numBlocks * blockEntrySize)) {
+            lastError = "Corrupt cache index";
+            return false;
+        }
+        channel.blocks.resize(numBlocks);
+        for (auto& block : channel.blocks) {
+            block.offset = index.read<uint64_t>();
+            block.size = index.read<uint32_t>();
+            block.crc = index.read<uint32_t>();
+            block.info.mode = index.read<uint8_t>();
+            block.info.riceParameter = index.read<uint8_t>();
+            block.info.min = index.read<float>();
+            block.info.max = index.read<float>();
+            if (block.offset < headerSize || block.offset + block.size > indexOffset) {
+                lastError = "Cache block outside the data section";
+                return false;
+            }
+        }
+        channels.push_back(std::move(channel));
+    }
+
+    if (!index.ok() || channels.size() != numChannels) {
+        lastError = "Corrupt cache index";
+        return false;
+    }
+    return true;
+}
+
+bool ChannelCacheReader::decodeBlock(size_t channel, size_t block, float* out) const {
+    if (!file || channel >= channels.size() || block >= channels[channel].blocks.size()) {
+        return false;
+    }
+
+    const Channel& info = channels[channel];
+    const Block& entry = info.blocks[block];
+    const uint8_t* payload = reinterpret_cast<const uint8_t*>(file->data() + entry.offset);
+    if (ArrayFileWriter::crc32(0, payload, entry.size) != entry.crc) {
+        return false;
+    }
+
+    const uint64_t start = static_cast<uint64_t>(block) * info.blockSamples;
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(info.blockSamples, info.numSamples - start));
+    return BlockCodec::decode(payload, entry.size, entry.info, info.grid, count, out);
+}
+
+std::shared_ptr<ACQFileMetadata> ChannelCacheReader::readFile(const std::string& path, uint64_t expectedSize,
+                                                              int64_t expectedModified) {
+    if (!open(path)) {
+        return nullptr;
+    }
+    if (!matchesSource(expectedSize, expectedModified)) {
+        lastError = "Cache is out of date";
+        close();
+        return nullptr;
+    }
+
+    auto fileMetadata = std::make_shared<ACQFileMetadata>();
+    unsigned threads = numThreads > 0 ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t c = 0; c < channels.size(); ++c) {
+        const Channel& info = channels[c];
+        std::vector<float> samples(info.numSamples);
+
+        // Blocks are independent: hand them out to all cores
+        std::atomic<size_t> next(0);
+        std::atomic<bool> corrupt(false);
+        auto work = [&]() {
+            for (size_t b = next++; b < info.blocks.size(); b = next++) {
+                if (!decodeBlock(c, b, samples.data() + b * info.blockSamples)) {
+                    corrupt = true;
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < std::min<size_t>(threads, info.blocks.size()); ++t) {
+            pool.emplace_back(work);
+        }
+        work();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+
+        if (corrupt) {
+            lastError = "Corrupt block in channel " + info.name;
+            close();
+            return nullptr;
+        }
+
+        // Same kernel as ACQReader, so a cache hit reports the same statistics
+        DataAnalyzer::Moments moments = DataAnalyzer::computeMoments(samples);
+
+        auto channel = std::make_shared<ChannelData>();
+        channel->setIndex(static_cast<int>(c));
+        channel->setName(info.name);
+        channel->setUnits(info.units);
+        channel->setSampleRate(info.sampleRate);
+        channel->setDuration(static_cast<float>(static_cast<double>(info.numSamples) / info.sampleRate));
+        channel->setStatistics(static_cast<float>(moments.min), static_cast<float>(moments.max),
+                               static_cast<float>(moments.mean), static_cast<float>(moments.stdDev()));
+        channel->setData(std::move(samples));
+        if (info.grid.step != 0.0) {
+            channel->setAdcScale(static_cast<float>(info.grid.step), static_cast<float>(info.grid.offset));
+        }
+
+        fileMetadata->addChannel(channel);
+    }
+
+    fileMetadata->setNumChannels(static_cast<int>(channels.size()));
+
+    std::cout << "ChannelCacheReader: loaded " << channels.size() << " channels from " << path << std::endl;
+    close();
+    return fileMetadata;
+}
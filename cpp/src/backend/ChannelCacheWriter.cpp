@@ -0,0 +1,182 @@
+#include "ChannelCacheWriter.h"
+#include "ArrayFileWriter.h"
+#include "BlockCodec.h"
+#include "BufferedWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Temporary file name no other process or concurrent write can pick
+std::string uniqueTempPath(const std::string& path) {
+    static std::atomic<unsigned> counter(0);
+#ifdef _WIN32
+    const long pid = static_cast<long>(_getpid());
+#else
+    const long pid = static_cast<long>(getpid());
+#endif
+    return path + "." + std::to_string(pid) + "-" + std::to_string(counter++) + ".tmp";
+}
+
+// Little-endian fixed-width field
+template <typename T>
+void append(std::string& out, T value) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+void appendString(std::string& out, const std::string& text) {
+    uint16_t length = static_cast<uint16_t>(std::min<size_t>(text.size(), 0xFFFF));
+    append(out, length);
+    out.append(text, 0, length);
+}
+
+}
+
+ChannelCacheWriter::ChannelCacheWriter()
+    : sourceSize(0)
+    , sourceModified(0)
+    , numThreads(0)
+    , bytesWritten(0)
+{
+}
+
+ChannelCacheWriter::~ChannelCacheWriter() {
+}
+
+void ChannelCacheWriter::setSource(uint64_t size, int64_t modified) {
+    sourceSize = size;
+    sourceModified = modified;
+}
+
+void ChannelCacheWriter::addChannel(std::shared_ptr<ChannelData> channel) {
+    if (channel && channel->getBuffer()) {
+        channels.push_back(std::move(channel));
+    }
+}
+
+void ChannelCacheWriter::addChannels(const ACQFileMetadata& file) {
+    for (const auto& channel : file.getChannels()) {
+        addChannel(channel);
+    }
+}
+
+bool ChannelCacheWriter::writeFile(const std::string& path) {
+    lastError.clear();
+    bytesWritten = 0;
+
+    if (channels.empty()) {
+        lastError = "No channel data to cache";
+        return false;
+    }
+
+    const std::string tempPath = uniqueTempPath(path);
+    BufferedWriter out;
+    if (!out.open(tempPath)) {
+        lastError = out.getLastError();
+        return false;
+    }
+
+    std::string header("ACQC");
+    append(header, VERSION);
+    append(header, sourceSize);
+    append(header, sourceModified);
+    out.write(header);
+
+    unsigned threads = numThreads > 0 ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+
+    std::string index;
+    append(index, static_cast<uint32_t>(channels.size()));
+
+    std::vector<std::vector<uint8_t>> encoded(BATCH_BLOCKS);
+    std::vector<BlockCodec::BlockInfo> infos(BATCH_BLOCKS);
+    std::vector<uint32_t> crcs(BATCH_BLOCKS);
+
+    for (const auto& channel : channels) {
+        SampleView samples = channel->getData();
+        const size_t numBlocks = (samples.size() + BLOCK_SAMPLES - 1) / BLOCK_SAMPLES;
+        const BlockCodec::Grid grid = channel->hasAdcScale()
+            ? BlockCodec::adcGrid(channel->getAdcScale(), channel->getAdcOffset())
+            : BlockCodec::Grid{0.0, 0.0};
+
+        appendString(index, channel->getName());
+        appendString(index, channel->getUnits());
+        append(index, channel->getSampleRate());
+        append(index, static_cast<uint64_t>(samples.size()));
+        append(index, static_cast<uint32_t>(BLOCK_SAMPLES));
+        append(index, grid.offset);
+        append(index, grid.step);
+
+        // Encode a batch of blocks on all cores, then write it in order
+        for (size_t first = 0; first < numBlocks && out.good(); first += BATCH_BLOCKS) {
+            const size_t batch = std::min(BATCH_BLOCKS, numBlocks - first);
+            std::atomic<size_t> next(0);
+            auto work = [&]() {
+                for (size_t b = next++; b < batch; b = next++) {
+                    size_t start = (first + b) * BLOCK_SAMPLES;
+                    size_t count = std::min(BLOCK_SAMPLES, samples.size() - start);
+                    encoded[b].clear();
+                    infos[b] = BlockCodec::encode(samples.data() + start, count, grid, encoded[b]);
+                    crcs[b] = ArrayFileWriter::crc32(0, encoded[b].data(), encoded[b].size());
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < std::min<size_t>(threads, batch); ++t) {
+                pool.emplace_back(work);
+            }
+            work();
+            for (auto& thread : pool) {
+                thread.join();
+            }
+
+            for (size_t b = 0; b < batch; ++b) {
+                const BlockCodec::BlockInfo& info = infos[b];
+                append(index, out.getBytesWritten());
+                append(index, static_cast<uint32_t>(encoded[b].size()));
+                append(index, crcs[b]);
+                append(index, info.mode);
+                append(index, info.riceParameter);
+                append(index, info.min);
+                append(index, info.max);
+                out.write(reinterpret_cast<const char*>(encoded[b].data()), encoded[b].size());
+            }
+        }
+    }
+
+    const uint64_t indexOffset = out.getBytesWritten();
+    out.write(index);
+
+    std::string footer;
+    append(footer, indexOffset);
+    append(footer, ArrayFileWriter::crc32(0, index.data(), index.size()));
+    footer += "ACQC";
+    append(footer, VERSION);
+    out.write(footer);
+
+    bytesWritten = out.getBytesWritten();
+    if (!out.close()) {
+        lastError = out.getLastError();
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // Replace an older cache only once the new one is complete
+    std::remove(path.c_str());
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        lastError = "Failed to rename " + tempPath + " to " + path;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,298 @@
+#include "CsvExporter.h"
+#include "BufferedWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// Quote a field only when it needs it (RFC 4180)
+std::string csvField(const std::string& text) {
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        return text;
+    }
+
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+// Chunks formatted ahead of the writer, per worker thread
+const size_t slotsPerThread = 2;
+
+// Time with 6 decimals from integer microseconds; several times faster than
+// to_chars(double, fixed) and identical for any realistic recording length
+char* formatTime(char* p, char* last, double seconds) {
+    uint64_t micros = static_cast<uint64_t>(std::llround(seconds * 1e6));
+    p = std::to_chars(p, last, micros / 1000000).ptr;
+    *p++ = '.';
+
+    uint64_t fraction = micros % 1000000;
+    for (int digit = 5; digit >= 0; --digit) {
+        p[digit] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    return p + 6;
+}
+
+}
+
+CsvExporter::CsvExporter()
+    : timeHeader("Time (s)")
+    , numThreads(0)
+    , rowsWritten(0)
+{
+}
+
+CsvExporter::~CsvExporter() {
+}
+
+void CsvExporter::addColumn(const std::string& columnHeader, SampleBuffer::Ptr buffer, double sampleRate) {
+    columns.push_back({columnHeader, std::move(buffer), sampleRate, 1});
+}
+
+void CsvExporter::addRange(size_t start, size_t end, const std::string& label) {
+    ranges.push_back({start, end, label});
+}
+
+double CsvExporter::getRowRate() const {
+    double rate = 0.0;
+    for (const auto& column : columns) {
+        rate = std::max(rate, column.sampleRate);
+    }
+    return rate;
+}
+
+size_t CsvExporter::getNumRows() const {
+    const double rate = getRowRate();
+    size_t rows = 0;
+    for (const auto& column : columns) {
+        size_t divider = column.sampleRate > 0.0
+            ? static_cast<size_t>(std::max(1.0, std::round(rate / column.sampleRate))) : 1;
+        size_t size = column.buffer ? column.buffer->size() : 0;
+        rows = std::max(rows, size * divider);
+    }
+    return rows;
+}
+
+void CsvExporter::Text::reserve(size_t bytes) {
+    if (bytes > capacity) {
+        data.reset(new char[bytes]);
+        capacity = bytes;
+    }
+    size = 0;
+}
+
+std::string CsvExporter::header(bool withLabels) const {
+    std::string text = csvField(timeHeader);
+    for (const auto& column : columns) {
+        text += ',';
+        text += csvField(column.header);
+    }
+    if (withLabels) {
+        text += ",Label";
+    }
+    text += '\n';
+    return text;
+}
+
+size_t CsvExporter::maxRowChars(size_t labelSize, bool withLabels) const {
+    return BufferedWriter::MAX_NUMBER_CHARS * (columns.size() + 1) +
+           (withLabels ? labelSize + 1 : 0) + 1;
+}
+
+void CsvExporter::formatChunk(const Chunk& chunk, double rate, const std::string& label,
+                              bool withLabels, Text& out) const {
+    out.reserve((chunk.end - chunk.start) * maxRowChars(label.size(), withLabels));
+
+    char* p = out.data.get();
+    char* const last = p + out.capacity;
+
+    for (size_t row = chunk.start; row < chunk.end; ++row) {
+        p = formatTime(p, last, static_cast<double>(row) / rate);
+
+        for (const auto& column : columns) {
+            *p++ = ',';
+            size_t index = row / column.divider;
+            if (index < column.buffer->size()) {
+                p = std::to_chars(p, last, column.buffer->data()[index]).ptr;
+            }
+        }
+
+        if (withLabels) {
+            *p++ = ',';
+            std::copy(label.begin(), label.end(), p);
+            p += label.size();
+        }
+        *p++ = '\n';
+    }
+
+    out.size = static_cast<size_t>(p - out.data.get());
+}
+
+bool CsvExporter::exportToFile(const std::string& path) {
+    rowsWritten = 0;
+    lastError.clear();
+
+    columns.erase(std::remove_if(columns.begin(), columns.end(),
+                                 [](const Column& column) { return !column.buffer; }),
+                  columns.end());
+    if (columns.empty()) {
+        lastError = "No channel data to export";
+        return false;
+    }
+
+    double rate = getRowRate();
+    if (rate <= 0.0) {
+        lastError = "Invalid sample rate";
+        return false;
+    }
+    for (auto& column : columns) {
+        column.divider = column.sampleRate > 0.0
+            ? static_cast<size_t>(std::max(1.0, std::round(rate / column.sampleRate))) : 1;
+    }
+
+    // Whole recording unless ranges were given; ranges are clamped to it
+    const size_t numRows = getNumRows();
+    std::vector<Range> selected;
+    if (ranges.empty()) {
+        selected.push_back({0, numRows, std::string()});
+    } else {
+        for (const auto& range : ranges) {
+            size_t end = std::min(range.end, numRows);
+            if (range.start < end) {
+                selected.push_back({range.start, end, csvField(range.label)});
+            }
+        }
+    }
+
+    bool withLabels = std::any_of(selected.begin(), selected.end(),
+                                  [](const Range& range) { return !range.label.empty(); });
+
+    // Rows per chunk so that even the longest label's rows fit CHUNK_BYTES
+    size_t longestLabel = 0;
+    for (const auto& range : selected) {
+        longestLabel = std::max(longestLabel, range.label.size());
+    }
+    const size_t chunkRows = std::max<size_t>(1, CHUNK_BYTES / maxRowChars(longestLabel, withLabels));
+
+    std::vector<Chunk> chunks;
+    for (size_t r = 0; r < selected.size(); ++r) {
+        for (size_t start = selected[r].start; start < selected[r].end; start += chunkRows) {
+            chunks.push_back({r, start, std::min(start + chunkRows, selected[r].end)});
+        }
+    }
+
+    BufferedWriter out;
+    if (!out.open(path)) {
+        lastError = out.getLastError();
+        return false;
+    }
+    out.write(header(withLabels));
+
+    unsigned threads = numThreads > 0 ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, chunks.size())));
+
+    if (threads == 1) {
+        Text text;
+        for (const auto& chunk : chunks) {
+            formatChunk(chunk, rate, selected[chunk.range].label, withLabels, text);
+            out.write(text.data.get(), text.size);
+            rowsWritten += chunk.end - chunk.start;
+        }
+    } else {
+        // Ring of formatted chunks: chunk k goes to slot k % numSlots once
+        // the writer has drained chunk k - numSlots from it
+        struct Slot {
+            Text text;
+            size_t chunk;
+            bool ready;
+        };
+        const size_t numSlots = threads * slotsPerThread;
+        std::vector<Slot> slots(numSlots);
+        for (size_t s = 0; s < numSlots; ++s) {
+            slots[s].chunk = s;
+            slots[s].ready = false;
+        }
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::atomic<size_t> nextChunk(0);
+        bool abort = false;
+
+        auto worker = [&]() {
+            Text text;
+            for (;;) {
+                size_t k = nextChunk.fetch_add(1);
+                if (k >= chunks.size()) {
+                    return;
+                }
+
+                const Chunk& chunk = chunks[k];
+                formatChunk(chunk, rate, selected[chunk.range].label, withLabels, text);
+
+                Slot& slot = slots[k % numSlots];
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return abort || slot.chunk == k; });
+                if (abort) {
+                    return;
+                }
+                std::swap(slot.text, text);  // Reuse the drained buffer next time
+                slot.ready = true;
+                lock.unlock();
+                changed.notify_all();
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t) {
+            pool.emplace_back(worker);
+        }
+
+        for (size_t k = 0; k < chunks.size(); ++k) {
+            Slot& slot = slots[k % numSlots];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return slot.ready; });
+            }
+
+            // The slot is ours until it is handed back below
+            out.write(slot.text.data.get(), slot.text.size);
+            rowsWritten += chunks[k].end - chunks[k].start;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.ready = false;
+                slot.chunk = k + numSlots;
+                abort = !out.good();
+            }
+            changed.notify_all();
+
+            if (!out.good()) {
+                break;
+            }
+        }
+
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    if (!out.close()) {
+        lastError = out.getLastError();
+        return false;
+    }
+    return true;
+}
@@ -2,12 +2,24 @@
 #include <cmath>
 #include <algorithm>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DSP_HAS_X86_SIMD 1
+#include <immintrin.h>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-DSPFilters::DSPFilters() {
+DSPFilters::DSPFilters()
+    : numThreads(0)
+    , parallelMode(PARALLEL_EXACT)
+{
 }
 
 DSPFilters::~DSPFilters() {
@@ -40,216 +52,1007 @@ bool DSPFilters::validateParameters(float sampleRate, float freq1, float freq2)
     return true;
 }
 
-std::vector<float> DSPFilters::lowpass(const std::vector<float>& data,
+std::vector<float> DSPFilters::lowpass(SampleView data,
                                        float sampleRate,
                                        float cutoffFreq,
-                                       int order) {
-    return applyFilter(data, sampleRate, LOWPASS, cutoffFreq, 0.0f, order);
+                                       int order,
+                                       bool zeroPhase) {
+    return applyFilter(data, sampleRate, LOWPASS, cutoffFreq, 0.0f, order, zeroPhase);
 }
 
-std::vector<float> DSPFilters::highpass(const std::vector<float>& data,
+std::vector<float> DSPFilters::highpass(SampleView data,
                                         float sampleRate,
                                         float cutoffFreq,
-                                        int order) {
-    return applyFilter(data, sampleRate, HIGHPASS, cutoffFreq, 0.0f, order);
+                                        int order,
+                                        bool zeroPhase) {
+    return applyFilter(data, sampleRate, HIGHPASS, cutoffFreq, 0.0f, order, zeroPhase);
 }
 
-std::vector<float> DSPFilters::bandpass(const std::vector<float>& data,
+std::vector<float> DSPFilters::bandpass(SampleView data,
                                         float sampleRate,
                                         float lowCutoff,
                                         float highCutoff,
-                                        int order) {
-    return applyFilter(data, sampleRate, BANDPASS, lowCutoff, highCutoff, order);
+                                        int order,
+                                        bool zeroPhase) {
+    return applyFilter(data, sampleRate, BANDPASS, lowCutoff, highCutoff, order, zeroPhase);
 }
 
-std::vector<float> DSPFilters::notch(const std::vector<float>& data,
+std::vector<float> DSPFilters::notch(SampleView data,
                                      float sampleRate,
                                      float lowCutoff,
                                      float highCutoff,
-                                     int order) {
-    return applyFilter(data, sampleRate, NOTCH, lowCutoff, highCutoff, order);
+                                     int order,
+                                     bool zeroPhase) {
+    return applyFilter(data, sampleRate, NOTCH, lowCutoff, highCutoff, order, zeroPhase);
+}
+
+std::vector<float> DSPFilters::narrowNotch(SampleView data,
+                                           float sampleRate,
+                                           float notchFreq,
+                                           float q,
+                                           bool zeroPhase) {
+    return applyFilter(data, sampleRate, NARROW_NOTCH, notchFreq, q, 4, zeroPhase);
 }
 
-std::vector<float> DSPFilters::applyFilter(const std::vector<float>& data,
+std::vector<float> DSPFilters::applyFilter(SampleView data,
                                            float sampleRate,
                                            FilterType type,
                                            float freq1,
                                            float freq2,
-                                           int order) {
-    if (data.empty()) {
+                                           int order,
+                                           bool zeroPhase) {
+    if (!validateFilter(data.size(), type, sampleRate, freq1, freq2, order)) {
+        return data.toVector();
+    }
+
+    std::vector<float> result = data.toVector();
+    if (!runFilter(result.data(), result.size(), sampleRate, type, freq1, freq2, order, zeroPhase)) {
+        return data.toVector();
+    }
+    return result;
+}
+
+bool DSPFilters::applyFilterInPlace(float* data,
+                                    size_t size,
+                                    float sampleRate,
+                                    FilterType type,
+                                    float freq1,
+                                    float freq2,
+                                    int order,
+                                    bool zeroPhase) {
+    if (!validateFilter(size, type, sampleRate, freq1, freq2, order)) {
+        return false;
+    }
+
+    return runFilter(data, size, sampleRate, type, freq1, freq2, order, zeroPhase);
+}
+
+bool DSPFilters::applyFilterMultiChannel(const std::vector<float*>& channels,
+                                         size_t size,
+                                         float sampleRate,
+                                         FilterType type,
+                                         float freq1,
+                                         float freq2,
+                                         int order) {
+    if (channels.empty()) {
+        lastError = "No channels to filter";
+        return false;
+    }
+
+    if (!validateFilter(size, type, sampleRate, freq1, freq2, order)) {
+        return false;
+    }
+
+    auto sections = getCachedSections(type, sampleRate, freq1, freq2, order);
+    processCascadeMultiChannel(channels.data(), channels.size(), size,
+                               sections->data(), sections->size());
+    return true;
+}
+
+bool DSPFilters::validateFilter(size_t size, FilterType type, float sampleRate, float freq1, float freq2, int order) {
+    lastError.clear();
+
+    if (size == 0) {
         lastError = "Input data is empty";
-        return data;
+        return false;
+    }
+
+    if (type == NARROW_NOTCH) {
+        if (freq2 <= 0) {
+            lastError = "Notch quality factor must be positive";
+            return false;
+        }
+        return validateParameters(sampleRate, freq1);
     }
 
-    if (order <= 0 || order > 8) {
-        lastError = "Filter order must be between 1 and 8";
-        return data;
+    if (order <= 0 || order > MAX_ORDER) {
+        lastError = "Filter order must be between 1 and " + std::to_string(MAX_ORDER);
+        return false;
+    }
+
+    // Band types need both edges; freq2 = 0 would design NaN sections
+    if ((type == BANDPASS || type == NOTCH) && !(freq2 > freq1)) {
+        lastError = "High cutoff must be greater than low cutoff";
+        std::cerr << "Filter validation error: " << lastError << std::endl;
+        return false;
     }
 
     // Validate parameters
     if (!validateParameters(sampleRate, freq1, freq2)) {
         std::cerr << "Filter validation error: " << lastError << std::endl;
-        return data;
+        return false;
     }
 
-    // For bandpass and notch, use cascaded filters
-    if (type == BANDPASS) {
-        // Bandpass = Highpass(lowCutoff) -> Lowpass(highCutoff)
-        auto temp = highpass(data, sampleRate, freq1, order);
-        return lowpass(temp, sampleRate, freq2, order);
-    } else if (type == NOTCH) {
-        // Notch = Input - Bandpass
-        auto bandpassed = bandpass(data, sampleRate, freq1, freq2, order);
-        std::vector<float> result(data.size());
-        for (size_t i = 0; i < data.size(); ++i) {
-            result[i] = data[i] - bandpassed[i];
+    return true;
+}
+
+bool DSPFilters::runFilter(float* data,
+                           size_t size,
+                           float sampleRate,
+                           FilterType type,
+                           float freq1,
+                           float freq2,
+                           int order,
+                           bool zeroPhase) {
+    // Design (or reuse) biquad sections
+    auto sections = getCachedSections(type, sampleRate, freq1, freq2, order);
+
+    bool completed;
+    if (zeroPhase) {
+        completed = runZeroPhase(data, size, sections->data(), sections->size());
+    } else {
+        // Apply cascaded biquads, starting from rest
+        std::vector<double> state(2 * sections->size(), 0.0);
+        completed = runCascade(data, size, sections->data(), sections->size(), state.data(), 0.0, 1.0);
+    }
+
+    if (!completed) {
+        lastError = "Filter cancelled";
+    }
+    return completed;
+}
+
+std::vector<DSPFilters::ButterworthCoeffs> DSPFilters::getSections(FilterType type,
+                                                                    float sampleRate,
+                                                                    float freq1,
+                                                                    float freq2,
+                                                                    int order) {
+    return *getCachedSections(type, sampleRate, freq1, freq2, order);
+}
+
+void DSPFilters::processCascade(float* data,
+                                size_t size,
+                                const ButterworthCoeffs* sections,
+                                size_t numSections,
+                                double* state) {
+    // 4096 floats = 16 KB, small enough to stay in L1 across all sections
+    const size_t blockSize = 4096;
+
+    for (size_t start = 0; start < size; start += blockSize) {
+        float* block = data + start;
+        size_t length = std::min(blockSize, size - start);
+
+        for (size_t s = 0; s < numSections; ++s) {
+            const double b0 = sections[s].b0;
+            const double b1 = sections[s].b1;
+            const double b2 = sections[s].b2;
+            const double a1 = sections[s].a1;
+            const double a2 = sections[s].a2;
+            double z1 = state[2 * s];
+            double z2 = state[2 * s + 1];
+
+            // Direct Form II Transposed
+            for (size_t n = 0; n < length; ++n) {
+                double x = block[n];
+                double y = b0 * x + z1;
+                z1 = b1 * x - a1 * y + z2;
+                z2 = b2 * x - a2 * y;
+                block[n] = static_cast<float>(y);
+            }
+
+            state[2 * s] = z1;
+            state[2 * s + 1] = z2;
         }
-        return result;
     }
+}
+
+void DSPFilters::steadyState(const ButterworthCoeffs* sections,
+                             size_t numSections,
+                             double* zi) {
+    // Each section settles to its DC gain; later sections see the product
+    // of the gains before them as their constant input
+    double scale = 1.0;
 
-    // Design biquad sections
-    auto sections = designBiquadSections(type, sampleRate, freq1, freq2, order);
+    for (size_t s = 0; s < numSections; ++s) {
+        const ButterworthCoeffs& c = sections[s];
+        double gain = (c.b0 + c.b1 + c.b2) / (1.0 + c.a1 + c.a2);
 
-    // Apply cascaded biquads
-    return applyCascadedBiquads(data, sections);
+        // DF-II-T state with x = 1 and y = gain held constant
+        double z2 = c.b2 - c.a2 * gain;
+        double z1 = c.b1 - c.a1 * gain + z2;
+
+        zi[2 * s] = scale * z1;
+        zi[2 * s + 1] = scale * z2;
+        scale *= gain;
+    }
 }
 
-float DSPFilters::prewarpFrequency(float freq, float sampleRate) {
-    return std::tan(M_PI * freq / sampleRate);
+bool DSPFilters::runZeroPhase(float* data,
+                              size_t size,
+                              const ButterworthCoeffs* sections,
+                              size_t numSections) const {
+    // Pad length as in scipy's sosfiltfilt: 3 x the number of filter taps
+    size_t zeroB2 = 0;
+    size_t zeroA2 = 0;
+    for (size_t s = 0; s < numSections; ++s) {
+        zeroB2 += sections[s].b2 == 0.0 ? 1 : 0;
+        zeroA2 += sections[s].a2 == 0.0 ? 1 : 0;
+    }
+    size_t taps = 2 * numSections + 1 - std::min(zeroB2, zeroA2);
+    size_t padLength = std::min(3 * taps, size - 1);
+
+    // Odd reflection about the end samples, taken before the data changes
+    std::vector<float> head(padLength);
+    std::vector<float> tail(padLength);
+    const float first = data[0];
+    const float last = data[size - 1];
+    for (size_t k = 0; k < padLength; ++k) {
+        head[k] = 2.0f * first - data[padLength - k];
+        tail[k] = 2.0f * last - data[size - 2 - k];
+    }
+
+    std::vector<double> zi(2 * numSections);
+    std::vector<double> state(2 * numSections);
+    steadyState(sections, numSections, zi.data());
+
+    // Forward pass over head, data, tail as one stream
+    double x0 = padLength > 0 ? head[0] : first;
+    for (size_t i = 0; i < state.size(); ++i) {
+        state[i] = zi[i] * x0;
+    }
+    processCascade(head.data(), head.size(), sections, numSections, state.data());
+    if (!runCascade(data, size, sections, numSections, state.data(), 0.0, 0.5)) {
+        return false;
+    }
+    processCascade(tail.data(), tail.size(), sections, numSections, state.data());
+
+    // Backward pass: reverse in place so the same kernel runs over
+    // tail then data; the head's backward output would be discarded
+    std::reverse(tail.begin(), tail.end());
+    double y0 = padLength > 0 ? tail[0] : data[size - 1];
+    for (size_t i = 0; i < state.size(); ++i) {
+        state[i] = zi[i] * y0;
+    }
+    processCascade(tail.data(), tail.size(), sections, numSections, state.data());
+
+    std::reverse(data, data + size);
+    if (!runCascade(data, size, sections, numSections, state.data(), 0.5, 1.0)) {
+        return false;
+    }
+    std::reverse(data, data + size);
+    return true;
 }
 
-DSPFilters::ButterworthCoeffs DSPFilters::designLowpass(float sampleRate,
-                                                         float cutoffFreq,
-                                                         int order) {
-    ButterworthCoeffs coeffs;
+namespace {
 
-    // Prewarp cutoff frequency
-    float omega = prewarpFrequency(cutoffFreq, sampleRate);
+using Coeffs = DSPFilters::ButterworthCoeffs;
 
-    // For simplicity, implement 2nd order lowpass (biquad)
-    // Can be cascaded for higher orders
-    float omega2 = omega * omega;
-    float sqrt2omega = std::sqrt(2.0f) * omega;
+// Samples per interleaved block; 1024 x 4 lanes x 4 bytes = 16 KB
+const size_t laneBlockSize = 1024;
 
-    float a0 = 1.0f + sqrt2omega + omega2;
-    float a1 = 2.0f * (omega2 - 1.0f);
-    float a2 = 1.0f - sqrt2omega + omega2;
+enum class SimdLevel { Scalar, SSE2, AVX };
 
-    float b0 = omega2;
-    float b1 = 2.0f * omega2;
-    float b2 = omega2;
+SimdLevel detectSimdLevel() {
+#ifdef DSP_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+        return SimdLevel::AVX;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel simdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+#ifdef DSP_HAS_X86_SIMD
 
-    // Normalize by a0
-    coeffs.b = {b0 / a0, b1 / a0, b2 / a0};
-    coeffs.a = {1.0f, a1 / a0, a2 / a0};
+/**
+ * @brief Cascade over 2 channels, one per double lane of an SSE2 register
+ */
+__attribute__((target("sse2")))
+void cascadeLanesSSE2(float* const* channels, size_t size,
+                      const Coeffs* sections, size_t numSections) {
+    alignas(16) float block[laneBlockSize * 2];
+    __m128d z1[DSPFilters::MAX_ORDER];
+    __m128d z2[DSPFilters::MAX_ORDER];
+    for (size_t s = 0; s < numSections; ++s) {
+        z1[s] = _mm_setzero_pd();
+        z2[s] = _mm_setzero_pd();
+    }
+
+    for (size_t start = 0; start < size; start += laneBlockSize) {
+        size_t length = std::min(laneBlockSize, size - start);
+
+        // Interleave: block[2n + lane]
+        for (size_t n = 0; n < length; ++n) {
+            block[2 * n] = channels[0][start + n];
+            block[2 * n + 1] = channels[1][start + n];
+        }
 
-    return coeffs;
+        for (size_t s = 0; s < numSections; ++s) {
+            const __m128d b0 = _mm_set1_pd(sections[s].b0);
+            const __m128d b1 = _mm_set1_pd(sections[s].b1);
+            const __m128d b2 = _mm_set1_pd(sections[s].b2);
+            const __m128d a1 = _mm_set1_pd(sections[s].a1);
+            const __m128d a2 = _mm_set1_pd(sections[s].a2);
+            __m128d s1 = z1[s];
+            __m128d s2 = z2[s];
+
+            for (size_t n = 0; n < length; ++n) {
+                __m128i* slot = reinterpret_cast<__m128i*>(block + 2 * n);
+                __m128d x = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(slot)));
+                __m128d y = _mm_add_pd(_mm_mul_pd(b0, x), s1);
+                s1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1, x), _mm_mul_pd(a1, y)), s2);
+                s2 = _mm_sub_pd(_mm_mul_pd(b2, x), _mm_mul_pd(a2, y));
+                _mm_storel_epi64(slot, _mm_castps_si128(_mm_cvtpd_ps(y)));
+            }
+
+            z1[s] = s1;
+            z2[s] = s2;
+        }
+
+        for (size_t n = 0; n < length; ++n) {
+            channels[0][start + n] = block[2 * n];
+            channels[1][start + n] = block[2 * n + 1];
+        }
+    }
 }
 
-DSPFilters::ButterworthCoeffs DSPFilters::designHighpass(float sampleRate,
-                                                          float cutoffFreq,
-                                                          int order) {
-    ButterworthCoeffs coeffs;
+/**
+ * @brief Cascade over 4 channels, one per double lane of an AVX register
+ */
+__attribute__((target("avx")))
+void cascadeLanesAVX(float* const* channels, size_t size,
+                     const Coeffs* sections, size_t numSections) {
+    alignas(32) float block[laneBlockSize * 4];
+    __m256d z1[DSPFilters::MAX_ORDER];
+    __m256d z2[DSPFilters::MAX_ORDER];
+    for (size_t s = 0; s < numSections; ++s) {
+        z1[s] = _mm256_setzero_pd();
+        z2[s] = _mm256_setzero_pd();
+    }
 
-    // Prewarp cutoff frequency
-    float omega = prewarpFrequency(cutoffFreq, sampleRate);
+    for (size_t start = 0; start < size; start += laneBlockSize) {
+        size_t length = std::min(laneBlockSize, size - start);
 
-    // For simplicity, implement 2nd order highpass (biquad)
-    float omega2 = omega * omega;
-    float sqrt2omega = std::sqrt(2.0f) * omega;
+        // Interleave: block[4n + lane]
+        for (size_t n = 0; n < length; ++n) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                block[4 * n + lane] = channels[lane][start + n];
+            }
+        }
 
-    float a0 = 1.0f + sqrt2omega + omega2;
-    float a1 = 2.0f * (omega2 - 1.0f);
-    float a2 = 1.0f - sqrt2omega + omega2;
+        for (size_t s = 0; s < numSections; ++s) {
+            const __m256d b0 = _mm256_set1_pd(sections[s].b0);
+            const __m256d b1 = _mm256_set1_pd(sections[s].b1);
+            const __m256d b2 = _mm256_set1_pd(sections[s].b2);
+            const __m256d a1 = _mm256_set1_pd(sections[s].a1);
+            const __m256d a2 = _mm256_set1_pd(sections[s].a2);
+            __m256d s1 = z1[s];
+            __m256d s2 = z2[s];
 
-    float b0 = 1.0f;
-    float b1 = -2.0f;
-    float b2 = 1.0f;
+            for (size_t n = 0; n < length; ++n) {
+                __m256d x = _mm256_cvtps_pd(_mm_load_ps(block + 4 * n));
+                __m256d y = _mm256_add_pd(_mm256_mul_pd(b0, x), s1);
+                s1 = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(b1, x), _mm256_mul_pd(a1, y)), s2);
+                s2 = _mm256_sub_pd(_mm256_mul_pd(b2, x), _mm256_mul_pd(a2, y));
+                _mm_store_ps(block + 4 * n, _mm256_cvtpd_ps(y));
+            }
 
-    // Normalize by a0
-    coeffs.b = {b0 / a0, b1 / a0, b2 / a0};
-    coeffs.a = {1.0f, a1 / a0, a2 / a0};
+            z1[s] = s1;
+            z2[s] = s2;
+        }
 
-    return coeffs;
+        for (size_t n = 0; n < length; ++n) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                channels[lane][start + n] = block[4 * n + lane];
+            }
+        }
+    }
 }
 
-std::vector<DSPFilters::ButterworthCoeffs> DSPFilters::designBiquadSections(
-    FilterType type,
-    float sampleRate,
-    float freq1,
-    float freq2,
-    int order) {
+#endif // DSP_HAS_X86_SIMD
 
-    std::vector<ButterworthCoeffs> sections;
+} // namespace
 
-    // Number of second-order sections needed
-    int numSections = (order + 1) / 2;
+int DSPFilters::getSimdLaneCount() {
+    switch (simdLevel()) {
+    case SimdLevel::AVX:
+        return 4;
+    case SimdLevel::SSE2:
+        return 2;
+    default:
+        return 1;
+    }
+}
 
-    // Design each biquad section
-    for (int i = 0; i < numSections; ++i) {
-        ButterworthCoeffs coeffs;
+void DSPFilters::processCascadeMultiChannel(float* const* channels,
+                                            size_t numChannels,
+                                            size_t size,
+                                            const ButterworthCoeffs* sections,
+                                            size_t numSections) {
+    size_t c = 0;
 
-        if (type == LOWPASS) {
-            coeffs = designLowpass(sampleRate, freq1, 2);
-        } else if (type == HIGHPASS) {
-            coeffs = designHighpass(sampleRate, freq1, 2);
+#ifdef DSP_HAS_X86_SIMD
+    SimdLevel level = simdLevel();
+
+    if (level == SimdLevel::AVX) {
+        for (; c + 4 <= numChannels; c += 4) {
+            cascadeLanesAVX(channels + c, size, sections, numSections);
+        }
+    }
+    if (level == SimdLevel::AVX || level == SimdLevel::SSE2) {
+        for (; c + 2 <= numChannels; c += 2) {
+            cascadeLanesSSE2(channels + c, size, sections, numSections);
         }
+    }
+#endif
 
-        sections.push_back(coeffs);
+    // Leftover channels (or no SIMD): scalar kernel, one channel at a time
+    std::vector<double> state(2 * numSections);
+    for (; c < numChannels; ++c) {
+        std::fill(state.begin(), state.end(), 0.0);
+        processCascade(channels[c], size, sections, numSections, state.data());
     }
+}
 
-    return sections;
+namespace {
+
+// Chunks shorter than this aren't worth a thread
+const size_t minParallelChunk = size_t(1) << 18;
+
+size_t parallelChunkCount(size_t size, unsigned numThreads) {
+    return std::max<size_t>(1, std::min<size_t>(numThreads, size / minParallelChunk));
+}
+
+// Square state-space matrix, row-major
+using StateMatrix = std::vector<double>;
+
+StateMatrix multiply(const StateMatrix& a, const StateMatrix& b, size_t dim) {
+    StateMatrix result(dim * dim, 0.0);
+    for (size_t i = 0; i < dim; ++i) {
+        for (size_t k = 0; k < dim; ++k) {
+            double aik = a[i * dim + k];
+            for (size_t j = 0; j < dim; ++j) {
+                result[i * dim + j] += aik * b[k * dim + j];
+            }
+        }
+    }
+    return result;
+}
+
+StateMatrix matrixPower(const StateMatrix& base, size_t exponent, size_t dim) {
+    StateMatrix result(dim * dim, 0.0);
+    for (size_t i = 0; i < dim; ++i) {
+        result[i * dim + i] = 1.0;
+    }
+
+    StateMatrix square = base;
+    while (exponent > 0) {
+        if (exponent & 1) {
+            result = multiply(result, square, dim);
+        }
+        exponent >>= 1;
+        if (exponent > 0) {
+            square = multiply(square, square, dim);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Matrix advancing the cascade state by one sample of zero input
+ */
+StateMatrix zeroInputStep(const Coeffs* sections, size_t numSections) {
+    size_t dim = 2 * numSections;
+    StateMatrix step(dim * dim, 0.0);
+
+    // Column j: where unit state j goes in one step
+    for (size_t j = 0; j < dim; ++j) {
+        double u = 0.0;
+        for (size_t s = 0; s < numSections; ++s) {
+            double z1 = (j == 2 * s) ? 1.0 : 0.0;
+            double z2 = (j == 2 * s + 1) ? 1.0 : 0.0;
+            double y = sections[s].b0 * u + z1;
+            step[(2 * s) * dim + j] = sections[s].b1 * u - sections[s].a1 * y + z2;
+            step[(2 * s + 1) * dim + j] = sections[s].b2 * u - sections[s].a2 * y;
+            u = y;
+        }
+    }
+    return step;
 }
 
-std::vector<float> DSPFilters::applyIIR(const std::vector<float>& data,
-                                        const ButterworthCoeffs& coeffs) {
-    if (data.empty()) {
-        return data;
+/**
+ * @brief End state of the cascade run over a chunk from rest, leaving the chunk untouched
+ */
+void zeroStateEnd(const float* data, size_t size,
+                  const Coeffs* sections, size_t numSections, double* state) {
+    const size_t blockSize = 4096;
+    std::vector<float> scratch(blockSize);
+    std::fill(state, state + 2 * numSections, 0.0);
+
+    for (size_t start = 0; start < size; start += blockSize) {
+        size_t length = std::min(blockSize, size - start);
+        std::copy(data + start, data + start + length, scratch.begin());
+        DSPFilters::processCascade(scratch.data(), length, sections, numSections, state);
     }
+}
 
-    std::vector<float> output(data.size(), 0.0f);
+/**
+ * @brief Samples until the cascade's impulse response has decayed below tolerance
+ * @return limit if it takes that long or longer
+ */
+size_t impulseDecayLength(const Coeffs* sections, size_t numSections,
+                          double tolerance, size_t limit) {
+    std::vector<double> z(2 * numSections, 0.0);
 
-    // Direct Form II Transposed implementation
-    std::vector<float> state(coeffs.a.size() - 1, 0.0f);
+    for (size_t n = 0; n < limit; ++n) {
+        double u = n == 0 ? 1.0 : 0.0;
+        double remaining = 0.0;
 
-    for (size_t n = 0; n < data.size(); ++n) {
-        // Compute output
-        float y = coeffs.b[0] * data[n];
+        for (size_t s = 0; s < numSections; ++s) {
+            double y = sections[s].b0 * u + z[2 * s];
+            z[2 * s] = sections[s].b1 * u - sections[s].a1 * y + z[2 * s + 1];
+            z[2 * s + 1] = sections[s].b2 * u - sections[s].a2 * y;
+            u = y;
+            remaining += std::abs(z[2 * s]) + std::abs(z[2 * s + 1]);
+        }
 
-        if (state.size() > 0) {
-            y += state[0];
+        // The state carries everything the response has left to output
+        if (remaining < tolerance) {
+            return n + 1;
         }
+    }
+    return limit;
+}
 
-        output[n] = y;
+} // namespace
 
-        // Update state variables
-        for (size_t i = 0; i < state.size() - 1; ++i) {
-            state[i] = state[i + 1] + coeffs.b[i + 1] * data[n] - coeffs.a[i + 1] * y;
+void DSPFilters::processCascadeParallel(float* data,
+                                        size_t size,
+                                        const ButterworthCoeffs* sections,
+                                        size_t numSections,
+                                        double* state,
+                                        unsigned numThreads) {
+    size_t chunks = parallelChunkCount(size, numThreads);
+    if (chunks < 2 || numSections == 0) {
+        processCascade(data, size, sections, numSections, state);
+        return;
+    }
+
+    const size_t dim = 2 * numSections;
+    const size_t chunkSize = size / chunks;
+    auto chunkLength = [&](size_t k) { return k + 1 < chunks ? chunkSize : size - k * chunkSize; };
+
+    // Pass 1: the first chunk is filtered for real; the others only find the
+    // state they would end in if started from rest
+    std::vector<double> zeroStateEnds(chunks * dim);
+    {
+        std::vector<std::thread> workers;
+        for (size_t k = 1; k < chunks; ++k) {
+            workers.emplace_back([&, k]() {
+                zeroStateEnd(data + k * chunkSize, chunkLength(k), sections, numSections,
+                             &zeroStateEnds[k * dim]);
+            });
+        }
+        processCascade(data, chunkSize, sections, numSections, state);
+        for (auto& worker : workers) {
+            worker.join();
         }
+    }
+
+    // By linearity, a chunk's true end state is its zero-state end state
+    // plus its start state carried through the chunk with zero input
+    StateMatrix step = zeroInputStep(sections, numSections);
+    StateMatrix acrossChunk = matrixPower(step, chunkSize, dim);
+
+    std::vector<double> startStates(chunks * dim);
+    std::copy(state, state + dim, startStates.begin() + dim);
+
+    for (size_t k = 1; k < chunks; ++k) {
+        const StateMatrix& carry = chunkLength(k) == chunkSize
+            ? acrossChunk : matrixPower(step, chunkLength(k), dim);
+        double* next = k + 1 < chunks ? &startStates[(k + 1) * dim] : state;
 
-        if (state.size() > 0) {
-            size_t last = state.size() - 1;
-            state[last] = coeffs.b[last + 1] * data[n] - coeffs.a[last + 1] * y;
+        for (size_t i = 0; i < dim; ++i) {
+            double sum = zeroStateEnds[k * dim + i];
+            for (size_t j = 0; j < dim; ++j) {
+                sum += carry[i * dim + j] * startStates[k * dim + j];
+            }
+            next[i] = sum;
         }
     }
 
-    return output;
+    // Pass 2: filter the remaining chunks in place from their true start states
+    std::vector<std::thread> workers;
+    for (size_t k = 1; k + 1 < chunks; ++k) {
+        workers.emplace_back([&, k]() {
+            processCascade(data + k * chunkSize, chunkSize, sections, numSections,
+                           &startStates[k * dim]);
+        });
+    }
+    size_t last = chunks - 1;
+    processCascade(data + last * chunkSize, chunkLength(last), sections, numSections,
+                   &startStates[last * dim]);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void DSPFilters::processCascadeWarmUp(float* data,
+                                      size_t size,
+                                      const ButterworthCoeffs* sections,
+                                      size_t numSections,
+                                      double* state,
+                                      unsigned numThreads,
+                                      double tolerance) {
+    size_t chunks = parallelChunkCount(size, numThreads);
+    if (chunks < 2 || numSections == 0) {
+        processCascade(data, size, sections, numSections, state);
+        return;
+    }
+
+    const size_t dim = 2 * numSections;
+    const size_t chunkSize = size / chunks;
+    size_t last = chunks - 1;
+
+    // A warm-up as long as the chunk costs as much as the exact method
+    size_t warmUp = impulseDecayLength(sections, numSections, tolerance, chunkSize);
+    if (warmUp >= chunkSize) {
+        processCascadeParallel(data, size, sections, numSections, state, numThreads);
+        return;
+    }
+
+    // Copy each chunk's warm-up prefix before any thread overwrites it
+    std::vector<float> prefixes(last * warmUp);
+    for (size_t k = 1; k < chunks; ++k) {
+        const float* prefix = data + k * chunkSize - warmUp;
+        std::copy(prefix, prefix + warmUp, prefixes.begin() + (k - 1) * warmUp);
+    }
+
+    std::vector<double> zi(dim);
+    steadyState(sections, numSections, zi.data());
+
+    // Chunks 1.. start in steady state at their first prefix sample, which
+    // absorbs DC offsets, and settle on the prefix before their own samples
+    std::vector<double> chunkStates(chunks * dim);
+    std::vector<std::thread> workers;
+    for (size_t k = 1; k < chunks; ++k) {
+        workers.emplace_back([&, k]() {
+            float* prefix = &prefixes[(k - 1) * warmUp];
+            double* local = &chunkStates[k * dim];
+            for (size_t i = 0; i < dim; ++i) {
+                local[i] = zi[i] * prefix[0];
+            }
+            processCascade(prefix, warmUp, sections, numSections, local);
+
+            size_t length = k < last ? chunkSize : size - k * chunkSize;
+            processCascade(data + k * chunkSize, length, sections, numSections, local);
+        });
+    }
+    processCascade(data, chunkSize, sections, numSections, state);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::copy(chunkStates.begin() + last * dim, chunkStates.end(), state);
 }
 
-std::vector<float> DSPFilters::applyCascadedBiquads(
-    const std::vector<float>& data,
-    const std::vector<ButterworthCoeffs>& sections) {
+std::vector<float> DSPFilters::applyFilterRange(SampleView data,
+                                                size_t start,
+                                                size_t end,
+                                                float sampleRate,
+                                                FilterType type,
+                                                float freq1,
+                                                float freq2,
+                                                int order,
+                                                bool zeroPhase,
+                                                size_t maxWarmUp) {
+    end = std::min(end, data.size());
+    if (start >= end) {
+        lastError = "Filter range is empty";
+        return std::vector<float>();
+    }
 
-    if (sections.empty()) {
-        return data;
+    if (!validateFilter(end - start, type, sampleRate, freq1, freq2, order)) {
+        return data.subview(start, end - start).toVector();
     }
 
-    // Apply each section sequentially
-    std::vector<float> result = data;
+    auto sections = getCachedSections(type, sampleRate, freq1, freq2, order);
+    size_t numSections = sections->size();
+    size_t limit = maxWarmUp > 0 ? std::min(maxWarmUp, data.size()) : data.size();
+    size_t warmUp = impulseDecayLength(sections->data(), numSections, WARMUP_TOLERANCE, limit);
 
-    for (const auto& section : sections) {
-        result = applyIIR(result, section);
+    // Margin before the range; zero-phase also settles the backward pass
+    // on a margin after it
+    size_t from = start > warmUp ? start - warmUp : 0;
+    size_t to = zeroPhase ? std::min(data.size(), end + warmUp) : end;
+    std::vector<float> buffer = data.subview(from, to - from).toVector();
+
+    if (zeroPhase) {
+        // Reflected padding applies where the margin reaches the real ends
+        if (!runZeroPhase(buffer.data(), buffer.size(), sections->data(), numSections)) {
+            lastError = "Filter cancelled";
+            return std::vector<float>();
+        }
+    } else {
+        // From rest at the true start of the signal, as the full filter does
+        std::vector<double> state(2 * numSections, 0.0);
+        if (from > 0) {
+            steadyState(sections->data(), numSections, state.data());
+            for (double& value : state) {
+                value *= buffer[0];
+            }
+        }
+        processCascade(buffer.data(), buffer.size(), sections->data(), numSections, state.data());
     }
 
-    return result;
+    return std::vector<float>(buffer.begin() + (start - from), buffer.begin() + (end - from));
+}
+
+size_t DSPFilters::getWarmUpLength(FilterType type,
+                                   float sampleRate,
+                                   float freq1,
+                                   float freq2,
+                                   int order,
+                                   size_t limit) {
+    if (!validateFilter(1, type, sampleRate, freq1, freq2, order)) {
+        return 0;
+    }
+
+    auto sections = getCachedSections(type, sampleRate, freq1, freq2, order);
+    return impulseDecayLength(sections->data(), sections->size(), WARMUP_TOLERANCE, limit);
+}
+
+bool DSPFilters::runCascade(float* data,
+                            size_t size,
+                            const ButterworthCoeffs* sections,
+                            size_t numSections,
+                            double* state,
+                            double progressStart,
+                            double progressEnd) const {
+    unsigned threads = numThreads > 0 ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+
+    // With a progress callback, report (and allow cancelling) about every
+    // 1/PROGRESS_STEPS of the buffer; segments stay long enough to split
+    // across all threads
+    size_t segment = size;
+    if (progressCallback) {
+        segment = std::max(size / PROGRESS_STEPS, minParallelChunk * threads);
+    }
+
+    for (size_t start = 0; start < size; start += segment) {
+        size_t length = std::min(segment, size - start);
+
+        if (parallelMode == PARALLEL_WARMUP) {
+            processCascadeWarmUp(data + start, length, sections, numSections, state, threads, WARMUP_TOLERANCE);
+        } else {
+            processCascadeParallel(data + start, length, sections, numSections, state, threads);
+        }
+
+        if (progressCallback) {
+            double done = static_cast<double>(start + length) / size;
+            if (!progressCallback(progressStart + (progressEnd - progressStart) * done)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+double DSPFilters::prewarpFrequency(double freq, double sampleRate) {
+    return std::tan(M_PI * freq / sampleRate);
+}
+
+std::vector<DSPFilters::ButterworthCoeffs> DSPFilters::designLowpass(double sampleRate,
+                                                                      double cutoffFreq,
+                                                                      int order) {
+    std::vector<ButterworthCoeffs> sections;
+
+    // Prewarp cutoff frequency
+    double K = prewarpFrequency(cutoffFreq, sampleRate);
+    double K2 = K * K;
+
+    // One biquad per conjugate pole pair of the analog prototype
+    for (int k = 0; k < order / 2; ++k) {
+        double theta = M_PI * (2.0 * k + 1.0) / (2.0 * order);
+        double invQ = 2.0 * std::sin(theta);
+        double norm = 1.0 / (1.0 + invQ * K + K2);
+
+        double b0 = K2 * norm;
+        sections.push_back({b0, 2.0 * b0, b0,
+                            2.0 * (K2 - 1.0) * norm, (1.0 - invQ * K + K2) * norm});
+    }
+
+    // Real pole of odd orders
+    if (order % 2 == 1) {
+        double norm = 1.0 / (1.0 + K);
+
+        sections.push_back({K * norm, K * norm, 0.0, (K - 1.0) * norm, 0.0});
+    }
+
+    return sections;
+}
+
+std::vector<DSPFilters::ButterworthCoeffs> DSPFilters::designHighpass(double sampleRate,
+                                                                       double cutoffFreq,
+                                                                       int order) {
+    std::vector<ButterworthCoeffs> sections;
+
+    // Prewarp cutoff frequency
+    double K = prewarpFrequency(cutoffFreq, sampleRate);
+    double K2 = K * K;
+
+    for (int k = 0; k < order / 2; ++k) {
+        double theta = M_PI * (2.0 * k + 1.0) / (2.0 * order);
+        double invQ = 2.0 * std::sin(theta);
+        double norm = 1.0 / (1.0 + invQ * K + K2);
+
+        sections.push_back({norm, -2.0 * norm, norm,
+                            2.0 * (K2 - 1.0) * norm, (1.0 - invQ * K + K2) * norm});
+    }
+
+    if (order % 2 == 1) {
+        double norm = 1.0 / (1.0 + K);
+
+        sections.push_back({norm, -norm, 0.0, (K - 1.0) * norm, 0.0});
+    }
+
+    return sections;
+}
+
+std::vector<DSPFilters::ButterworthCoeffs> DSPFilters::designBand(double sampleRate,
+                                                                   double lowFreq,
+                                                                   double highFreq,
+                                                                   int order,
+                                                                   bool bandstop) {
+    using Complex = std::complex<double>;
+
+    // Prewarped band edges (bilinear transform with s = (z - 1) / (z + 1))
+    double wl = prewarpFrequency(lowFreq, sampleRate);
+    double wh = prewarpFrequency(highFreq, sampleRate);
+    double bw = wh - wl;
+    double w0sq = wl * wh;
+
+    // Map each prototype pole to its two band poles, then to the z-plane
+    std::vector<Complex> poles;
+    for (int k = 0; k < order; ++k) {
+        double theta = M_PI * (2.0 * k + 1.0) / (2.0 * order);
+        Complex p(-std::sin(theta), std::cos(theta));
+
+        Complex base = bandstop ? (bw / 2.0) / p : p * (bw / 2.0);
+        Complex root = std::sqrt(base * base - w0sq);
+
+        for (Complex s : {base + root, base - root}) {
+            poles.push_back((1.0 + s) / (1.0 - s));
+        }
+    }
+
+    // Numerator shared by all sections: zeros at z = +/-1 (bandpass) or
+    // on the unit circle at the centre frequency (band-stop)
+    double cosW0 = (1.0 - w0sq) / (1.0 + w0sq);
+    double b0 = 1.0;
+    double b1 = bandstop ? -2.0 * cosW0 : 0.0;
+    double b2 = bandstop ? 1.0 : -1.0;
+
+    // Reference point for gain normalisation
+    Complex zRef = bandstop ? Complex(1.0, 0.0) : Complex(cosW0, std::sqrt(1.0 - cosW0 * cosW0));
+    Complex zRefInv = 1.0 / zRef;
+
+    auto makeSection = [&](double a1, double a2) {
+        Complex num = b0 + zRefInv * (b1 + zRefInv * b2);
+        Complex den = 1.0 + zRefInv * (a1 + zRefInv * a2);
+        double g = std::abs(den) / std::abs(num);
+        return ButterworthCoeffs{b0 * g, b1 * g, b2 * g, a1, a2};
+    };
+
+    // Complex poles pair with their conjugate, real poles pair with each other
+    const double tolerance = 1e-10;
+    std::vector<ButterworthCoeffs> sections;
+    std::vector<double> realPoles;
+
+    for (const Complex& z : poles) {
+        if (z.imag() > tolerance) {
+            sections.push_back(makeSection(-2.0 * z.real(), std::norm(z)));
+        } else if (z.imag() >= -tolerance) {
+            realPoles.push_back(z.real());
+        }
+    }
+
+    for (size_t i = 0; i + 1 < realPoles.size(); i += 2) {
+        sections.push_back(makeSection(-(realPoles[i] + realPoles[i + 1]),
+                                       realPoles[i] * realPoles[i + 1]));
+    }
+
+    return sections;
+}
+
+DSPFilters::ButterworthCoeffs DSPFilters::designNarrowNotch(double sampleRate,
+                                                             double notchFreq,
+                                                             double q) {
+    double w0 = 2.0 * M_PI * notchFreq / sampleRate;
+    double cosW0 = std::cos(w0);
+    double alpha = std::sin(w0) / (2.0 * q);
+    double norm = 1.0 / (1.0 + alpha);
+
+    return ButterworthCoeffs{norm, -2.0 * cosW0 * norm, norm,
+                             -2.0 * cosW0 * norm, (1.0 - alpha) * norm};
+}
+
+std::vector<DSPFilters::ButterworthCoeffs> DSPFilters::designBiquadSections(
+    FilterType type,
+    float sampleRate,
+    float freq1,
+    float freq2,
+    int order) {
+
+    std::vector<ButterworthCoeffs> sections;
+
+    if (type == LOWPASS) {
+        sections = designLowpass(sampleRate, freq1, order);
+    } else if (type == HIGHPASS) {
+        sections = designHighpass(sampleRate, freq1, order);
+    } else if (type == BANDPASS) {
+        sections = designBand(sampleRate, freq1, freq2, order, false);
+    } else if (type == NOTCH) {
+        sections = designBand(sampleRate, freq1, freq2, order, true);
+    } else if (type == NARROW_NOTCH) {
+        sections.push_back(designNarrowNotch(sampleRate, freq1, freq2));
+    }
+
+    return sections;
+}
+
+std::shared_ptr<const std::vector<DSPFilters::ButterworthCoeffs>> DSPFilters::getCachedSections(
+    FilterType type,
+    float sampleRate,
+    float freq1,
+    float freq2,
+    int order) {
+
+    using Key = std::tuple<int, float, float, float, int>;
+    using Sections = std::vector<ButterworthCoeffs>;
+
+    static std::mutex cacheMutex;
+    static std::map<Key, std::shared_ptr<const Sections>> cache;
+    static const size_t maxEntries = 256;
+
+    bool usesFreq2 = type != LOWPASS && type != HIGHPASS;
+    Key key(type, sampleRate, freq1, usesFreq2 ? freq2 : 0.0f, type == NARROW_NOTCH ? 0 : order);
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second;
+        }
+    }
+
+    // Design outside the lock; a concurrent miss on the same key just
+    // designs the same sections twice
+    auto sections = std::make_shared<const Sections>(
+        designBiquadSections(type, sampleRate, freq1, freq2, order));
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (cache.size() >= maxEntries) {
+        cache.clear();  // Slider sweeps only; cheap to rebuild
+    }
+    cache.emplace(key, sections);
+    return sections;
 }
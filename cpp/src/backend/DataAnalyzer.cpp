@@ -1,7 +1,102 @@
 #include "DataAnalyzer.h"
+#include "RealFFT.h"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define STATS_HAS_SSE 1
+#include <emmintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// Below this many segments per thread, spawning costs more than it saves
+const size_t minSegmentsPerThread = 16;
+
+// Samples per statistics block; 16 KB stays in L1 for the second sweep
+const size_t statsBlockSize = 4096;
+
+/**
+ * @brief Min, max and (double) sum of one block; lo/hi must start at x[0]
+ */
+void blockMinMaxSum(const float* x, size_t n, float& lo, float& hi, double& sum) {
+    size_t i = 0;
+#ifdef STATS_HAS_SSE
+    if (n >= 4) {
+        __m128 vlo = _mm_loadu_ps(x);
+        __m128 vhi = vlo;
+        __m128d s0 = _mm_setzero_pd();
+        __m128d s1 = _mm_setzero_pd();
+        for (; i + 4 <= n; i += 4) {
+            __m128 v = _mm_loadu_ps(x + i);
+            vlo = _mm_min_ps(vlo, v);
+            vhi = _mm_max_ps(vhi, v);
+            s0 = _mm_add_pd(s0, _mm_cvtps_pd(v));
+            s1 = _mm_add_pd(s1, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+        }
+
+        float los[4], his[4];
+        double sums[2];
+        _mm_storeu_ps(los, vlo);
+        _mm_storeu_ps(his, vhi);
+        _mm_storeu_pd(sums, _mm_add_pd(s0, s1));
+        for (int lane = 0; lane < 4; ++lane) {
+            lo = std::min(lo, los[lane]);
+            hi = std::max(hi, his[lane]);
+        }
+        sum += sums[0] + sums[1];
+    }
+#endif
+    for (; i < n; ++i) {
+        lo = std::min(lo, x[i]);
+        hi = std::max(hi, x[i]);
+        sum += x[i];
+    }
+}
+
+/**
+ * @brief Sum of squared deviations of one block from mean, in double
+ */
+double blockSquaredDeviations(const float* x, size_t n, double mean) {
+    double result = 0.0;
+    size_t i = 0;
+#ifdef STATS_HAS_SSE
+    const __m128d m = _mm_set1_pd(mean);
+    __m128d a0 = _mm_setzero_pd();
+    __m128d a1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(x + i);
+        __m128d d0 = _mm_sub_pd(_mm_cvtps_pd(v), m);
+        __m128d d1 = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), m);
+        a0 = _mm_add_pd(a0, _mm_mul_pd(d0, d0));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(d1, d1));
+    }
+    double sums[2];
+    _mm_storeu_pd(sums, _mm_add_pd(a0, a1));
+    result = sums[0] + sums[1];
+#endif
+    for (; i < n; ++i) {
+        double d = x[i] - mean;
+        result += d * d;
+    }
+    return result;
+}
+
+}
+
+double DataAnalyzer::Moments::stdDev() const {
+    return std::sqrt(variance());
+}
+
+double DataAnalyzer::Moments::rms() const {
+    return std::sqrt(mean * mean + variance());
+}
 
 DataAnalyzer::DataAnalyzer() {
 }
@@ -9,73 +104,275 @@ DataAnalyzer::DataAnalyzer() {
 DataAnalyzer::~DataAnalyzer() {
 }
 
-DataAnalyzer::Statistics DataAnalyzer::calculateStatistics(const std::vector<float>& data) {
+DataAnalyzer::Statistics DataAnalyzer::calculateStatistics(SampleView data) {
     Statistics stats = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
 
     if (data.empty()) {
         return stats;
     }
 
-    // Min and Max
-    auto minmax = std::minmax_element(data.begin(), data.end());
-    stats.min = *minmax.first;
-    stats.max = *minmax.second;
+    Moments moments = computeMoments(data);
+    stats.min = static_cast<float>(moments.min);
+    stats.max = static_cast<float>(moments.max);
+    stats.mean = static_cast<float>(moments.mean);
+    stats.std = static_cast<float>(moments.stdDev());
+    stats.rms = static_cast<float>(moments.rms());
 
-    // Mean
-    float sum = std::accumulate(data.begin(), data.end(), 0.0f);
-    stats.mean = sum / data.size();
+    // The histogram path needs the range, which we already have
+    stats.median = data.size() > EXACT_MEDIAN_LIMIT
+        ? medianByHistogram(data, moments.min, moments.max)
+        : calculateMedian(data);
 
-    // Standard deviation
-    float variance = 0.0f;
-    for (float value : data) {
-        float diff = value - stats.mean;
-        variance += diff * diff;
+    return stats;
+}
+
+DataAnalyzer::Moments DataAnalyzer::computeMoments(SampleView data) {
+    Moments moments;
+
+    if (data.empty()) {
+        return moments;
     }
-    stats.std = std::sqrt(variance / data.size());
 
-    // RMS
-    float sumSquares = 0.0f;
-    for (float value : data) {
-        sumSquares += value * value;
+    float lo = data[0];
+    float hi = data[0];
+
+    for (size_t offset = 0; offset < data.size(); offset += statsBlockSize) {
+        const float* block = data.data() + offset;
+        const size_t n = std::min(statsBlockSize, data.size() - offset);
+
+        double sum = 0.0;
+        blockMinMaxSum(block, n, lo, hi, sum);
+        double blockMean = sum / n;
+        double blockM2 = blockSquaredDeviations(block, n, blockMean);
+
+        // Chan et al. pairwise merge of (count, mean, M2)
+        size_t total = moments.count + n;
+        double delta = blockMean - moments.mean;
+        moments.mean += delta * n / total;
+        moments.m2 += blockM2 + delta * delta * static_cast<double>(moments.count) * n / total;
+        moments.count = total;
     }
-    stats.rms = std::sqrt(sumSquares / data.size());
 
-    // Median
-    stats.median = median(data);
+    moments.min = lo;
+    moments.max = hi;
+    return moments;
+}
 
-    return stats;
+bool DataAnalyzer::calculateRangeStatistics(const SampleBuffer& buffer,
+                                            size_t start,
+                                            size_t end,
+                                            RangeStats& stats) {
+    return buffer.getRangeIndex().getStats(start, end, stats);
 }
 
-float DataAnalyzer::median(std::vector<float> data) {
+float DataAnalyzer::calculateMedian(SampleView data) {
     if (data.empty()) {
         return 0.0f;
     }
 
-    size_t n = data.size();
-    std::nth_element(data.begin(), data.begin() + n / 2, data.end());
+    const size_t n = data.size();
+    if (n > EXACT_MEDIAN_LIMIT) {
+        Moments moments = computeMoments(data);
+        return medianByHistogram(data, moments.min, moments.max);
+    }
+
+    // One selection; the lower middle of an even count is then simply the
+    // largest value left of the partition point
+    scratch.assign(data.begin(), data.end());
+    auto middle = scratch.begin() + n / 2;
+    std::nth_element(scratch.begin(), middle, scratch.end());
 
-    if (n % 2 == 0) {
-        float m1 = data[n / 2];
-        std::nth_element(data.begin(), data.begin() + n / 2 - 1, data.end());
-        float m2 = data[n / 2 - 1];
-        return (m1 + m2) / 2.0f;
-    } else {
-        return data[n / 2];
+    double upper = *middle;
+    if (n % 2 == 1) {
+        return static_cast<float>(upper);
     }
+    double lower = *std::max_element(scratch.begin(), middle);
+    return static_cast<float>((lower + upper) / 2.0);
 }
 
-std::vector<float> DataAnalyzer::calculatePSD(const std::vector<float>& data, float sampleRate) {
-    // Simplified PSD calculation (windowed periodogram)
-    // For production, use FFT library like FFTW
-    std::vector<float> psd;
+float DataAnalyzer::medianByHistogram(SampleView data, double minVal, double maxVal) {
+    if (maxVal <= minVal) {
+        return static_cast<float>(minVal);
+    }
 
-    if (data.empty()) {
-        return psd;
+    const double scale = HISTOGRAM_BINS / (maxVal - minVal);
+    auto binOf = [&](float value) {
+        double position = (value - minVal) * scale;
+        return std::min(HISTOGRAM_BINS - 1, static_cast<size_t>(std::max(0.0, position)));
+    };
+
+    std::vector<size_t> counts(HISTOGRAM_BINS, 0);
+    for (float value : data) {
+        ++counts[binOf(value)];
+    }
+
+    // Bins holding the two middle ranks (the same bin for odd counts)
+    const size_t n = data.size();
+    const size_t lowRank = (n - 1) / 2;
+    const size_t highRank = n / 2;
+
+    size_t before = 0;
+    size_t lowBin = 0;
+    while (before + counts[lowBin] <= lowRank) {
+        before += counts[lowBin++];
+    }
+    size_t highBin = lowBin;
+    size_t throughHigh = before + counts[highBin];
+    while (throughHigh <= highRank) {
+        throughHigh += counts[++highBin];
+    }
+
+    const size_t candidates = throughHigh - before;
+    if (candidates > EXACT_MEDIAN_LIMIT) {
+        double binWidth = (maxVal - minVal) / HISTOGRAM_BINS;
+        return static_cast<float>(minVal + (lowBin + highBin + 1) * binWidth / 2.0);
+    }
+
+    // Second pass: select exactly among the few samples in those bins
+    scratch.clear();
+    scratch.reserve(candidates);
+    for (float value : data) {
+        size_t bin = binOf(value);
+        if (bin >= lowBin && bin <= highBin) {
+            scratch.push_back(value);
+        }
+    }
+
+    auto low = scratch.begin() + (lowRank - before);
+    std::nth_element(scratch.begin(), low, scratch.end());
+    double lower = *low;
+    double upper = highRank == lowRank ? lower : *std::min_element(low + 1, scratch.end());
+    return static_cast<float>((lower + upper) / 2.0);
+}
+
+std::vector<float> DataAnalyzer::calculatePSD(SampleView data, float sampleRate) {
+    return calculateWelchPSD(data, sampleRate, WelchParams()).power;
+}
+
+DataAnalyzer::Spectrum DataAnalyzer::calculateWelchPSD(SampleView data,
+                                                       float sampleRate,
+                                                       const WelchParams& params) {
+    Spectrum spectrum;
+    lastError.clear();
+
+    if (data.size() < 2) {
+        lastError = "Welch PSD needs at least 2 samples";
+        return spectrum;
+    }
+    if (sampleRate <= 0.0f) {
+        lastError = "Sample rate must be positive";
+        return spectrum;
+    }
+    if (params.segmentLength < 2) {
+        lastError = "Segment length must be at least 2";
+        return spectrum;
+    }
+    if (params.overlap < 0.0f || params.overlap >= 1.0f) {
+        lastError = "Overlap must be in [0, 1)";
+        return spectrum;
+    }
+
+    // A signal shorter than one segment becomes a single periodogram
+    const size_t segmentLength = std::min(params.segmentLength, data.size());
+    const size_t step = std::max<size_t>(1, segmentLength -
+        static_cast<size_t>(std::lround(params.overlap * segmentLength)));
+    const size_t numSegments = 1 + (data.size() - segmentLength) / step;
+
+    const size_t nfft = RealFFT::nextPowerOfTwo(segmentLength);
+    const size_t numBins = nfft / 2 + 1;
+    const std::vector<float> window = makeWindow(params.window, segmentLength);
+
+    unsigned threads = params.numThreads > 0
+        ? params.numThreads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::max<size_t>(1,
+        std::min<size_t>(threads, numSegments / minSegmentsPerThread)));
+
+    // Each worker sums the periodograms of a contiguous run of segments
+    std::vector<std::vector<double>> sums(threads, std::vector<double>(numBins, 0.0));
+    auto worker = [&](unsigned t) {
+        RealFFT fft(nfft);
+        std::vector<float> frame(nfft, 0.0f);
+        std::vector<float> power(numBins);
+        std::vector<double>& sum = sums[t];
+
+        size_t first = numSegments * t / threads;
+        size_t last = numSegments * (t + 1) / threads;
+        for (size_t segment = first; segment < last; ++segment) {
+            const float* samples = data.data() + segment * step;
+
+            // Remove the segment mean so DC leakage doesn't swamp low bins
+            double mean = 0.0;
+            for (size_t i = 0; i < segmentLength; ++i) {
+                mean += samples[i];
+            }
+            mean /= static_cast<double>(segmentLength);
+
+            for (size_t i = 0; i < segmentLength; ++i) {
+                frame[i] = static_cast<float>(samples[i] - mean) * window[i];
+            }
+
+            fft.powerSpectrum(frame.data(), power.data());
+            for (size_t k = 0; k < numBins; ++k) {
+                sum[k] += power[k];
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    // Density scaling, averaged over segments; interior bins count twice
+    // because the negative frequencies are folded onto them
+    double windowPower = 0.0;
+    for (float w : window) {
+        windowPower += static_cast<double>(w) * w;
+    }
+    const double scale = 1.0 / (sampleRate * windowPower * numSegments);
+
+    spectrum.frequencies.resize(numBins);
+    spectrum.power.resize(numBins);
+    spectrum.numSegments = numSegments;
+
+    for (size_t k = 0; k < numBins; ++k) {
+        double total = 0.0;
+        for (const auto& sum : sums) {
+            total += sum[k];
+        }
+        bool folded = k > 0 && k < nfft / 2;
+        spectrum.power[k] = static_cast<float>(total * scale * (folded ? 2.0 : 1.0));
+        spectrum.frequencies[k] = static_cast<float>(k * static_cast<double>(sampleRate) / nfft);
+    }
+
+    return spectrum;
+}
+
+std::vector<float> DataAnalyzer::makeWindow(WindowType type, size_t length) {
+    std::vector<float> window(length, 1.0f);
+
+    for (size_t i = 0; i < length; ++i) {
+        double phase = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(length);
+        switch (type) {
+            case WINDOW_HANN:
+                window[i] = static_cast<float>(0.5 - 0.5 * std::cos(phase));
+                break;
+            case WINDOW_HAMMING:
+                window[i] = static_cast<float>(0.54 - 0.46 * std::cos(phase));
+                break;
+            case WINDOW_BLACKMAN:
+                window[i] = static_cast<float>(0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase));
+                break;
+            case WINDOW_RECTANGULAR:
+                break;
+        }
     }
 
-    // Placeholder: return empty for now
-    // TODO: Implement proper FFT-based PSD calculation
-    return psd;
+    return window;
 }
 
 std::vector<std::pair<size_t, size_t>> DataAnalyzer::detectActivity(
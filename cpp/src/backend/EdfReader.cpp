@@ -0,0 +1,346 @@
+#include "EdfReader.h"
+#include "DataAnalyzer.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+const size_t fixedHeaderBytes = 256;
+const size_t signalHeaderBytes = 256;
+
+std::string lowerExtension(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return std::string();
+    }
+    std::string ext = path.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+std::string trimmed(const char* data, size_t width) {
+    size_t begin = 0;
+    size_t end = width;
+    while (begin < end && data[begin] == ' ') {
+        ++begin;
+    }
+    while (end > begin && (data[end - 1] == ' ' || data[end - 1] == '\0')) {
+        --end;
+    }
+    return std::string(data + begin, end - begin);
+}
+
+// Locale-independent; EDF numbers may carry a leading '+'
+bool parseNumber(const std::string& text, double& value) {
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    if (begin != end && *begin == '+') {
+        ++begin;
+    }
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool parseInteger(const std::string& text, long long& value) {
+    double number;
+    if (!parseNumber(text, number) || number != std::floor(number)) {
+        return false;
+    }
+    value = static_cast<long long>(number);
+    return true;
+}
+
+}
+
+EdfReader::EdfReader()
+    : headerBytes(0)
+    , recordBytes(0)
+    , numRecords(0)
+    , recordDuration(0.0)
+    , edfPlus(false)
+{
+}
+
+EdfReader::~EdfReader() {
+}
+
+bool EdfReader::isEdfFile(const std::string& path) {
+    return lowerExtension(path) == ".edf";
+}
+
+bool EdfReader::open(const std::string& path) {
+    close();
+
+    auto mapping = std::make_shared<MappedFile>();
+    if (!mapping->open(path)) {
+        lastError = "Failed to map " + path + ": " + mapping->getLastError();
+        return false;
+    }
+    file = mapping;
+
+    if (!parseHeader()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void EdfReader::close() {
+    file.reset();
+    edfSignals.clear();
+    headerBytes = 0;
+    recordBytes = 0;
+    numRecords = 0;
+    recordDuration = 0.0;
+    edfPlus = false;
+}
+
+bool EdfReader::parseHeader() {
+    const char* data = file->data();
+    const size_t size = file->size();
+
+    if (size < fixedHeaderBytes || trimmed(data, 8) != "0") {
+        lastError = "Not an EDF file";
+        return false;
+    }
+
+    const std::string reserved = trimmed(data + 192, 44);
+    edfPlus = reserved.compare(0, 4, "EDF+") == 0;
+
+    long long headerSize = 0;
+    long long records = 0;
+    long long numSignals = 0;
+    if (!parseInteger(trimmed(data + 184, 8), headerSize) ||
+        !parseInteger(trimmed(data + 236, 8), records) ||
+        !parseNumber(trimmed(data + 244, 8), recordDuration) ||
+        !parseInteger(trimmed(data + 252, 4), numSignals) || numSignals <= 0) {
+        lastError = "Invalid EDF header";
+        return false;
+    }
+
+    headerBytes = fixedHeaderBytes + signalHeaderBytes * static_cast<size_t>(numSignals);
+    if (static_cast<size_t>(headerSize) != headerBytes || size < headerBytes) {
+        lastError = "Invalid EDF header size";
+        return false;
+    }
+
+    // Signal fields are stored field by field: ns labels, then ns transducers...
+    const size_t ns = static_cast<size_t>(numSignals);
+    const char* p = data + fixedHeaderBytes;
+    auto column = [&](size_t width, size_t s) {
+        return trimmed(p + width * s, width);
+    };
+
+    edfSignals.assign(ns, Signal());
+    for (size_t s = 0; s < ns; ++s) {
+        edfSignals[s].label = column(16, s);
+        edfSignals[s].isAnnotation = edfPlus && edfSignals[s].label == "EDF Annotations";
+    }
+    p += 16 * ns + 80 * ns;  // Labels, transducer types
+    for (size_t s = 0; s < ns; ++s) {
+        edfSignals[s].units = column(8, s);
+    }
+    p += 8 * ns;
+
+    // Physical min/max, digital min/max, then samples per record after the
+    // 80-character prefiltering field
+    const size_t fieldOffsets[] = {0, 8, 16, 24, 32 + 80};
+    for (size_t s = 0; s < ns; ++s) {
+        Signal& signal = edfSignals[s];
+        long long digitalMin;
+        long long digitalMax;
+        long long samples;
+        if (!parseNumber(trimmed(p + fieldOffsets[0] * ns + 8 * s, 8), signal.physicalMin) ||
+            !parseNumber(trimmed(p + fieldOffsets[1] * ns + 8 * s, 8), signal.physicalMax) ||
+            !parseInteger(trimmed(p + fieldOffsets[2] * ns + 8 * s, 8), digitalMin) ||
+            !parseInteger(trimmed(p + fieldOffsets[3] * ns + 8 * s, 8), digitalMax) ||
+            !parseInteger(trimmed(p + fieldOffsets[4] * ns + 8 * s, 8), samples) ||
+            samples <= 0 || digitalMax <= digitalMin) {
+            lastError = "Invalid header for signal " + std::to_string(s) + " (" + signal.label + ")";
+            return false;
+        }
+
+        signal.digitalMin = static_cast<int>(digitalMin);
+        signal.digitalMax = static_cast<int>(digitalMax);
+        signal.samplesPerRecord = static_cast<size_t>(samples);
+        signal.gain = (signal.physicalMax - signal.physicalMin) / (signal.digitalMax - signal.digitalMin);
+        signal.offset = signal.physicalMin - signal.gain * signal.digitalMin;
+    }
+
+    recordBytes = 0;
+    for (auto& signal : edfSignals) {
+        signal.offsetInRecord = recordBytes;
+        recordBytes += 2 * signal.samplesPerRecord;
+    }
+
+    // -1 records means the writer didn't finish; trust the file size
+    const size_t available = (size - headerBytes) / recordBytes;
+    if (records < 0) {
+        numRecords = available;
+    } else {
+        numRecords = std::min(static_cast<size_t>(records), available);
+        if (numRecords < static_cast<size_t>(records)) {
+            std::cerr << "EdfReader: file is truncated, reading " << numRecords << " of "
+                      << records << " data records" << std::endl;
+        }
+    }
+
+    if (recordDuration <= 0.0) {
+        // Allowed for files without signal data (annotations only)
+        recordDuration = 1.0;
+    }
+    return true;
+}
+
+size_t EdfReader::readSamples(size_t signal, size_t firstRecord, size_t count, float* out) const {
+    if (!file || signal >= edfSignals.size() || firstRecord >= numRecords) {
+        return 0;
+    }
+
+    const Signal& info = edfSignals[signal];
+    const size_t lastRecord = std::min(numRecords, firstRecord + count);
+    const unsigned char* record = reinterpret_cast<const unsigned char*>(
+        file->data() + headerBytes + firstRecord * recordBytes + info.offsetInRecord);
+
+    size_t written = 0;
+    for (size_t r = firstRecord; r < lastRecord; ++r, record += recordBytes) {
+        for (size_t i = 0; i < info.samplesPerRecord; ++i) {
+            int16_t digital = static_cast<int16_t>(record[2 * i] | (record[2 * i + 1] << 8));
+            out[written++] = static_cast<float>(digital * info.gain + info.offset);
+        }
+    }
+    return written;
+}
+
+std::vector<EdfReader::Annotation> EdfReader::readAnnotations() const {
+    std::vector<Annotation> result;
+    if (!file) {
+        return result;
+    }
+
+    for (const auto& signal : edfSignals) {
+        if (!signal.isAnnotation) {
+            continue;
+        }
+        const char* record = file->data() + headerBytes + signal.offsetInRecord;
+        for (size_t r = 0; r < numRecords; ++r, record += recordBytes) {
+            parseTals(record, 2 * signal.samplesPerRecord, result);
+        }
+    }
+    return result;
+}
+
+void EdfReader::parseTals(const char* data, size_t size, std::vector<Annotation>& out) {
+    // TAL: +onset[\x15duration]\x14[text\x14]...\0, zero-padded to the end
+    size_t p = 0;
+    while (p < size) {
+        if (data[p] == '\0') {
+            ++p;
+            continue;
+        }
+
+        size_t end = p;
+        while (end < size && data[end] != '\0') {
+            ++end;
+        }
+        const std::string tal(data + p, end - p);
+        p = end;
+
+        size_t timeEnd = tal.find('\x14');
+        if (timeEnd == std::string::npos) {
+            continue;
+        }
+        std::string time = tal.substr(0, timeEnd);
+        double onset;
+        double duration = 0.0;
+        size_t split = time.find('\x15');
+        if (!parseNumber(time.substr(0, split), onset) ||
+            (split != std::string::npos && !parseNumber(time.substr(split + 1), duration))) {
+            continue;
+        }
+
+        // One annotation per text; an empty first text is time-keeping
+        for (size_t start = timeEnd + 1; start < tal.size();) {
+            size_t stop = tal.find('\x14', start);
+            if (stop == std::string::npos) {
+                stop = tal.size();
+            }
+            if (stop > start) {
+                out.push_back({onset, duration, tal.substr(start, stop - start)});
+            }
+            start = stop + 1;
+        }
+    }
+}
+
+std::shared_ptr<ACQFileMetadata> EdfReader::readFile(const std::string& path) {
+    lastError.clear();
+    annotations.clear();
+
+    if (!open(path)) {
+        return nullptr;
+    }
+    if (edfPlus && trimmed(file->data() + 192, 44).compare(0, 5, "EDF+D") == 0) {
+        std::cout << "EdfReader: discontinuous EDF+ file, record gaps are ignored" << std::endl;
+    }
+
+    auto fileMetadata = std::make_shared<ACQFileMetadata>();
+    fileMetadata->setSourceFile(baseName(path));
+
+    for (size_t s = 0; s < edfSignals.size(); ++s) {
+        const Signal& signal = edfSignals[s];
+        if (signal.isAnnotation) {
+            continue;
+        }
+
+        // Converted in blocks straight into the channel's buffer, which holds
+        // the whole signal as float32 (twice its size in the file)
+        std::vector<float> samples(numRecords * signal.samplesPerRecord);
+        for (size_t r = 0; r < numRecords; r += BLOCK_RECORDS) {
+            readSamples(s, r, BLOCK_RECORDS, samples.data() + r * signal.samplesPerRecord);
+        }
+
+        const float sampleRate = static_cast<float>(signal.samplesPerRecord / recordDuration);
+        SampleBuffer::Ptr buffer = SampleBuffer::create(std::move(samples));
+        DataAnalyzer::Moments moments = DataAnalyzer::computeMoments(buffer->view());
+
+        auto channel = std::make_shared<ChannelData>();
+        channel->setIndex(static_cast<int>(fileMetadata->getChannels().size()));
+        channel->setName(signal.label);
+        channel->setUnits(signal.units);
+        channel->setSampleRate(sampleRate);
+        channel->setDuration(static_cast<float>(numRecords * recordDuration));
+        channel->setStatistics(static_cast<float>(moments.min), static_cast<float>(moments.max),
+                               static_cast<float>(moments.mean), static_cast<float>(moments.stdDev()));
+        channel->setBuffer(std::move(buffer));
+
+        fileMetadata->addChannel(channel);
+    }
+
+    annotations = readAnnotations();
+    close();
+
+    if (fileMetadata->getChannels().empty()) {
+        lastError = "No signals found in " + path;
+        return nullptr;
+    }
+    fileMetadata->setNumChannels(static_cast<int>(fileMetadata->getChannels().size()));
+
+    std::cout << "EdfReader: loaded " << fileMetadata->getChannels().size() << " channels and "
+              << annotations.size() << " annotations from " << path << std::endl;
+    return fileMetadata;
+}
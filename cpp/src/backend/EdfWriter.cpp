@@ -0,0 +1,379 @@
+#include "EdfWriter.h"
+#include "BufferedWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace {
+
+const int digitalMin = -32768;
+const int digitalMax = 32767;
+
+// Longest data record preferred (seconds) and longest accepted at all
+const double preferredRecordDuration = 1.0;
+const double maxRecordDuration = 60.0;
+
+// Sample rates are floats: ACQ rates such as 2000/3 Hz are matched as
+// fractions with a denominator up to this, within float precision
+const uint64_t maxRateDenominator = 10000;
+
+// Bytes per annotation TAL beyond the text: "+onset\x15duration\x14" ... "\x14\0"
+const size_t talOverhead = 40;
+
+// Sample rate as a reduced fraction num / den, if it is one
+bool rateFraction(double rate, uint64_t& num, uint64_t& den) {
+    // Continued fraction convergents until one matches the rate
+    uint64_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    double x = rate;
+    for (int i = 0; i < 64; ++i) {
+        double a = std::floor(x);
+        if (a > 1e12) {
+            break;
+        }
+        uint64_t ai = static_cast<uint64_t>(a);
+        uint64_t p2 = ai * p1 + p0;
+        uint64_t q2 = ai * q1 + q0;
+        if (q2 > maxRateDenominator) {
+            break;
+        }
+        p0 = p1; q0 = q1; p1 = p2; q1 = q2;
+        if (std::fabs(static_cast<double>(p1) / q1 - rate) <= 1e-6 * rate) {
+            num = p1;
+            den = q1;
+            return num > 0;
+        }
+        if (x - a < 1e-12) {
+            break;
+        }
+        x = 1.0 / (x - a);
+    }
+    return false;
+}
+
+// True if num / den seconds prints exactly in an 8-character header field
+bool exactDuration(uint64_t num, uint64_t den) {
+    uint64_t rest = den / std::gcd(num, den);
+    int twos = 0;
+    int fives = 0;
+    for (; rest % 2 == 0; rest /= 2) ++twos;
+    for (; rest % 5 == 0; rest /= 5) ++fives;
+    return rest == 1 && twos <= 6 && fives <= 6;
+}
+
+// Fixed-width, space-padded, printable-ASCII header field
+std::string field(const std::string& text, size_t width) {
+    std::string out;
+    for (char c : text) {
+        if (out.size() == width) {
+            break;
+        }
+        unsigned char u = static_cast<unsigned char>(c);
+        out += (u >= 0x20 && u < 0x7F) ? c : '_';
+    }
+    out.resize(width, ' ');
+    return out;
+}
+
+std::string number(long long value) {
+    char text[32];
+    return std::string(text, std::to_chars(text, text + sizeof(text), value).ptr);
+}
+
+// Decimal seconds without trailing zeros, locale-independent
+std::string seconds(double value) {
+    char text[64];
+    char* end = std::to_chars(text, text + sizeof(text), value, std::chars_format::fixed, 6).ptr;
+    while (end > text && end[-1] == '0') {
+        --end;
+    }
+    if (end > text && end[-1] == '.') {
+        --end;
+    }
+    return std::string(text, end);
+}
+
+// At most 8 characters, rounded outward so no sample clips
+std::string physicalLimit(double value, bool roundUp, double& stored) {
+    for (int decimals = 6; decimals >= 0; --decimals) {
+        double scale = std::pow(10.0, decimals);
+        double rounded = (roundUp ? std::ceil(value * scale) : std::floor(value * scale)) / scale;
+        char text[64];
+        char* end = std::to_chars(text, text + sizeof(text), rounded, std::chars_format::fixed, decimals).ptr;
+        if (end - text <= 8) {
+            stored = rounded;
+            return std::string(text, end);
+        }
+    }
+    stored = roundUp ? 99999999.0 : -9999999.0;
+    return roundUp ? "99999999" : "-9999999";
+}
+
+void putInt16(std::vector<char>& record, size_t offset, int value) {
+    uint16_t bits = static_cast<uint16_t>(static_cast<int16_t>(value));
+    record[offset] = static_cast<char>(bits & 0xFF);
+    record[offset + 1] = static_cast<char>(bits >> 8);
+}
+
+// Annotation text may not contain TAL delimiters
+std::string talText(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        out += (c == '\x14' || c == '\x15' || c == '\0') ? ' ' : c;
+    }
+    return out;
+}
+
+}
+
+EdfWriter::EdfWriter()
+    : patientId("X X X X")
+    , recordingId("Startdate X X X X")
+    , recordDuration(1.0)
+{
+}
+
+EdfWriter::~EdfWriter() {
+}
+
+void EdfWriter::addChannel(std::shared_ptr<ChannelData> channel) {
+    if (channel) {
+        channels.push_back(std::move(channel));
+    }
+}
+
+void EdfWriter::addChannels(const ACQFileMetadata& file) {
+    for (const auto& channel : file.getChannels()) {
+        addChannel(channel);
+    }
+}
+
+void EdfWriter::addAnnotation(double onset, double duration, const std::string& text) {
+    annotations.push_back({std::max(0.0, onset), std::max(0.0, duration), talText(text)});
+}
+
+bool EdfWriter::chooseRecordDuration(std::vector<Signal>& edfSignals) {
+    // With rate_i = num_i / den_i, every channel has a whole number of
+    // samples in multiples of lcm(den_i) / gcd(num_i) seconds
+    uint64_t unitNum = 1;  // Shortest such duration, unitNum / unitDen s
+    uint64_t unitDen = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> rates;
+    for (const auto& signal : edfSignals) {
+        uint64_t num = 0;
+        uint64_t den = 0;
+        if (!rateFraction(signal.channel->getSampleRate(), num, den)) {
+            lastError = "Sample rate " + std::to_string(signal.channel->getSampleRate()) +
+                        " Hz doesn't give whole samples in any EDF data record";
+            return false;
+        }
+        rates.emplace_back(num, den);
+        unitNum = std::lcm(unitNum, den);
+        unitDen = std::gcd(unitDen, num);
+        if (static_cast<double>(unitNum) / unitDen > maxRecordDuration) {
+            lastError = "Sample rates don't fit a whole number of samples per EDF data record";
+            return false;
+        }
+    }
+
+    // Samples, and bytes, of one unit
+    size_t unitBytes = 0;
+    std::vector<uint64_t> unitSamples;
+    for (const auto& rate : rates) {
+        unitSamples.push_back(rate.first * (unitNum / rate.second) / unitDen);
+        unitBytes += 2 * unitSamples.back();
+    }
+
+    // As many units as fit the preferred duration and MAX_RECORD_BYTES (at
+    // least one), preferring a count whose duration prints exactly
+    const double unit = static_cast<double>(unitNum) / unitDen;
+    uint64_t most = static_cast<uint64_t>(std::floor(preferredRecordDuration / unit + 1e-9));
+    most = std::max<uint64_t>(1, std::min<uint64_t>(most, MAX_RECORD_BYTES / std::max<size_t>(unitBytes, 1)));
+    uint64_t units = most;
+    for (uint64_t m = most; m >= 1; --m) {
+        if (exactDuration(m * unitNum, unitDen) &&
+            seconds(static_cast<double>(m * unitNum) / unitDen).size() <= 8) {
+            units = m;
+            break;
+        }
+    }
+
+    recordDuration = static_cast<double>(units * unitNum) / unitDen;
+    for (size_t i = 0; i < edfSignals.size(); ++i) {
+        edfSignals[i].samplesPerRecord = static_cast<size_t>(units * unitSamples[i]);
+    }
+    return true;
+}
+
+bool EdfWriter::writeFile(const std::string& path) {
+    lastError.clear();
+
+    std::vector<Signal> edfSignals;
+    for (const auto& channel : channels) {
+        if (!channel->getBuffer() || channel->getSampleRate() <= 0.0f) {
+            continue;
+        }
+        Signal signal;
+        signal.channel = channel;
+        signal.samplesPerRecord = 0;
+
+        // Range from the display pyramid, which the channel usually has already
+        float lo = 0.0f;
+        float hi = 0.0f;
+        const auto& buffer = channel->getBuffer();
+        if (!buffer->empty()) {
+            buffer->getPyramid().getMinMax(0, buffer->size(), lo, hi);
+        }
+        if (!(hi > lo)) {
+            lo -= 1.0f;
+            hi += 1.0f;
+        }
+        signal.physicalMin = lo;
+        signal.physicalMax = hi;
+        edfSignals.push_back(signal);
+    }
+
+    if (edfSignals.empty()) {
+        lastError = "No channel data to export";
+        return false;
+    }
+    if (!chooseRecordDuration(edfSignals)) {
+        return false;
+    }
+
+    size_t numRecords = 0;
+    for (const auto& signal : edfSignals) {
+        size_t size = signal.channel->getBuffer()->size();
+        numRecords = std::max(numRecords, (size + signal.samplesPerRecord - 1) / signal.samplesPerRecord);
+    }
+    numRecords = std::max<size_t>(numRecords, 1);
+
+    // Annotations go to the record holding their onset; the annotation
+    // signal is sized for the fullest record
+    std::vector<std::vector<size_t>> recordAnnotations(numRecords);
+    for (size_t i = 0; i < annotations.size(); ++i) {
+        size_t record = std::min(static_cast<size_t>(annotations[i].onset / recordDuration), numRecords - 1);
+        recordAnnotations[record].push_back(i);
+    }
+    size_t annotationBytes = talOverhead;
+    for (const auto& indices : recordAnnotations) {
+        size_t bytes = talOverhead;
+        for (size_t i : indices) {
+            bytes += talOverhead + annotations[i].text.size();
+        }
+        annotationBytes = std::max(annotationBytes, bytes);
+    }
+    const size_t annotationSamples = (annotationBytes + 1) / 2;
+
+    // Header: 256 bytes, then 256 per signal, field by field
+    const size_t numSignals = edfSignals.size() + 1;
+    std::vector<std::string> physicalMin(edfSignals.size());
+    std::vector<std::string> physicalMax(edfSignals.size());
+    for (size_t s = 0; s < edfSignals.size(); ++s) {
+        physicalMin[s] = physicalLimit(edfSignals[s].physicalMin, false, edfSignals[s].physicalMin);
+        physicalMax[s] = physicalLimit(edfSignals[s].physicalMax, true, edfSignals[s].physicalMax);
+    }
+
+    std::string header;
+    header += field("0", 8);
+    header += field(patientId, 80);
+    header += field(recordingId, 80);
+    header += field("01.01.85", 8);  // Start date/time are not known
+    header += field("00.00.00", 8);
+    header += field(number(static_cast<long long>(256 * (numSignals + 1))), 8);
+    header += field("EDF+C", 44);
+    header += field(number(static_cast<long long>(numRecords)), 8);
+    header += field(seconds(recordDuration), 8);
+    header += field(number(static_cast<long long>(numSignals)), 4);
+
+    for (const auto& signal : edfSignals) {
+        header += field(signal.channel->getName(), 16);
+    }
+    header += field("EDF Annotations", 16);
+    for (size_t s = 0; s < numSignals; ++s) {
+        header += field("", 80);  // Transducer
+    }
+    for (const auto& signal : edfSignals) {
+        header += field(signal.channel->getUnits(), 8);
+    }
+    header += field("", 8);
+    for (size_t s = 0; s < edfSignals.size(); ++s) {
+        header += field(physicalMin[s], 8);
+    }
+    header += field("-1", 8);
+    for (size_t s = 0; s < edfSignals.size(); ++s) {
+        header += field(physicalMax[s], 8);
+    }
+    header += field("1", 8);
+    for (size_t s = 0; s < numSignals; ++s) {
+        header += field(number(digitalMin), 8);
+    }
+    for (size_t s = 0; s < numSignals; ++s) {
+        header += field(number(digitalMax), 8);
+    }
+    for (size_t s = 0; s < numSignals; ++s) {
+        header += field("", 80);  // Prefiltering
+    }
+    for (const auto& signal : edfSignals) {
+        header += field(number(static_cast<long long>(signal.samplesPerRecord)), 8);
+    }
+    header += field(number(static_cast<long long>(annotationSamples)), 8);
+    for (size_t s = 0; s < numSignals; ++s) {
+        header += field("", 32);
+    }
+
+    BufferedWriter out;
+    if (!out.open(path)) {
+        lastError = out.getLastError();
+        return false;
+    }
+    out.write(header);
+
+    size_t recordBytes = 2 * annotationSamples;
+    for (const auto& signal : edfSignals) {
+        recordBytes += 2 * signal.samplesPerRecord;
+    }
+    std::vector<char> record(recordBytes);
+
+    for (size_t r = 0; r < numRecords && out.good(); ++r) {
+        size_t offset = 0;
+
+        for (const auto& signal : edfSignals) {
+            SampleView samples = signal.channel->getData();
+            const double gain = (digitalMax - digitalMin) / (signal.physicalMax - signal.physicalMin);
+            const size_t first = r * signal.samplesPerRecord;
+
+            for (size_t i = 0; i < signal.samplesPerRecord; ++i) {
+                size_t index = std::min(first + i, samples.size() - 1);
+                double value = samples.empty() ? 0.0 : samples[index];
+                double digital = std::isnan(value)
+                    ? digitalMin : std::round((value - signal.physicalMin) * gain) + digitalMin;
+                putInt16(record, offset, static_cast<int>(std::clamp<double>(digital, digitalMin, digitalMax)));
+                offset += 2;
+            }
+        }
+
+        // Time-keeping TAL first, then this record's annotations
+        std::string tals = "+" + seconds(r * recordDuration) + "\x14\x14";
+        tals += '\0';
+        for (size_t i : recordAnnotations[r]) {
+            const Annotation& annotation = annotations[i];
+            tals += "+" + seconds(annotation.onset);
+            if (annotation.duration > 0.0) {
+                tals += "\x15" + seconds(annotation.duration);
+            }
+            tals += "\x14" + annotation.text + "\x14";
+            tals += '\0';
+        }
+        std::fill(record.begin() + offset, record.end(), '\0');
+        std::copy(tals.begin(), tals.end(), record.begin() + offset);
+
+        out.write(record.data(), record.size());
+    }
+
+    if (!out.close()) {
+        lastError = out.getLastError();
+        return false;
+    }
+    return true;
+}
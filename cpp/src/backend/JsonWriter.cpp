@@ -0,0 +1,153 @@
+#include "JsonWriter.h"
+#include <cmath>
+
+JsonWriter::JsonWriter(BufferedWriter& output, int indentWidth)
+    : out(output)
+    , indent(indentWidth)
+    , afterKey(false)
+{
+}
+
+void JsonWriter::beginObject() {
+    separate();
+    out.put('{');
+    hasMembers.push_back(false);
+}
+
+void JsonWriter::endObject() {
+    close('}');
+}
+
+void JsonWriter::beginArray() {
+    separate();
+    out.put('[');
+    hasMembers.push_back(false);
+}
+
+void JsonWriter::endArray() {
+    close(']');
+}
+
+void JsonWriter::key(std::string_view name) {
+    separate();
+    writeString(name);
+    out.write(": ");
+    afterKey = true;
+}
+
+void JsonWriter::value(std::string_view text) {
+    separate();
+    writeString(text);
+}
+
+void JsonWriter::value(float number) {
+    separate();
+    writeFloat(number);
+}
+
+void JsonWriter::value(double number) {
+    separate();
+    if (std::isfinite(number)) {
+        out.writeDouble(number);
+    } else {
+        out.write("null");
+    }
+}
+
+void JsonWriter::value(bool flag) {
+    separate();
+    out.write(flag ? "true" : "false");
+}
+
+void JsonWriter::null() {
+    separate();
+    out.write("null");
+}
+
+void JsonWriter::floatArray(SampleView values) {
+    separate();
+    out.put('[');
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) {
+            out.write(", ");
+        }
+        writeFloat(values[i]);
+    }
+    out.put(']');
+}
+
+void JsonWriter::separate() {
+    // A value right after its key stays on the key's line
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+
+    if (hasMembers.empty()) {
+        return;
+    }
+
+    if (hasMembers.back()) {
+        out.put(',');
+    }
+    hasMembers.back() = true;
+    newline();
+}
+
+void JsonWriter::newline() {
+    out.put('\n');
+    for (size_t i = 0; i < hasMembers.size() * indent; ++i) {
+        out.put(' ');
+    }
+}
+
+void JsonWriter::close(char bracket) {
+    if (hasMembers.empty()) {
+        return;
+    }
+
+    bool nonEmpty = hasMembers.back();
+    hasMembers.pop_back();
+    if (nonEmpty) {
+        newline();
+    }
+    out.put(bracket);
+
+    if (hasMembers.empty()) {
+        out.put('\n');
+    }
+}
+
+void JsonWriter::writeString(std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+
+    out.put('"');
+    for (char c : text) {
+        switch (c) {
+        case '"':  out.write("\\\""); break;
+        case '\\': out.write("\\\\"); break;
+        case '\b': out.write("\\b"); break;
+        case '\f': out.write("\\f"); break;
+        case '\n': out.write("\\n"); break;
+        case '\r': out.write("\\r"); break;
+        case '\t': out.write("\\t"); break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out.write("\\u00");
+                out.put(hex[(c >> 4) & 0xF]);
+                out.put(hex[c & 0xF]);
+            } else {
+                out.put(c);  // UTF-8 passes through unchanged
+            }
+        }
+    }
+    out.put('"');
+}
+
+void JsonWriter::writeFloat(float number) {
+    if (std::isfinite(number)) {
+        out.writeFloat(number);
+    } else {
+        out.write("null");
+    }
+}
@@ -0,0 +1,181 @@
+#include "RealFFT.h"
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FFT_HAS_SSE 1
+#include <emmintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/**
+ * @brief Precomputed twiddles for one transform size
+ *
+ * twiddles holds W_N^k = exp(-2*pi*i*k/N) for k < N/2, interleaved re/im.
+ * The half-size complex stages use every other entry (W_{N/2}^j = W_N^2j),
+ * the final split step uses all of them.
+ */
+struct RealFFT::Plan {
+    size_t size;
+    std::vector<float> twiddles;
+};
+
+RealFFT::RealFFT(size_t size)
+    : n(size)
+{
+    if (size < 2 || !isPowerOfTwo(size)) {
+        return;
+    }
+
+    plan = getCachedPlan(size);
+    bufferA.resize(size);
+    bufferB.resize(size);
+    spectrum.resize(2 * getNumBins());
+}
+
+RealFFT::~RealFFT() {
+}
+
+size_t RealFFT::nextPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+std::shared_ptr<const RealFFT::Plan> RealFFT::getCachedPlan(size_t size) {
+    static std::mutex cacheMutex;
+    static std::map<size_t, std::shared_ptr<const Plan>> cache;
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(size);
+        if (it != cache.end()) {
+            return it->second;
+        }
+    }
+
+    auto plan = std::make_shared<Plan>();
+    plan->size = size;
+    plan->twiddles.resize(size);
+    for (size_t k = 0; k < size / 2; ++k) {
+        // Computed in double so large sizes keep full float accuracy
+        double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(size);
+        plan->twiddles[2 * k] = static_cast<float>(std::cos(angle));
+        plan->twiddles[2 * k + 1] = static_cast<float>(std::sin(angle));
+    }
+
+    // Only a handful of sizes are ever used, so the cache is never trimmed
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return cache.emplace(size, plan).first->second;
+}
+
+const float* RealFFT::transformHalf(const float* input) {
+    // Pairs of real samples form the complex input z[k] = x[2k] + i x[2k+1]
+    const size_t half = n / 2;
+    const float* twiddles = plan->twiddles.data();
+
+    float* x = bufferA.data();
+    float* y = bufferB.data();
+    std::copy(input, input + n, x);
+
+    // Radix-2 Stockham: each stage reads x and writes y in natural order,
+    // with s independent interleaved sub-transforms of length len
+    size_t s = 1;
+    for (size_t len = half; len > 1; len /= 2, s *= 2) {
+        const size_t m = len / 2;
+
+        for (size_t p = 0; p < m; ++p) {
+            const float* w = twiddles + 2 * (2 * p * s);
+            const float* a = x + 2 * (s * p);
+            const float* b = x + 2 * (s * (p + m));
+            float* sum = y + 2 * (s * 2 * p);
+            float* diff = y + 2 * (s * (2 * p + 1));
+
+            size_t q = 0;
+#ifdef FFT_HAS_SSE
+            const __m128 wr = _mm_set1_ps(w[0]);
+            const __m128 wi = _mm_set1_ps(w[1]);
+            const __m128 sign = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+            for (; q + 2 <= s; q += 2) {
+                __m128 va = _mm_loadu_ps(a + 2 * q);
+                __m128 vb = _mm_loadu_ps(b + 2 * q);
+                _mm_storeu_ps(sum + 2 * q, _mm_add_ps(va, vb));
+
+                // (a - b) * w for two complex values at once
+                __m128 d = _mm_sub_ps(va, vb);
+                __m128 swapped = _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1));
+                __m128 product = _mm_add_ps(_mm_mul_ps(d, wr),
+                                            _mm_xor_ps(_mm_mul_ps(swapped, wi), sign));
+                _mm_storeu_ps(diff + 2 * q, product);
+            }
+#endif
+            for (; q < s; ++q) {
+                float ar = a[2 * q], ai = a[2 * q + 1];
+                float br = b[2 * q], bi = b[2 * q + 1];
+                float dr = ar - br, di = ai - bi;
+                sum[2 * q] = ar + br;
+                sum[2 * q + 1] = ai + bi;
+                diff[2 * q] = dr * w[0] - di * w[1];
+                diff[2 * q + 1] = dr * w[1] + di * w[0];
+            }
+        }
+
+        std::swap(x, y);
+    }
+
+    return x;
+}
+
+bool RealFFT::forward(const float* input, float* output) {
+    if (!plan) {
+        return false;
+    }
+
+    const size_t half = n / 2;
+    const float* z = transformHalf(input);
+    const float* twiddles = plan->twiddles.data();
+
+    // Split the half-size spectrum Z into the real spectrum X:
+    // X[k] = E[k] + W_N^k O[k], E = (Z[k] + Z*[M-k]) / 2, O = (Z[k] - Z*[M-k]) / 2i
+    output[0] = z[0] + z[1];
+    output[1] = 0.0f;
+    output[2 * half] = z[0] - z[1];
+    output[2 * half + 1] = 0.0f;
+
+    for (size_t k = 1; k < half; ++k) {
+        float zr = z[2 * k], zi = z[2 * k + 1];
+        float cr = z[2 * (half - k)], ci = -z[2 * (half - k) + 1];
+
+        float er = 0.5f * (zr + cr);
+        float ei = 0.5f * (zi + ci);
+        float orr = 0.5f * (zi - ci);
+        float oi = -0.5f * (zr - cr);
+
+        float wr = twiddles[2 * k], wi = twiddles[2 * k + 1];
+        output[2 * k] = er + orr * wr - oi * wi;
+        output[2 * k + 1] = ei + orr * wi + oi * wr;
+    }
+
+    return true;
+}
+
+bool RealFFT::powerSpectrum(const float* input, float* power) {
+    if (!forward(input, spectrum.data())) {
+        return false;
+    }
+
+    const size_t bins = getNumBins();
+    for (size_t k = 0; k < bins; ++k) {
+        float re = spectrum[2 * k];
+        float im = spectrum[2 * k + 1];
+        power[k] = re * re + im * im;
+    }
+    return true;
+}
@@ -0,0 +1,143 @@
+#include "Spectrogram.h"
+#include "RealFFT.h"
+#include <cmath>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// Floor for log10 so silent columns map to a finite value
+const double minPower = 1e-20;
+
+}
+
+Spectrogram::Spectrogram(size_t maxCachedTiles)
+    : maxTiles(std::max<size_t>(1, maxCachedTiles))
+{
+}
+
+Spectrogram::~Spectrogram() {
+}
+
+size_t Spectrogram::getNumColumns(size_t numSamples, size_t hop) {
+    return hop == 0 ? 0 : (numSamples + hop - 1) / hop;
+}
+
+size_t Spectrogram::getNumTiles(size_t numSamples, size_t hop) {
+    return (getNumColumns(numSamples, hop) + TILE_COLUMNS - 1) / TILE_COLUMNS;
+}
+
+std::shared_ptr<const SpectrogramTile> Spectrogram::getTile(const SampleBuffer::Ptr& buffer,
+                                                            size_t nfft,
+                                                            size_t hop,
+                                                            size_t tileIndex) {
+    if (!buffer || buffer->empty() || hop == 0 || nfft < 2 || !RealFFT::isPowerOfTwo(nfft) ||
+        tileIndex >= getNumTiles(buffer->size(), hop)) {
+        return nullptr;
+    }
+
+    Key key(buffer->getVersion(), hop, nfft, tileIndex);
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Compute outside the lock so other tiles load in parallel; two threads
+    // missing on the same key just compute it twice
+    std::shared_ptr<const SpectrogramTile> tile = computeTile(buffer->view(), nfft, hop, tileIndex);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        lru.splice(lru.begin(), lru, it->second);
+        return it->second->second;
+    }
+
+    lru.emplace_front(key, tile);
+    index[key] = lru.begin();
+    while (lru.size() > maxTiles) {
+        index.erase(lru.back().first);
+        lru.pop_back();
+    }
+    return tile;
+}
+
+size_t Spectrogram::getCachedTileCount() const {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return lru.size();
+}
+
+void Spectrogram::clearCache() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    index.clear();
+    lru.clear();
+}
+
+std::shared_ptr<SpectrogramTile> Spectrogram::computeTile(SampleView samples,
+                                                          size_t nfft,
+                                                          size_t hop,
+                                                          size_t tileIndex) {
+    const size_t totalColumns = getNumColumns(samples.size(), hop);
+    const size_t firstColumn = tileIndex * TILE_COLUMNS;
+    const size_t numColumns = std::min(TILE_COLUMNS, totalColumns - firstColumn);
+
+    auto tile = std::make_shared<SpectrogramTile>();
+    tile->firstColumn = firstColumn;
+    tile->numColumns = numColumns;
+    tile->numBins = nfft / 2 + 1;
+    tile->powerDb.resize(numColumns * tile->numBins);
+
+    // Periodic Hann window; spectrum scaling makes a sine of amplitude A
+    // read A^2/2 in its bin, independent of nfft
+    std::vector<float> window(nfft);
+    double windowSum = 0.0;
+    for (size_t i = 0; i < nfft; ++i) {
+        window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / nfft));
+        windowSum += window[i];
+    }
+    const double scale = 1.0 / (windowSum * windowSum);
+
+    RealFFT fft(nfft);
+    std::vector<float> frame(nfft);
+    std::vector<float> power(tile->numBins);
+    const long long half = static_cast<long long>(nfft / 2);
+    const long long size = static_cast<long long>(samples.size());
+
+    for (size_t c = 0; c < numColumns; ++c) {
+        // Frame centred on the column's sample; zero outside the recording
+        const long long start = static_cast<long long>((firstColumn + c) * hop) - half;
+        const long long from = std::max(0LL, start);
+        const long long to = std::min(size, start + static_cast<long long>(nfft));
+
+        double mean = 0.0;
+        for (long long i = from; i < to; ++i) {
+            mean += samples[static_cast<size_t>(i)];
+        }
+        mean = to > from ? mean / static_cast<double>(to - from) : 0.0;
+
+        std::fill(frame.begin(), frame.end(), 0.0f);
+        for (long long i = from; i < to; ++i) {
+            size_t j = static_cast<size_t>(i - start);
+            frame[j] = static_cast<float>(samples[static_cast<size_t>(i)] - mean) * window[j];
+        }
+
+        fft.powerSpectrum(frame.data(), power.data());
+
+        float* column = &tile->powerDb[c * tile->numBins];
+        for (size_t k = 0; k < tile->numBins; ++k) {
+            bool folded = k > 0 && k < nfft / 2;
+            double value = power[k] * scale * (folded ? 2.0 : 1.0);
+            column[k] = static_cast<float>(10.0 * std::log10(std::max(value, minPower)));
+        }
+    }
+
+    return tile;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file bench_acq_reader.cpp
+ * @brief Benchmark: native ACQReader vs. Python converter + binary reload
+ *
+ * Compile separately with:
+ * g++ -std=c++17 -O2 -I../inc/backend -I../inc/models -I../../thirdparty bench_acq_reader.cpp ../src/backend/ACQReader.cpp ../src/backend/ACQDataLoader.cpp ../src/backend/DataAnalyzer.cpp ../src/backend/RealFFT.cpp ../src/models/ChannelData.cpp ../src/models/MappedFile.cpp ../src/models/SampleBuffer.cpp ../src/models/RangeIndex.cpp ../src/models/WaveformPyramid.cpp ../src/models/ACQMetadata.cpp -o bench_acq_reader -pthread
+ *
+ * Usage:
+ * ./bench_acq_reader <file.acq> [path/to/batch_acq_converter.py]
+ */
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <algorithm>
+#include "ACQReader.h"
+#include "ACQDataLoader.h"
+
+namespace fs = std::filesystem;
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Native path: parse and decode the ACQ file in-process
+ */
+std::shared_ptr<ACQFileMetadata> runNative(const std::string& acqFile, double& ms) {
+    auto start = Clock::now();
+    ACQReader reader;
+    auto fileMetadata = reader.readFile(acqFile);
+    ms = elapsedMs(start);
+
+    if (!fileMetadata) {
+        std::cerr << "Native reader failed: " << reader.getLastError() << std::endl;
+    }
+    return fileMetadata;
+}
+
+/**
+ * @brief Current path: Python converter to temp dir, then reload .bin files
+ */
+std::shared_ptr<ACQFileMetadata> runPython(const std::string& acqFile,
+                                           const std::string& script,
+                                           double& ms) {
+    fs::path tempDir = fs::temp_directory_path() / "acq_reader_bench";
+    fs::remove_all(tempDir);
+    fs::create_directories(tempDir);
+
+    auto start = Clock::now();
+
+    std::string command = "python3 \"" + script + "\" \"" + tempDir.string() +
+                          "\" \"" + acqFile + "\" > /dev/null";
+    if (std::system(command.c_str()) != 0) {
+        std::cerr << "Python converter failed" << std::endl;
+        ms = elapsedMs(start);
+        return nullptr;
+    }
+
+    ACQDataLoader loader;
+    auto metadata = loader.loadMetadata((tempDir / "metadata.json").string());
+    if (!metadata || metadata->getFiles().empty()) {
+        ms = elapsedMs(start);
+        return nullptr;
+    }
+
+    auto fileMetadata = metadata->getFiles().back();
+    loader.loadBinaryData(fileMetadata, tempDir.string());
+    ms = elapsedMs(start);
+
+    fs::remove_all(tempDir);
+    return fileMetadata;
+}
+
+/**
+ * @brief Compare the channels produced by both paths
+ */
+void compareResults(const ACQFileMetadata& native, const ACQFileMetadata& python) {
+    const auto& a = native.getChannels();
+    const auto& b = python.getChannels();
+
+    std::cout << "\nChannels: native=" << a.size() << ", python=" << b.size() << std::endl;
+
+    for (size_t c = 0; c < std::min(a.size(), b.size()); ++c) {
+        const auto& da = a[c]->getData();
+        const auto& db = b[c]->getData();
+
+        float maxDiff = 0.0f;
+        for (size_t i = 0; i < std::min(da.size(), db.size()); ++i) {
+            maxDiff = std::max(maxDiff, std::abs(da[i] - db[i]));
+        }
+
+        std::cout << "  Channel " << c << " (" << a[c]->getName() << "): "
+                  << da.size() << " vs " << db.size() << " samples, "
+                  << a[c]->getSampleRate() << " vs " << b[c]->getSampleRate() << " Hz, "
+                  << "max |diff| = " << maxDiff << std::endl;
+
+        // Native statistics vs. the converter's numpy values from metadata.json
+        std::cout << "    stats: min " << a[c]->getMin() << "/" << b[c]->getMin()
+                  << ", max " << a[c]->getMax() << "/" << b[c]->getMax()
+                  << ", mean " << a[c]->getMean() << "/" << b[c]->getMean()
+                  << ", std " << a[c]->getStd() << "/" << b[c]->getStd() << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <file.acq> [batch_acq_converter.py]" << std::endl;
+        return 1;
+    }
+
+    std::string acqFile = argv[1];
+    std::string script = argc > 2 ? argv[2] : "../../python/batch_acq_converter.py";
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  ACQ Load Benchmark" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "File: " << acqFile << " (" << fs::file_size(acqFile) << " bytes)" << std::endl;
+
+    double nativeMs = 0.0;
+    auto native = runNative(acqFile, nativeMs);
+    std::cout << "\nNative ACQReader:       " << nativeMs << " ms" << std::endl;
+
+    double pythonMs = 0.0;
+    auto python = runPython(acqFile, script, pythonMs);
+    std::cout << "Python converter path:  " << pythonMs << " ms" << std::endl;
+
+    if (native && python) {
+        std::cout << "Speedup:                " << (pythonMs / nativeMs) << "x" << std::endl;
+        compareResults(*native, *python);
+    }
+
+    return native ? 0 : 1;
+}
@@ -1,16 +1,30 @@
 #include "ApplicationController.h"
+#include "FilterController.h"
 #include <QFileInfo>
+#include <QDateTime>
 #include <QDir>
 #include <QStandardPaths>
+#include <QTemporaryDir>
 #include <QPointF>
+#include <QThreadPool>
+#include <QElapsedTimer>
 #include <iostream>
-#include <fstream>
-#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <atomic>
+#include <thread>
 
 ApplicationController::ApplicationController(QObject *parent)
     : QObject(parent)
     , m_isLoading(false)
     , m_pythonProcess(nullptr)
+    , m_loadGeneration(0)
+    , m_conversionGeneration(-1)
+    , m_sourceSize(0)
+    , m_sourceModified(0)
+    , m_conversionSourceSize(0)
+    , m_conversionSourceModified(0)
 {
     // Create temp directory for converted files
     QString tempPath = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
@@ -18,14 +32,40 @@ ApplicationController::ApplicationController(QObject *parent)
     QDir().mkpath(m_tempOutputDir);
 
     std::cout << "Temp directory: " << m_tempOutputDir.toStdString() << std::endl;
+
+    // Conversions clean out the temp directory, so the cache lives elsewhere
+    m_cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/channel_cache";
+    QDir().mkpath(m_cacheDir);
 }
 
 ApplicationController::~ApplicationController() {
-    if (m_pythonProcess) {
+    // Discard any running read before its result is queued to a dead object
+    m_loadGeneration = -1;
+    m_readPool.waitForDone();
+
+    stopPythonConverter();
+}
+
+int ApplicationController::beginLoad() {
+    // A conversion still running belongs to the load being superseded
+    stopPythonConverter();
+    return ++m_loadGeneration;
+}
+
+void ApplicationController::stopPythonConverter() {
+    if (!m_pythonProcess) {
+        return;
+    }
+
+    // Disconnected first, so the kill isn't reported as a failed load
+    m_pythonProcess->disconnect(this);
+    if (m_pythonProcess->state() != QProcess::NotRunning) {
+        std::cout << "Stopping superseded Python converter" << std::endl;
         m_pythonProcess->kill();
         m_pythonProcess->waitForFinished();
-        delete m_pythonProcess;
     }
+    delete m_pythonProcess;
+    m_pythonProcess = nullptr;
 }
 
 void ApplicationController::setStatusMessage(const QString& message) {
@@ -70,21 +110,263 @@ bool ApplicationController::loadACQFile(const QString& acqFilePath) {
     emit currentFileChanged();
 
     setIsLoading(true);
-    setStatusMessage("Converting ACQ file...");
+    setStatusMessage("Reading ACQ file...");
 
-    // Call Python converter
-    return callPythonConverter(acqFilePath);
+    // Decode natively; the Python converter is only used as a fallback
+    readNativeACQ(acqFilePath);
+    return true;
 }
 
-bool ApplicationController::callPythonConverter(const QString& acqFilePath) {
-    // Clear temp directory before conversion to avoid stale data
+bool ApplicationController::loadFile(const QString& filePath) {
+    const std::string path = filePath.toStdString();
+    if (!ArrayFileReader::isArrayFile(path) && !EdfReader::isEdfFile(path)) {
+        return loadACQFile(filePath);
+    }
+
+    QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists()) {
+        setStatusMessage("Error: File does not exist");
+        emit conversionFailed("File not found: " + filePath);
+        return false;
+    }
+
+    m_currentFile = filePath;
+    emit currentFileChanged();
+
+    setIsLoading(true);
+    setStatusMessage("Reading file...");
+    readDataFile(filePath);
+    return true;
+}
+
+void ApplicationController::readDataFile(const QString& filePath) {
+    int generation = beginLoad();
+    emit conversionProgress(10, "Reading file...");
+
+    m_readPool.start([this, generation, filePath]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        const std::string path = filePath.toStdString();
+        std::shared_ptr<ACQFileMetadata> fileMetadata;
+        std::vector<EdfReader::Annotation> annotations;
+        QString error;
+        if (EdfReader::isEdfFile(path)) {
+            EdfReader reader;
+            fileMetadata = reader.readFile(path);
+            annotations = reader.getAnnotations();
+            error = QString::fromStdString(reader.getLastError());
+        } else {
+            ArrayFileReader reader;
+            fileMetadata = reader.readFile(path);
+            error = QString::fromStdString(reader.getLastError());
+        }
+
+        buildPyramids(fileMetadata);
+        std::cout << "File read took " << timer.elapsed() << " ms" << std::endl;
+
+        QMetaObject::invokeMethod(this, [this, generation, fileMetadata, annotations, error]() {
+            if (generation != m_loadGeneration) {
+                return;  // A newer load superseded this one
+            }
+
+            setIsLoading(false);
+            if (fileMetadata && loadFileMetadata(fileMetadata)) {
+                emit conversionProgress(100, "Loading data...");
+                setStatusMessage("File loaded successfully");
+                emit conversionComplete();
+
+                // Annotations become labels on the displayed channel
+                if (!annotations.empty()) {
+                    QVariantList labels;
+                    const double rate = m_channelData->getSampleRate();
+                    for (const auto& annotation : annotations) {
+                        qint64 start = std::llround(annotation.onset * rate);
+                        qint64 end = std::max(start + 1, std::llround((annotation.onset + annotation.duration) * rate));
+                        QVariantMap label;
+                        label["startIndex"] = start;
+                        label["endIndex"] = end;
+                        label["label"] = QString::fromStdString(annotation.text);
+                        labels.append(label);
+                    }
+                    emit annotationsLoaded(labels);
+                }
+            } else {
+                std::cerr << "File read failed: " << error.toStdString() << std::endl;
+                setStatusMessage("Error: Failed to load file");
+                emit conversionFailed(error.isEmpty() ? QString("Failed to load data") : error);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ApplicationController::readNativeACQ(const QString& acqFilePath) {
+    int generation = beginLoad();
+    emit conversionProgress(10, "Reading ACQ file...");
+
+    // Stamp taken before reading: a file changed during the read then
+    // yields a cache that is already stale, never one that looks current
+    QFileInfo sourceInfo(acqFilePath);
+    m_sourceSize = static_cast<uint64_t>(sourceInfo.size());
+    m_sourceModified = sourceInfo.lastModified().toMSecsSinceEpoch();
+    const uint64_t sourceSize = m_sourceSize;
+    const int64_t sourceModified = m_sourceModified;
+    const std::string cachePath = channelCachePath(acqFilePath).toStdString();
+    const std::string sourceName = sourceInfo.fileName().toStdString();
+
+    m_readPool.start([this, generation, acqFilePath, sourceSize, sourceModified,
+                      cachePath, sourceName]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        // An up-to-date cache replaces decoding entirely
+        ChannelCacheReader cacheReader;
+        auto fileMetadata = cacheReader.readFile(cachePath, sourceSize, sourceModified);
+        const bool fromCache = fileMetadata != nullptr;
+        QString error;
+
+        if (fromCache) {
+            fileMetadata->setSourceFile(sourceName);
+            std::cout << "Channel cache read took " << timer.elapsed() << " ms" << std::endl;
+        } else {
+            std::cout << "No channel cache: " << cacheReader.getLastError() << std::endl;
+
+            ACQReader reader;
+            fileMetadata = reader.readFile(acqFilePath.toStdString());
+            error = QString::fromStdString(reader.getLastError());
+
+            std::cout << "Native ACQ read took " << timer.elapsed() << " ms" << std::endl;
+        }
+
+        buildPyramids(fileMetadata);
+
+        QMetaObject::invokeMethod(this, [this, generation, fileMetadata, error, acqFilePath, fromCache]() {
+            onNativeReadFinished(generation, fileMetadata, error, acqFilePath, fromCache);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ApplicationController::buildPyramids(const std::shared_ptr<ACQFileMetadata>& fileMetadata) {
+    if (!fileMetadata) {
+        return;
+    }
+
+    // Built on the load worker, one channel per core, so the first frame
+    // (GUI or render thread) finds every pyramid ready
+    const auto& channels = fileMetadata->getChannels();
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t c = next++; c < channels.size(); c = next++) {
+            channels[c]->getPyramid();
+        }
+    };
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::min<size_t>(threads, channels.size()); ++t) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+QString ApplicationController::channelCachePath(const QString& acqFilePath) const {
+    // One cache file per recording path; the header tells whether it is current
+    QFileInfo fileInfo(acqFilePath);
+    size_t key = std::hash<std::string>()(fileInfo.absoluteFilePath().toStdString());
+    return m_cacheDir + "/" + fileInfo.completeBaseName() + "_" +
+           QString::fromStdString(std::to_string(key)) + ".acqc";
+}
+
+void ApplicationController::writeChannelCache(const std::vector<std::shared_ptr<ChannelData>>& channels,
+                                              const QString& acqFilePath,
+                                              uint64_t sourceSize,
+                                              int64_t sourceModified) {
+    auto writer = std::make_shared<ChannelCacheWriter>();
+    writer->setSource(sourceSize, sourceModified);
+
+    // Copies share the immutable sample buffers, so later edits of the
+    // loaded channels don't race with the writer
+    for (const auto& channel : channels) {
+        writer->addChannel(std::make_shared<ChannelData>(*channel));
+    }
+    const std::string cachePath = channelCachePath(acqFilePath).toStdString();
+
+    QThreadPool::globalInstance()->start([writer, cachePath]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        if (writer->writeFile(cachePath)) {
+            std::cout << "Wrote channel cache " << cachePath << " (" << writer->getBytesWritten()
+                      << " bytes) in " << timer.elapsed() << " ms" << std::endl;
+        } else {
+            std::cerr << "Channel cache not written: " << writer->getLastError() << std::endl;
+        }
+    });
+}
+
+void ApplicationController::onNativeReadFinished(int generation,
+                                                 std::shared_ptr<ACQFileMetadata> fileMetadata,
+                                                 const QString& error,
+                                                 const QString& acqFilePath,
+                                                 bool fromCache) {
+    if (generation != m_loadGeneration) {
+        return;  // A newer load superseded this one
+    }
+
+    if (!fileMetadata) {
+        std::cerr << "Native ACQ reader failed: " << error.toStdString() << std::endl;
+        std::cout << "Falling back to Python converter" << std::endl;
+        setStatusMessage("Converting ACQ file...");
+        callPythonConverter(acqFilePath, generation);
+        return;
+    }
+
+    setIsLoading(false);
+    emit conversionProgress(100, "Loading data...");
+
+    if (loadFileMetadata(fileMetadata)) {
+        if (!fromCache) {
+            writeChannelCache(fileMetadata->getChannels(), acqFilePath, m_sourceSize, m_sourceModified);
+        }
+        setStatusMessage("File loaded successfully");
+        emit conversionComplete();
+    } else {
+        setStatusMessage("Error: Failed to load ACQ data");
+        emit conversionFailed("Failed to load data");
+    }
+}
+
+bool ApplicationController::callPythonConverter(const QString& acqFilePath, int generation) {
+    stopPythonConverter();
+
+    // Loaded channels keep their converted .bin files mapped, which blocks
+    // deleting or overwriting them on Windows. Each conversion therefore
+    // writes to a fresh subdirectory; older ones are removed where possible
+    // and otherwise left for a later conversion to clean up.
     QDir tempDir(m_tempOutputDir);
-    if (tempDir.exists()) {
-        std::cout << "Cleaning temp directory..." << std::endl;
-        tempDir.removeRecursively();
-        tempDir.mkpath(".");
+    tempDir.mkpath(".");
+    std::cout << "Cleaning temp directory..." << std::endl;
+    for (const QFileInfo& entry : tempDir.entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot)) {
+        if (entry.isDir()) {
+            QDir(entry.absoluteFilePath()).removeRecursively();
+        } else {
+            QFile::remove(entry.absoluteFilePath());
+        }
     }
 
+    QTemporaryDir conversionDir(m_tempOutputDir + "/conversion_XXXXXX");
+    if (!conversionDir.isValid()) {
+        setStatusMessage("Error: Failed to create temp directory");
+        setIsLoading(false);
+        emit conversionFailed("Cannot create " + m_tempOutputDir);
+        return false;
+    }
+    conversionDir.setAutoRemove(false);
+    m_conversionDir = conversionDir.path();
+
     // Find Python converter script
     QString scriptPath = QDir::currentPath() + "/python/batch_acq_converter.py";
 
@@ -101,12 +383,14 @@ bool ApplicationController::callPythonConverter(const QString& acqFilePath) {
     }
 
     // Create Python process
-    if (m_pythonProcess) {
-        delete m_pythonProcess;
-    }
-
     m_pythonProcess = new QProcess(this);
 
+    // The cache written on success describes this recording, whatever loads since
+    m_conversionGeneration = generation;
+    m_conversionFile = acqFilePath;
+    m_conversionSourceSize = m_sourceSize;
+    m_conversionSourceModified = m_sourceModified;
+
     // Connect signals
     connect(m_pythonProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
             this, &ApplicationController::onPythonProcessFinished);
@@ -153,7 +437,7 @@ bool ApplicationController::callPythonConverter(const QString& acqFilePath) {
     // Build command
     QStringList arguments;
     arguments << scriptPath;
-    arguments << m_tempOutputDir;
+    arguments << m_conversionDir;
     arguments << acqFilePath;
 
     std::cout << "Running: " << pythonCmd.toStdString() << " "
@@ -188,6 +472,10 @@ void ApplicationController::onPythonProcessOutput() {
 }
 
 void ApplicationController::onPythonProcessFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (m_conversionGeneration != m_loadGeneration) {
+        return;  // A newer load superseded this conversion
+    }
+
     setIsLoading(false);
 
     if (exitStatus == QProcess::CrashExit || exitCode != 0) {
@@ -200,8 +488,9 @@ void ApplicationController::onPythonProcessFinished(int exitCode, QProcess::Exit
 
     emit conversionProgress(100, "Loading data...");
 
-    // Load converted data
+    // Load converted data; cached so the converter doesn't run again
     if (loadConvertedData()) {
+        writeChannelCache(m_channels, m_conversionFile, m_conversionSourceSize, m_conversionSourceModified);
         setStatusMessage("File loaded successfully");
         emit conversionComplete();
     } else {
@@ -211,6 +500,10 @@ void ApplicationController::onPythonProcessFinished(int exitCode, QProcess::Exit
 }
 
 void ApplicationController::onPythonProcessError(QProcess::ProcessError error) {
+    if (m_conversionGeneration != m_loadGeneration) {
+        return;
+    }
+
     setIsLoading(false);
 
     QString errorMsg;
@@ -234,7 +527,7 @@ void ApplicationController::onPythonProcessError(QProcess::ProcessError error) {
 
 bool ApplicationController::loadConvertedData() {
     // Load metadata.json from temp directory
-    QString metadataPath = m_tempOutputDir + "/metadata.json";
+    QString metadataPath = m_conversionDir + "/metadata.json";
 
     if (!QFile::exists(metadataPath)) {
         std::cerr << "Metadata file not found: " << metadataPath.toStdString() << std::endl;
@@ -259,13 +552,19 @@ bool ApplicationController::loadConvertedData() {
     std::cout << "Loading file: " << fileMetadata->getSourceFile()
               << " (" << fileMetadata->getNumChannels() << " channels)" << std::endl;
 
-    bool success = m_loader.loadBinaryData(fileMetadata, m_tempOutputDir.toStdString());
+    bool success = m_loader.loadBinaryData(fileMetadata, m_conversionDir.toStdString());
 
     if (!success) {
         std::cerr << "Failed to load binary data" << std::endl;
         return false;
     }
 
+    // Still part of the load, not of the first frame drawn
+    buildPyramids(fileMetadata);
+    return loadFileMetadata(fileMetadata);
+}
+
+bool ApplicationController::loadFileMetadata(std::shared_ptr<ACQFileMetadata> fileMetadata) {
     const auto& channels = fileMetadata->getChannels();
     if (channels.empty()) {
         std::cerr << "No channels found" << std::endl;
@@ -274,7 +573,14 @@ bool ApplicationController::loadConvertedData() {
 
     // Load first channel
     m_channelData = channels[0];
-    m_originalData = std::make_shared<ChannelData>(*m_channelData);  // Keep original copy
+    m_originalData = std::make_shared<ChannelData>(*m_channelData);  // Keep original for reset
+
+    // Copies share the same SampleBuffer until one is given new data
+    m_channels = channels;
+    m_originalChannels.clear();
+    for (const auto& channel : channels) {
+        m_originalChannels.push_back(std::make_shared<ChannelData>(*channel));
+    }
 
     std::cout << "Loaded channel: " << m_channelData->getName() << std::endl;
     std::cout << "Samples: " << m_channelData->getNumSamples() << std::endl;
@@ -304,29 +610,14 @@ bool ApplicationController::loadConvertedData() {
     return true;
 }
 
-QVariantList ApplicationController::vectorToVariantList(const std::vector<float>& data, int maxPoints) {
+QVariantList ApplicationController::bucketsToVariantList(const std::vector<WaveformBucket>& buckets) {
     QVariantList result;
+    result.reserve(static_cast<int>(buckets.size() * 2));
 
-    if (data.empty()) {
-        return result;
-    }
-
-    size_t numPoints = data.size();
-
-    // Downsample if needed
-    if (maxPoints > 0 && static_cast<int>(numPoints) > maxPoints) {
-        int step = numPoints / maxPoints;
-        for (size_t i = 0; i < numPoints; i += step) {
-            result.append(QPointF(i, data[i]));
-        }
-        // Always include last point
-        if (numPoints - 1 != result.last().toPointF().x()) {
-            result.append(QPointF(numPoints - 1, data.back()));
-        }
-    } else {
-        // Return all points
-        for (size_t i = 0; i < numPoints; ++i) {
-            result.append(QPointF(i, data[i]));
+    for (const auto& bucket : buckets) {
+        result.append(QPointF(bucket.index, bucket.min));
+        if (bucket.max != bucket.min) {
+            result.append(QPointF(bucket.index, bucket.max));
         }
     }
 
@@ -338,7 +629,47 @@ QVariantList ApplicationController::getWaveformData(int maxPoints) {
         return QVariantList();
     }
 
-    return vectorToVariantList(m_channelData->getData(), maxPoints);
+    // Two points (min and max) per bucket
+    qint64 numPoints = static_cast<qint64>(m_channelData->getData().size());
+    return getWaveformRange(0, numPoints, maxPoints > 0 ? std::max(1, maxPoints / 2) : 0);
+}
+
+QVariantList ApplicationController::getWaveformRange(qint64 startSample, qint64 endSample, int pixelWidth) {
+    if (!m_channelData || m_channelData->getData().empty()) {
+        return QVariantList();
+    }
+
+    qint64 numPoints = static_cast<qint64>(m_channelData->getData().size());
+    startSample = std::max<qint64>(0, startSample);
+    endSample = std::min(endSample, numPoints);
+    if (startSample >= endSample) {
+        return QVariantList();
+    }
+
+    size_t buckets = pixelWidth > 0 ? static_cast<size_t>(pixelWidth)
+                                    : static_cast<size_t>(endSample - startSample);
+
+    return bucketsToVariantList(m_channelData->getPyramid().getEnvelope(
+        static_cast<size_t>(startSample), static_cast<size_t>(endSample), buckets));
+}
+
+QVariantMap ApplicationController::getWaveformExtent(qint64 startSample, qint64 endSample) {
+    if (!m_channelData || startSample < 0 || endSample <= startSample) {
+        return QVariantMap();
+    }
+
+    float minVal = 0.0f;
+    float maxVal = 0.0f;
+    if (!m_channelData->getPyramid().getMinMax(static_cast<size_t>(startSample),
+                                               static_cast<size_t>(endSample),
+                                               minVal, maxVal)) {
+        return QVariantMap();
+    }
+
+    QVariantMap map;
+    map["min"] = minVal;
+    map["max"] = maxVal;
+    return map;
 }
 
 QVariantList ApplicationController::getCurrentWaveformData(int maxPoints) {
@@ -359,6 +690,45 @@ void ApplicationController::updateWaveform(const std::vector<float>& filteredDat
     emit waveformUpdated();
 }
 
+void ApplicationController::updateWaveform(std::vector<float>&& filteredData) {
+    if (!m_channelData) {
+        return;
+    }
+
+    std::cout << "Updating waveform with " << filteredData.size() << " filtered samples" << std::endl;
+
+    m_channelData->setData(std::move(filteredData));
+
+    emit waveformUpdated();
+}
+
+bool ApplicationController::commitFilterResult(int resultId) {
+    if (!m_channelData || !m_filterController) {
+        std::cerr << "ERROR: No channel data available" << std::endl;
+        return false;
+    }
+
+    auto result = m_filterController->takeResult(resultId);
+    if (!result) {
+        std::cerr << "ERROR: Filter result " << resultId << " is no longer available" << std::endl;
+        return false;
+    }
+
+    if (result->size() != m_channelData->getData().size()) {
+        std::cerr << "ERROR: Filter result has " << result->size() << " samples, channel has "
+                  << m_channelData->getData().size() << std::endl;
+        return false;
+    }
+
+    std::cout << "Committing filter result " << resultId << std::endl;
+
+    // The result is already an immutable buffer; the channel just shares it
+    m_channelData->setBuffer(std::move(result));
+
+    emit waveformUpdated();
+    return true;
+}
+
 void ApplicationController::applyFilteredData(const QVariantList& filteredPoints) {
     if (!m_channelData) {
         std::cerr << "ERROR: No channel data available" << std::endl;
@@ -393,6 +763,19 @@ void ApplicationController::applyFilteredData(const QVariantList& filteredPoints
     }
 }
 
+void ApplicationController::updateChannels(const std::vector<std::shared_ptr<ChannelData>>& channels) {
+    if (channels.empty()) {
+        return;
+    }
+
+    std::cout << "Updating " << channels.size() << " channels with filtered data" << std::endl;
+
+    m_channels = channels;
+    m_channelData = channels[0];
+
+    emit waveformUpdated();
+}
+
 void ApplicationController::resetToOriginal() {
     if (!m_originalData) {
         std::cerr << "ERROR: No original data available to reset" << std::endl;
@@ -401,8 +784,18 @@ void ApplicationController::resetToOriginal() {
 
     std::cout << "Resetting to original unfiltered data..." << std::endl;
 
-    // Create a fresh copy of the original data
-    m_channelData = std::make_shared<ChannelData>(*m_originalData);
+    // Fresh channel objects over the original buffers; no samples are copied
+    m_channels.clear();
+    for (const auto& channel : m_originalChannels) {
+        m_channels.push_back(std::make_shared<ChannelData>(*channel));
+    }
+
+    // The displayed channel stays the first one, so exports see its filtering
+    if (!m_channels.empty()) {
+        m_channelData = m_channels.front();
+    } else {
+        m_channelData = std::make_shared<ChannelData>(*m_originalData);
+    }
 
     std::cout << "  Restored " << m_channelData->getNumSamples() << " samples" << std::endl;
     std::cout << "  Sample rate: " << m_channelData->getSampleRate() << " Hz" << std::endl;
@@ -414,35 +807,215 @@ void ApplicationController::resetToOriginal() {
     std::cout << "Reset to original data complete" << std::endl;
 }
 
-bool ApplicationController::exportToCSV(const QString& filePath) {
+bool ApplicationController::exportToCSV(const QString& filePath, bool allChannels,
+                                        double startTime, double endTime) {
     if (!m_channelData) {
         std::cerr << "ERROR: No data to export" << std::endl;
         return false;
     }
 
-    std::cout << "Exporting data to CSV: " << filePath.toStdString() << std::endl;
+    CsvExporter exporter;
+    addCsvColumns(exporter, allChannels);
+
+    // Time range in rows of the fastest exported channel
+    if (startTime >= 0.0 || endTime >= 0.0) {
+        double rate = exporter.getRowRate();
+        size_t start = startTime > 0.0 ? static_cast<size_t>(std::floor(startTime * rate)) : 0;
+        size_t end = endTime >= 0.0 ? static_cast<size_t>(std::ceil(endTime * rate)) : exporter.getNumRows();
+        exporter.addRange(start, end);
+    }
+
+    return writeCsv(exporter, filePath);
+}
+
+bool ApplicationController::exportLabelsToCSV(const QString& filePath, const QVariantList& labels,
+                                              bool allChannels) {
+    if (!m_channelData || m_channelData->getSampleRate() <= 0.0f) {
+        std::cerr << "ERROR: No data to export" << std::endl;
+        return false;
+    }
 
-    std::ofstream file(filePath.toStdString());
-    if (!file.is_open()) {
-        std::cerr << "ERROR: Failed to open file for writing: " << filePath.toStdString() << std::endl;
+    if (labels.isEmpty()) {
+        std::cerr << "ERROR: No labels to export" << std::endl;
         return false;
     }
 
-    // Write header
-    file << "Time (s),Amplitude (mV)" << std::endl;
+    CsvExporter exporter;
+    addCsvColumns(exporter, allChannels);
 
-    // Write data
-    const auto& data = m_channelData->getData();
-    float sampleRate = m_channelData->getSampleRate();
+    // Label indices are samples of the displayed channel
+    double scale = exporter.getRowRate() / m_channelData->getSampleRate();
+    for (const QVariant& item : labels) {
+        QVariantMap label = item.toMap();
+        qint64 start = label.value("startIndex").toLongLong();
+        qint64 end = label.value("endIndex").toLongLong();
+        if (start < 0 || end <= start) {
+            continue;
+        }
+        exporter.addRange(static_cast<size_t>(std::llround(start * scale)),
+                          static_cast<size_t>(std::llround(end * scale)),
+                          label.value("label").toString().toStdString());
+    }
+
+    return writeCsv(exporter, filePath);
+}
 
-    for (size_t i = 0; i < data.size(); ++i) {
-        float time = static_cast<float>(i) / sampleRate;
-        file << std::fixed << std::setprecision(6) << time << ","
-             << std::setprecision(6) << data[i] << std::endl;
+bool ApplicationController::exportArrays(const QString& filePath, bool allChannels) {
+    if (!m_channelData) {
+        std::cerr << "ERROR: No data to export" << std::endl;
+        return false;
+    }
+
+    ArrayFileWriter writer;
+    if (!allChannels || m_channels.empty()) {
+        writer.addArray(m_channelData->getName(), m_channelData->getBuffer(),
+                        m_channelData->getSampleRate(), m_channelData->getUnits());
+    } else {
+        for (const auto& channel : m_channels) {
+            writer.addArray(channel->getName(), channel->getBuffer(),
+                            channel->getSampleRate(), channel->getUnits());
+        }
     }
 
-    file.close();
+    return writeArrays(writer, filePath);
+}
+
+bool ApplicationController::exportLabelArrays(const QString& filePath, const QVariantList& labels,
+                                              bool allChannels) {
+    if (!m_channelData || m_channelData->getSampleRate() <= 0.0f) {
+        std::cerr << "ERROR: No data to export" << std::endl;
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ChannelData>> channels;
+    if (allChannels && !m_channels.empty()) {
+        channels = m_channels;
+    } else {
+        channels.push_back(m_channelData);
+    }
+
+    // One array per label (and channel); indices are samples of the
+    // displayed channel, rescaled to each channel's rate
+    ArrayFileWriter writer;
+    for (const QVariant& item : labels) {
+        QVariantMap label = item.toMap();
+        qint64 start = label.value("startIndex").toLongLong();
+        qint64 end = label.value("endIndex").toLongLong();
+        if (start < 0 || end <= start) {
+            continue;
+        }
+
+        std::string name = label.value("label").toString().toStdString() + "_" +
+                           std::to_string(label.value("id").toInt());
+        for (const auto& channel : channels) {
+            double scale = channel->getSampleRate() / m_channelData->getSampleRate();
+            writer.addArray(channels.size() > 1 ? name + "_" + channel->getName() : name,
+                            channel->getBuffer(),
+                            static_cast<size_t>(std::llround(start * scale)),
+                            static_cast<size_t>(std::llround(end * scale)),
+                            channel->getSampleRate(), channel->getUnits());
+        }
+    }
+
+    if (writer.getNumArrays() == 0) {
+        std::cerr << "ERROR: No labels to export" << std::endl;
+        return false;
+    }
+
+    return writeArrays(writer, filePath);
+}
+
+bool ApplicationController::exportToEDF(const QString& filePath, const QVariantList& labels) {
+    if (!m_channelData || m_channelData->getSampleRate() <= 0.0f) {
+        std::cerr << "ERROR: No data to export" << std::endl;
+        return false;
+    }
+
+    EdfWriter writer;
+    if (m_channels.empty()) {
+        writer.addChannel(m_channelData);
+    } else {
+        for (const auto& channel : m_channels) {
+            writer.addChannel(channel);
+        }
+    }
+
+    // Label indices are samples of the displayed channel
+    const double rate = m_channelData->getSampleRate();
+    for (const QVariant& item : labels) {
+        QVariantMap label = item.toMap();
+        qint64 start = label.value("startIndex").toLongLong();
+        qint64 end = label.value("endIndex").toLongLong();
+        if (start < 0 || end <= start) {
+            continue;
+        }
+        writer.addAnnotation(start / rate, (end - start) / rate,
+                             label.value("label").toString().toStdString());
+    }
+
+    std::cout << "Exporting EDF+ to: " << filePath.toStdString() << std::endl;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!writer.writeFile(filePath.toStdString())) {
+        std::cerr << "ERROR: EDF export failed: " << writer.getLastError() << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ Successfully exported to " << filePath.toStdString() << " ("
+              << writer.getRecordDuration() << " s data records) in "
+              << timer.elapsed() << " ms" << std::endl;
+    return true;
+}
+
+bool ApplicationController::writeArrays(ArrayFileWriter& writer, const QString& filePath) {
+    std::cout << "Exporting " << writer.getNumArrays() << " arrays to: "
+              << filePath.toStdString() << std::endl;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!writer.writeFile(filePath.toStdString())) {
+        std::cerr << "ERROR: Array export failed: " << writer.getLastError() << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ Successfully exported to " << filePath.toStdString()
+              << " in " << timer.elapsed() << " ms" << std::endl;
+    return true;
+}
+
+void ApplicationController::addCsvColumns(CsvExporter& exporter, bool allChannels) const {
+    if (!allChannels || m_channels.empty()) {
+        std::string units = m_channelData->getUnits().empty() ? "mV" : m_channelData->getUnits();
+        exporter.addColumn("Amplitude (" + units + ")", m_channelData->getBuffer(),
+                           m_channelData->getSampleRate());
+        return;
+    }
+
+    for (const auto& channel : m_channels) {
+        std::string header = channel->getName().empty()
+            ? "Channel " + std::to_string(channel->getIndex()) : channel->getName();
+        if (!channel->getUnits().empty()) {
+            header += " (" + channel->getUnits() + ")";
+        }
+        exporter.addColumn(header, channel->getBuffer(), channel->getSampleRate());
+    }
+}
+
+bool ApplicationController::writeCsv(CsvExporter& exporter, const QString& filePath) {
+    std::cout << "Exporting data to CSV: " << filePath.toStdString() << std::endl;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!exporter.exportToFile(filePath.toStdString())) {
+        std::cerr << "ERROR: CSV export failed: " << exporter.getLastError() << std::endl;
+        return false;
+    }
 
-    std::cout << "✓ Successfully exported " << data.size() << " samples to " << filePath.toStdString() << std::endl;
+    std::cout << "✓ Successfully exported " << exporter.getRowsWritten() << " rows to "
+              << filePath.toStdString() << " in " << timer.elapsed() << " ms" << std::endl;
     return true;
 }
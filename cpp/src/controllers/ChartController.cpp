@@ -63,11 +63,12 @@ QVariantList ChartController::getDownsampledData(int targetPoints) {
         return QVariantList();
     }
 
-    return downsampleData(m_channelData->getData(), targetPoints);
+    return downsampleData(*m_channelData, targetPoints);
 }
 
-QVariantList ChartController::downsampleData(const std::vector<float>& data, int targetPoints) {
+QVariantList ChartController::downsampleData(const ChannelData& channel, int targetPoints) {
     QVariantList result;
+    SampleView data = channel.getData();
 
     if (data.empty() || targetPoints <= 0) {
         return result;
@@ -81,18 +82,16 @@ QVariantList ChartController::downsampleData(const std::vector<float>& data, int
         return result;
     }
 
-    // Simple decimation: take every nth point
-    int step = data.size() / targetPoints;
+    // Min/max envelope from the pyramid: two points per bucket keeps
+    // peaks that plain decimation would skip over
+    size_t buckets = static_cast<size_t>(std::max(1, targetPoints / 2));
+    auto envelope = channel.getPyramid().getEnvelope(0, data.size(), buckets);
 
-    for (size_t i = 0; i < data.size(); i += step) {
-        result.append(QPointF(i, data[i]));
-    }
-
-    // Always include last point
-    if (result.size() > 0) {
-        QPointF lastPoint = result.last().toPointF();
-        if (static_cast<size_t>(lastPoint.x()) != data.size() - 1) {
-            result.append(QPointF(data.size() - 1, data.back()));
+    result.reserve(static_cast<int>(envelope.size() * 2));
+    for (const auto& bucket : envelope) {
+        result.append(QPointF(bucket.index, bucket.min));
+        if (bucket.max != bucket.min) {
+            result.append(QPointF(bucket.index, bucket.max));
         }
     }
 
@@ -1,14 +1,33 @@
 #include "FilterController.h"
 #include <QPointF>
+#include <QElapsedTimer>
 #include <iostream>
 #include <algorithm>
 
 FilterController::FilterController(QObject *parent)
     : QObject(parent)
+    , m_currentJob(std::make_shared<std::atomic<int>>(-1))
+    , m_nextJobId(0)
+    , m_isFiltering(false)
+    , m_resultJobId(-1)
+    , m_previewStart(0)
+    , m_previewEnd(0)
+    , m_previewWidth(1000)
+    , m_previewActive(false)
+    , m_previewFreq1(0.0f)
+    , m_previewFreq2(0.0f)
+    , m_previewOrder(4)
+    , m_previewZeroPhase(false)
 {
+    m_previewTimer.setSingleShot(true);
+    m_previewTimer.setInterval(PREVIEW_DEBOUNCE_MS);
+    connect(&m_previewTimer, &QTimer::timeout, this, &FilterController::refreshPreview);
 }
 
 FilterController::~FilterController() {
+    // Stop any running job before its completion is queued to a dead object
+    m_currentJob->store(-1);
+    m_jobPool.waitForDone();
 }
 
 void FilterController::setChannelData(std::shared_ptr<ChannelData> channel) {
@@ -24,6 +43,18 @@ void FilterController::setChannelData(std::shared_ptr<ChannelData> channel) {
     emit hasDataChanged();
 }
 
+void FilterController::setChannels(const std::vector<std::shared_ptr<ChannelData>>& channels) {
+    m_channels = channels;
+    m_filteredChannels.clear();
+}
+
+void FilterController::setIsFiltering(bool filtering) {
+    if (m_isFiltering != filtering) {
+        m_isFiltering = filtering;
+        emit isFilteringChanged();
+    }
+}
+
 void FilterController::setError(const QString& error) {
     m_lastError = error;
     emit lastErrorChanged();
@@ -71,7 +102,7 @@ bool FilterController::validateFilterParams(const QString& filterType,
     return true;
 }
 
-QVariantList FilterController::vectorToVariantList(const std::vector<float>& data, int maxPoints) {
+QVariantList FilterController::vectorToVariantList(SampleView data, int maxPoints) {
     QVariantList result;
 
     if (data.empty()) {
@@ -80,16 +111,10 @@ QVariantList FilterController::vectorToVariantList(const std::vector<float>& dat
 
     size_t numPoints = data.size();
 
-    // Apply downsampling if requested
+    // Apply downsampling if requested (min/max per bucket, two points each)
     if (maxPoints > 0 && static_cast<int>(numPoints) > maxPoints) {
-        int step = numPoints / maxPoints;
-        for (size_t i = 0; i < numPoints; i += step) {
-            result.append(QPointF(i, data[i]));
-        }
-        // Always include last point
-        if (static_cast<int>(numPoints - 1) != result.last().toPointF().x()) {
-            result.append(QPointF(numPoints - 1, data.back()));
-        }
+        size_t buckets = static_cast<size_t>(std::max(1, maxPoints / 2));
+        return bucketsToVariantList(WaveformPyramid::scanEnvelope(data, 0, numPoints, buckets));
     } else {
         // Return all points
         for (size_t i = 0; i < numPoints; ++i) {
@@ -100,16 +125,37 @@ QVariantList FilterController::vectorToVariantList(const std::vector<float>& dat
     return result;
 }
 
+QVariantList FilterController::bucketsToVariantList(const std::vector<WaveformBucket>& buckets) {
+    QVariantList result;
+    result.reserve(static_cast<int>(buckets.size() * 2));
+
+    for (const auto& bucket : buckets) {
+        result.append(QPointF(bucket.index, bucket.min));
+        if (bucket.max != bucket.min) {
+            result.append(QPointF(bucket.index, bucket.max));
+        }
+    }
+
+    return result;
+}
+
 QVariantList FilterController::getOriginalData(int maxPoints) {
     if (!m_channelData) {
         setError("No channel data loaded");
         return QVariantList();
     }
 
+    size_t numPoints = m_channelData->getData().size();
+    if (maxPoints > 0 && numPoints > static_cast<size_t>(maxPoints)) {
+        // Use the channel's pyramid rather than scanning all samples
+        size_t buckets = static_cast<size_t>(std::max(1, maxPoints / 2));
+        return bucketsToVariantList(m_channelData->getPyramid().getEnvelope(0, numPoints, buckets));
+    }
+
     return vectorToVariantList(m_channelData->getData(), maxPoints);
 }
 
-QVariantList FilterController::applyLowpass(float cutoffFreq, int order) {
+QVariantList FilterController::applyLowpass(float cutoffFreq, int order, bool zeroPhase) {
     if (!m_channelData) {
         setError("No channel data loaded");
         return QVariantList();
@@ -120,12 +166,13 @@ QVariantList FilterController::applyLowpass(float cutoffFreq, int order) {
     }
 
     std::cout << "Applying lowpass filter: cutoff=" << cutoffFreq
-              << " Hz, order=" << order << std::endl;
+              << " Hz, order=" << order
+              << (zeroPhase ? ", zero-phase" : "") << std::endl;
 
     const auto& data = m_channelData->getData();
     float sampleRate = m_channelData->getSampleRate();
 
-    auto filtered = m_dspFilters.lowpass(data, sampleRate, cutoffFreq, order);
+    auto filtered = m_dspFilters.lowpass(data, sampleRate, cutoffFreq, order, zeroPhase);
 
     if (!m_dspFilters.getLastError().empty()) {
         setError(QString::fromStdString(m_dspFilters.getLastError()));
@@ -136,7 +183,7 @@ QVariantList FilterController::applyLowpass(float cutoffFreq, int order) {
     return vectorToVariantList(filtered);
 }
 
-QVariantList FilterController::applyHighpass(float cutoffFreq, int order) {
+QVariantList FilterController::applyHighpass(float cutoffFreq, int order, bool zeroPhase) {
     if (!m_channelData) {
         setError("No channel data loaded");
         return QVariantList();
@@ -147,12 +194,13 @@ QVariantList FilterController::applyHighpass(float cutoffFreq, int order) {
     }
 
     std::cout << "Applying highpass filter: cutoff=" << cutoffFreq
-              << " Hz, order=" << order << std::endl;
+              << " Hz, order=" << order
+              << (zeroPhase ? ", zero-phase" : "") << std::endl;
 
     const auto& data = m_channelData->getData();
     float sampleRate = m_channelData->getSampleRate();
 
-    auto filtered = m_dspFilters.highpass(data, sampleRate, cutoffFreq, order);
+    auto filtered = m_dspFilters.highpass(data, sampleRate, cutoffFreq, order, zeroPhase);
 
     if (!m_dspFilters.getLastError().empty()) {
         setError(QString::fromStdString(m_dspFilters.getLastError()));
@@ -163,7 +211,8 @@ QVariantList FilterController::applyHighpass(float cutoffFreq, int order) {
     return vectorToVariantList(filtered);
 }
 
-QVariantList FilterController::applyBandpass(float lowCutoff, float highCutoff, int order) {
+QVariantList FilterController::applyBandpass(float lowCutoff, float highCutoff, int order,
+                                             bool zeroPhase) {
     if (!m_channelData) {
         setError("No channel data loaded");
         return QVariantList();
@@ -174,12 +223,13 @@ QVariantList FilterController::applyBandpass(float lowCutoff, float highCutoff,
     }
 
     std::cout << "Applying bandpass filter: low=" << lowCutoff
-              << " Hz, high=" << highCutoff << " Hz, order=" << order << std::endl;
+              << " Hz, high=" << highCutoff << " Hz, order=" << order
+              << (zeroPhase ? ", zero-phase" : "") << std::endl;
 
     const auto& data = m_channelData->getData();
     float sampleRate = m_channelData->getSampleRate();
 
-    auto filtered = m_dspFilters.bandpass(data, sampleRate, lowCutoff, highCutoff, order);
+    auto filtered = m_dspFilters.bandpass(data, sampleRate, lowCutoff, highCutoff, order, zeroPhase);
 
     if (!m_dspFilters.getLastError().empty()) {
         setError(QString::fromStdString(m_dspFilters.getLastError()));
@@ -190,7 +240,8 @@ QVariantList FilterController::applyBandpass(float lowCutoff, float highCutoff,
     return vectorToVariantList(filtered);
 }
 
-QVariantList FilterController::applyNotch(float lowCutoff, float highCutoff, int order) {
+QVariantList FilterController::applyNotch(float lowCutoff, float highCutoff, int order,
+                                          bool zeroPhase) {
     if (!m_channelData) {
         setError("No channel data loaded");
         return QVariantList();
@@ -201,12 +252,13 @@ QVariantList FilterController::applyNotch(float lowCutoff, float highCutoff, int
     }
 
     std::cout << "Applying notch filter: low=" << lowCutoff
-              << " Hz, high=" << highCutoff << " Hz, order=" << order << std::endl;
+              << " Hz, high=" << highCutoff << " Hz, order=" << order
+              << (zeroPhase ? ", zero-phase" : "") << std::endl;
 
     const auto& data = m_channelData->getData();
     float sampleRate = m_channelData->getSampleRate();
 
-    auto filtered = m_dspFilters.notch(data, sampleRate, lowCutoff, highCutoff, order);
+    auto filtered = m_dspFilters.notch(data, sampleRate, lowCutoff, highCutoff, order, zeroPhase);
 
     if (!m_dspFilters.getLastError().empty()) {
         setError(QString::fromStdString(m_dspFilters.getLastError()));
@@ -217,22 +269,415 @@ QVariantList FilterController::applyNotch(float lowCutoff, float highCutoff, int
     return vectorToVariantList(filtered);
 }
 
+QVariantList FilterController::applyPowerlineNotch(float frequency, float q, bool zeroPhase) {
+    if (!m_channelData) {
+        setError("No channel data loaded");
+        return QVariantList();
+    }
+
+    if (!validateFilterParams("powerline", frequency, 0.0f)) {
+        return QVariantList();
+    }
+
+    std::cout << "Applying powerline notch: " << frequency
+              << " Hz, Q=" << q
+              << (zeroPhase ? ", zero-phase" : "") << std::endl;
+
+    const auto& data = m_channelData->getData();
+    float sampleRate = m_channelData->getSampleRate();
+
+    auto filtered = m_dspFilters.narrowNotch(data, sampleRate, frequency, q, zeroPhase);
+
+    if (!m_dspFilters.getLastError().empty()) {
+        setError(QString::fromStdString(m_dspFilters.getLastError()));
+        return vectorToVariantList(data);
+    }
+
+    emit filterApplied("powerline");
+    return vectorToVariantList(filtered);
+}
+
 QVariantList FilterController::applyFilter(const QString& filterType,
                                            float freq1,
                                            float freq2,
-                                           int order) {
+                                           int order,
+                                           bool zeroPhase) {
     QString type = filterType.toLower();
 
     if (type == "lowpass") {
-        return applyLowpass(freq1, order);
+        return applyLowpass(freq1, order, zeroPhase);
     } else if (type == "highpass") {
-        return applyHighpass(freq1, order);
+        return applyHighpass(freq1, order, zeroPhase);
     } else if (type == "bandpass") {
-        return applyBandpass(freq1, freq2, order);
+        return applyBandpass(freq1, freq2, order, zeroPhase);
     } else if (type == "notch") {
-        return applyNotch(freq1, freq2, order);
+        return applyNotch(freq1, freq2, order, zeroPhase);
+    } else if (type == "powerline") {
+        return applyPowerlineNotch(freq1, freq2 > 0.0f ? freq2 : 30.0f, zeroPhase);
     } else {
         setError("Unknown filter type: " + filterType);
         return QVariantList();
     }
 }
+
+int FilterController::startFilter(const QString& filterType,
+                                  float freq1,
+                                  float freq2,
+                                  int order,
+                                  bool zeroPhase) {
+    DSPFilters::FilterType type;
+    if (!parseFilterType(filterType, type)) {
+        setError("Unknown filter type: " + filterType);
+        return -1;
+    }
+
+    if (!validateFilterParams(filterType.toLower(), freq1, freq2)) {
+        return -1;
+    }
+
+    if (type == DSPFilters::NARROW_NOTCH && freq2 <= 0.0f) {
+        freq2 = 30.0f;  // Default Q
+    }
+
+    // Superseding the current id makes the old worker's next progress
+    // check fail, so it stops instead of finishing a stale result
+    int jobId = ++m_nextJobId;
+    m_currentJob->store(jobId);
+    setIsFiltering(true);
+
+    std::cout << "Starting filter job " << jobId << ": " << filterType.toStdString()
+              << " " << freq1 << "/" << freq2 << " Hz, order=" << order
+              << (zeroPhase ? ", zero-phase" : "") << std::endl;
+
+    auto channel = m_channelData;
+    auto currentJob = m_currentJob;
+
+    m_jobPool.start([this, jobId, currentJob, channel, type,
+                     freq1, freq2, order, zeroPhase, filterType]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        DSPFilters filters;
+        int lastPercent = -1;
+        filters.setProgressCallback([this, jobId, currentJob, &lastPercent](double progress) {
+            if (currentJob->load() != jobId) {
+                return false;
+            }
+
+            int percent = static_cast<int>(progress * 100.0);
+            if (percent != lastPercent) {
+                lastPercent = percent;
+                QMetaObject::invokeMethod(this, [this, jobId, percent]() {
+                    emit filterProgress(jobId, percent);
+                }, Qt::QueuedConnection);
+            }
+            return true;
+        });
+
+        std::vector<float> samples = channel->getData().toVector();
+        bool success = filters.applyFilterInPlace(samples.data(), samples.size(),
+                                                  channel->getSampleRate(), type,
+                                                  freq1, freq2, order, zeroPhase);
+        QString error = QString::fromStdString(filters.getLastError());
+
+        // Freeze the samples and build the display pyramid here rather than
+        // on the GUI/render thread when the result is committed
+        SampleBuffer::Ptr result;
+        if (success) {
+            result = SampleBuffer::create(std::move(samples));
+            result->getPyramid();
+        }
+
+        std::cout << "Filter job " << jobId << (success ? " finished" : " stopped")
+                  << " after " << timer.elapsed() << " ms" << std::endl;
+
+        QMetaObject::invokeMethod(this, [this, jobId, success, error, result, filterType]() {
+            onFilterJobFinished(jobId, success, error, result, filterType);
+        }, Qt::QueuedConnection);
+    });
+
+    return jobId;
+}
+
+void FilterController::cancelFilter() {
+    if (m_isFiltering) {
+        std::cout << "Cancelling filter job " << m_currentJob->load() << std::endl;
+        m_currentJob->store(-1);
+        setIsFiltering(false);
+    }
+}
+
+void FilterController::onFilterJobFinished(int jobId,
+                                           bool success,
+                                           const QString& error,
+                                           SampleBuffer::Ptr result,
+                                           const QString& filterType) {
+    if (m_currentJob->load() != jobId) {
+        emit filterCancelled(jobId);
+        return;
+    }
+
+    setIsFiltering(false);
+
+    if (!success) {
+        setError(error);
+        return;
+    }
+
+    m_resultJobId = jobId;
+    m_result = result;
+
+    emit filterFinished(jobId, filterType);
+    emit filterApplied(filterType);
+}
+
+void FilterController::setPreviewRange(qint64 startSample, qint64 endSample, int pixelWidth) {
+    qint64 start = std::max<qint64>(0, startSample);
+    qint64 end = std::max(start, endSample);
+    int width = std::max(1, pixelWidth);
+    if (start == m_previewStart && end == m_previewEnd && width == m_previewWidth) {
+        return;
+    }
+
+    m_previewStart = start;
+    m_previewEnd = end;
+    m_previewWidth = width;
+
+    // Restarting the timer coalesces a pan or zoom gesture into one preview
+    if (m_previewActive) {
+        m_previewTimer.start();
+    }
+}
+
+bool FilterController::updatePreview(const QString& filterType,
+                                     float freq1,
+                                     float freq2,
+                                     int order,
+                                     bool zeroPhase) {
+    m_previewActive = true;
+    m_previewType = filterType;
+    m_previewFreq1 = freq1;
+    m_previewFreq2 = freq2;
+    m_previewOrder = order;
+    m_previewZeroPhase = zeroPhase;
+
+    m_previewTimer.stop();
+    return refreshPreview();
+}
+
+bool FilterController::refreshPreview() {
+    DSPFilters::FilterType type;
+    if (!m_channelData || !parseFilterType(m_previewType, type)) {
+        clearPreview();
+        return false;
+    }
+
+    // Out-of-range views hide the trace but keep following the range
+    qint64 numSamples = static_cast<qint64>(m_channelData->getData().size());
+    qint64 start = std::min(m_previewStart, numSamples);
+    qint64 end = std::min(m_previewEnd, numSamples);
+    if (start >= end || end - start > MAX_PREVIEW_SAMPLES) {
+        emit previewCleared();
+        return false;
+    }
+
+    float freq2 = m_previewFreq2;
+    if (type == DSPFilters::NARROW_NOTCH && freq2 <= 0.0f) {
+        freq2 = 30.0f;  // Default Q
+    }
+
+    auto filtered = m_dspFilters.applyFilterRange(m_channelData->getData(), start, end,
+                                                  m_channelData->getSampleRate(), type,
+                                                  m_previewFreq1, freq2, m_previewOrder,
+                                                  m_previewZeroPhase, MAX_PREVIEW_WARMUP);
+    if (!m_dspFilters.getLastError().empty()) {
+        emit previewCleared();
+        return false;
+    }
+
+    // One min/max pair per pixel, x in absolute sample indices
+    auto buckets = WaveformPyramid::scanEnvelope(filtered, 0, filtered.size(),
+                                                 static_cast<size_t>(m_previewWidth));
+    for (auto& bucket : buckets) {
+        bucket.index += static_cast<size_t>(start);
+    }
+
+    emit previewUpdated(bucketsToVariantList(buckets));
+    return true;
+}
+
+void FilterController::clearPreview() {
+    m_previewActive = false;
+    m_previewTimer.stop();
+    emit previewCleared();
+}
+
+SampleBuffer::Ptr FilterController::getResult(int jobId) const {
+    return jobId == m_resultJobId ? m_result : nullptr;
+}
+
+SampleBuffer::Ptr FilterController::takeResult(int jobId) {
+    if (jobId != m_resultJobId) {
+        return nullptr;
+    }
+
+    m_resultJobId = -1;
+    return std::move(m_result);
+}
+
+QVariantList FilterController::getResultData(int jobId, int maxPoints) {
+    auto result = getResult(jobId);
+    if (!result) {
+        return QVariantList();
+    }
+    return vectorToVariantList(result->view(), maxPoints);
+}
+
+bool FilterController::parseFilterType(const QString& filterType, DSPFilters::FilterType& type) {
+    QString name = filterType.toLower();
+
+    if (name == "lowpass") {
+        type = DSPFilters::LOWPASS;
+    } else if (name == "highpass") {
+        type = DSPFilters::HIGHPASS;
+    } else if (name == "bandpass") {
+        type = DSPFilters::BANDPASS;
+    } else if (name == "notch") {
+        type = DSPFilters::NOTCH;
+    } else if (name == "powerline") {
+        type = DSPFilters::NARROW_NOTCH;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int FilterController::startFilterAllChannels(const QString& filterType,
+                                            float freq1,
+                                            float freq2,
+                                            int order) {
+    DSPFilters::FilterType type;
+    if (!parseFilterType(filterType, type)) {
+        setError("Unknown filter type: " + filterType);
+        return -1;
+    }
+
+    if (m_channels.empty()) {
+        setError("No channel data loaded");
+        return -1;
+    }
+
+    if (!validateFilterParams(filterType.toLower(), freq1, freq2)) {
+        return -1;
+    }
+
+    if (type == DSPFilters::NARROW_NOTCH && freq2 <= 0.0f) {
+        freq2 = 30.0f;  // Default Q
+    }
+
+    int jobId = ++m_nextJobId;
+    m_currentJob->store(jobId);
+    setIsFiltering(true);
+
+    std::cout << "Starting filter job " << jobId << ": " << filterType.toStdString() << " on "
+              << m_channels.size() << " channels ("
+              << DSPFilters::getSimdLaneCount() << " SIMD lanes)" << std::endl;
+
+    auto channels = m_channels;
+    auto currentJob = m_currentJob;
+
+    m_jobPool.start([this, jobId, currentJob, channels, type,
+                     freq1, freq2, order, filterType]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        // Filter copies of the samples; channels with the same rate and length
+        // go through one multi-channel call so they share SIMD lanes
+        DSPFilters filters;
+        std::vector<std::vector<float>> buffers(channels.size());
+        std::vector<bool> done(channels.size(), false);
+        size_t numDone = 0;
+        bool success = true;
+        QString error;
+
+        for (size_t i = 0; i < channels.size(); ++i) {
+            if (done[i]) {
+                continue;
+            }
+
+            // Superseded or cancelled: stop before the next group
+            if (currentJob->load() != jobId) {
+                success = false;
+                break;
+            }
+
+            float sampleRate = channels[i]->getSampleRate();
+            size_t size = channels[i]->getData().size();
+
+            std::vector<float*> group;
+            for (size_t j = i; j < channels.size(); ++j) {
+                if (done[j] || channels[j]->getSampleRate() != sampleRate ||
+                    channels[j]->getData().size() != size) {
+                    continue;
+                }
+                buffers[j] = channels[j]->getData().toVector();
+                group.push_back(buffers[j].data());
+                done[j] = true;
+            }
+
+            if (!filters.applyFilterMultiChannel(group, size, sampleRate, type,
+                                                 freq1, freq2, order)) {
+                success = false;
+                error = QString::fromStdString(filters.getLastError());
+                break;
+            }
+
+            numDone += group.size();
+            int percent = static_cast<int>(100 * numDone / channels.size());
+            QMetaObject::invokeMethod(this, [this, jobId, percent]() {
+                emit filterProgress(jobId, percent);
+            }, Qt::QueuedConnection);
+        }
+
+        std::vector<std::shared_ptr<ChannelData>> filtered;
+        if (success) {
+            filtered.reserve(channels.size());
+            for (size_t i = 0; i < channels.size(); ++i) {
+                auto channel = std::make_shared<ChannelData>(*channels[i]);
+                channel->setData(std::move(buffers[i]));
+                channel->getPyramid();
+                filtered.push_back(channel);
+            }
+        }
+
+        std::cout << "Filter job " << jobId << (success ? " finished" : " stopped")
+                  << " after " << timer.elapsed() << " ms" << std::endl;
+
+        QMetaObject::invokeMethod(this, [this, jobId, success, error, filtered, filterType]() {
+            onAllChannelsJobFinished(jobId, success, error, filtered, filterType);
+        }, Qt::QueuedConnection);
+    });
+
+    return jobId;
+}
+
+void FilterController::onAllChannelsJobFinished(int jobId,
+                                                bool success,
+                                                const QString& error,
+                                                const std::vector<std::shared_ptr<ChannelData>>& filtered,
+                                                const QString& filterType) {
+    if (m_currentJob->load() != jobId) {
+        emit filterCancelled(jobId);
+        return;
+    }
+
+    setIsFiltering(false);
+
+    if (!success) {
+        setError(error);
+        return;
+    }
+
+    m_filteredChannels = filtered;
+    emit allChannelsFiltered(filterType);
+}
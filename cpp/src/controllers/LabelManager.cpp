@@ -1,4 +1,7 @@
 #include "LabelManager.h"
+#include "DataAnalyzer.h"
+#include "BufferedWriter.h"
+#include "JsonWriter.h"
 #include "json.hpp"
 #include <fstream>
 #include <iostream>
@@ -7,9 +10,29 @@
 
 using json = nlohmann::json;
 
+namespace {
+
+// "dir/x_labels.json" -> "dir/x_labels.f32"
+std::string sidecarPathFor(const std::string& jsonPath) {
+    const std::string suffix = ".json";
+    if (jsonPath.size() > suffix.size() &&
+        jsonPath.compare(jsonPath.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        return jsonPath.substr(0, jsonPath.size() - suffix.size()) + ".f32";
+    }
+    return jsonPath + ".f32";
+}
+
+std::string fileNameOf(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+}
+
 LabelManager::LabelManager(QObject *parent)
     : QObject(parent)
     , m_sampleRate(1000.0f)
+    , m_indexDirty(true)
 {
 }
 
@@ -37,32 +60,22 @@ int LabelManager::addLabel(int startIndex, int endIndex, const QString& labelTex
         label->setEndTime(endTime);
     }
 
-    // Extract voltage data for this segment
-    std::cout << "Extracting voltage data for label..." << std::endl;
-    std::cout << "  Total voltage data size: " << m_voltageData.size() << std::endl;
-    std::cout << "  Requested range: [" << startIndex << ", " << endIndex << ")" << std::endl;
-
-    if (!m_voltageData.empty() && startIndex < m_voltageData.size() && endIndex <= m_voltageData.size()) {
-        std::vector<float> segmentVoltages(
-            m_voltageData.begin() + startIndex,
-            m_voltageData.begin() + endIndex
-        );
-        label->setVoltageData(segmentVoltages);
-
-        std::cout << "  ✓ Extracted " << segmentVoltages.size() << " voltage samples" << std::endl;
-        if (!segmentVoltages.empty()) {
-            float minV = *std::min_element(segmentVoltages.begin(), segmentVoltages.end());
-            float maxV = *std::max_element(segmentVoltages.begin(), segmentVoltages.end());
-            std::cout << "  ✓ Voltage range: [" << minV << ", " << maxV << "] mV" << std::endl;
-        }
+    // Reference the segment in the channel buffer; samples are only read
+    // on export
+    label->setSource(m_voltageData);
+    size_t numSamples = m_voltageData ? m_voltageData->size() : 0;
+    std::cout << "Label references samples [" << startIndex << ", " << endIndex << ") of "
+              << numSamples << std::endl;
+
+    RangeStats stats;
+    if (segmentStatistics(*label, stats)) {
+        std::cout << "  ✓ Voltage range: [" << stats.min << ", " << stats.max << "] mV" << std::endl;
     } else {
-        std::cerr << "  ✗ WARNING: Cannot extract voltage data!" << std::endl;
-        std::cerr << "    Voltage data empty: " << m_voltageData.empty() << std::endl;
-        std::cerr << "    Start index valid: " << (startIndex < m_voltageData.size()) << std::endl;
-        std::cerr << "    End index valid: " << (endIndex <= m_voltageData.size()) << std::endl;
+        std::cerr << "  ✗ WARNING: Label range is outside the voltage data!" << std::endl;
     }
 
     m_labels.push_back(label);
+    m_indexDirty = true;
 
     emit labelCountChanged();
     emit labelsChanged();
@@ -83,6 +96,7 @@ bool LabelManager::removeLabel(int labelId) {
 
     if (it != m_labels.end()) {
         m_labels.erase(it, m_labels.end());
+        m_indexDirty = true;
 
         emit labelCountChanged();
         emit labelsChanged();
@@ -105,6 +119,11 @@ bool LabelManager::updateLabel(int labelId, int startIndex, int endIndex, const
     label->setEndIndex(endIndex);
     label->setLabel(labelText.toStdString());
     label->setColor(color.toStdString());
+    if (m_sampleRate > 0) {
+        label->setStartTime(static_cast<float>(startIndex) / m_sampleRate);
+        label->setEndTime(static_cast<float>(endIndex) / m_sampleRate);
+    }
+    m_indexDirty = true;
 
     emit labelsChanged();
     emit labelUpdated(labelId);
@@ -112,8 +131,18 @@ bool LabelManager::updateLabel(int labelId, int startIndex, int endIndex, const
     return true;
 }
 
+void LabelManager::setVoltageData(SampleBuffer::Ptr data) {
+    m_voltageData = std::move(data);
+
+    // Labels store indices only, so rebinding is O(labels)
+    for (auto& label : m_labels) {
+        label->setSource(m_voltageData);
+    }
+}
+
 void LabelManager::clearLabels() {
     m_labels.clear();
+    m_indexDirty = true;
 
     emit labelCountChanged();
     emit labelsChanged();
@@ -122,38 +151,64 @@ void LabelManager::clearLabels() {
 }
 
 QVariantMap LabelManager::getLabelAt(int sampleIndex) {
-    for (const auto& label : m_labels) {
-        if (label->contains(sampleIndex)) {
-            QVariantMap map;
-            map["id"] = label->getId();
-            map["startIndex"] = static_cast<int>(label->getStartIndex());
-            map["endIndex"] = static_cast<int>(label->getEndIndex());
-            map["label"] = QString::fromStdString(label->getLabel());
-            map["color"] = QString::fromStdString(label->getColor());
-            return map;
-        }
+    if (sampleIndex < 0) {
+        return QVariantMap();
+    }
+
+    auto label = labelIndex().findAt(static_cast<size_t>(sampleIndex));
+    if (label) {
+        return labelToVariant(*label);
     }
 
     return QVariantMap();  // Empty map if not found
 }
 
+QVariantList LabelManager::getLabelsInRange(qint64 startIndex, qint64 endIndex) {
+    QVariantList result;
+
+    if (endIndex < 0 || startIndex > endIndex) {
+        return result;
+    }
+
+    auto labels = labelIndex().findOverlapping(static_cast<size_t>(std::max<qint64>(0, startIndex)),
+                                               static_cast<size_t>(endIndex));
+    result.reserve(static_cast<int>(labels.size()));
+    for (const auto& label : labels) {
+        result.append(labelToVariant(*label));
+    }
+
+    return result;
+}
+
 QVariantList LabelManager::getLabelsAsVariant() const {
     QVariantList result;
 
     for (const auto& label : m_labels) {
-        QVariantMap map;
-        map["id"] = label->getId();
-        map["startIndex"] = static_cast<int>(label->getStartIndex());
-        map["endIndex"] = static_cast<int>(label->getEndIndex());
-        map["label"] = QString::fromStdString(label->getLabel());
-        map["color"] = QString::fromStdString(label->getColor());
-        result.append(map);
+        result.append(labelToVariant(*label));
     }
 
     return result;
 }
 
-bool LabelManager::saveToFile(const QString& filePath) {
+const LabelIntervalIndex& LabelManager::labelIndex() const {
+    if (m_indexDirty) {
+        m_index.build(m_labels);
+        m_indexDirty = false;
+    }
+    return m_index;
+}
+
+QVariantMap LabelManager::labelToVariant(const SegmentLabel& label) {
+    QVariantMap map;
+    map["id"] = label.getId();
+    map["startIndex"] = static_cast<int>(label.getStartIndex());
+    map["endIndex"] = static_cast<int>(label.getEndIndex());
+    map["label"] = QString::fromStdString(label.getLabel());
+    map["color"] = QString::fromStdString(label.getColor());
+    return map;
+}
+
+bool LabelManager::saveToFile(const QString& filePath, bool binarySidecar) {
     std::cout << "\n========================================" << std::endl;
     std::cout << "SAVING LABELS TO FILE" << std::endl;
     std::cout << "========================================" << std::endl;
@@ -165,78 +220,98 @@ bool LabelManager::saveToFile(const QString& filePath) {
         return false;
     }
 
-    json j;
-    j["labels"] = json::array();
-
-    int labelIndex = 0;
-    for (const auto& label : m_labels) {
-        std::cout << "\nLabel #" << (labelIndex + 1) << ":" << std::endl;
-        std::cout << "  Name: " << label->getLabel() << std::endl;
-        std::cout << "  Indices: " << label->getStartIndex() << " - " << label->getEndIndex() << std::endl;
-        std::cout << "  Time: " << label->getStartTime() << "s - " << label->getEndTime() << "s" << std::endl;
-        std::cout << "  Color: " << label->getColor() << std::endl;
-
-        json labelJson;
-        labelJson["start_index"] = label->getStartIndex();
-        labelJson["end_index"] = label->getEndIndex();
-        labelJson["start_time"] = label->getStartTime();
-        labelJson["end_time"] = label->getEndTime();
-        labelJson["label"] = label->getLabel();
-        labelJson["color"] = label->getColor();
-
-        // Add voltage data
-        const auto& voltages = label->getVoltageData();
-        labelJson["voltage_data"] = voltages;
-
-        std::cout << "  Voltage samples: " << voltages.size() << std::endl;
-
-        // Calculate voltage statistics
-        if (!voltages.empty()) {
-            float minVoltage = *std::min_element(voltages.begin(), voltages.end());
-            float maxVoltage = *std::max_element(voltages.begin(), voltages.end());
-            float avgVoltage = std::accumulate(voltages.begin(), voltages.end(), 0.0f) / voltages.size();
-
-            labelJson["voltage_min"] = minVoltage;
-            labelJson["voltage_max"] = maxVoltage;
-            labelJson["voltage_avg"] = avgVoltage;
-
-            std::cout << "  Voltage range: [" << minVoltage << ", " << maxVoltage << "] mV" << std::endl;
-            std::cout << "  Voltage avg: " << avgVoltage << " mV" << std::endl;
-        }
+    const std::string path = filePath.toStdString();
+    BufferedWriter out;
+    BufferedWriter sidecar;
 
-        j["labels"].push_back(labelJson);
-        labelIndex++;
+    if (!out.open(path)) {
+        std::cerr << "ERROR: " << out.getLastError() << std::endl;
+        return false;
     }
 
-    try {
-        std::cout << "Opening file for writing: " << filePath.toStdString() << std::endl;
-
-        std::ofstream file(filePath.toStdString());
-        if (!file.is_open()) {
-            std::cerr << "ERROR: Failed to open file for writing: " << filePath.toStdString() << std::endl;
+    std::string sidecarPath;
+    if (binarySidecar) {
+        sidecarPath = sidecarPathFor(path);
+        std::cout << "Voltage sidecar: " << sidecarPath << std::endl;
+        if (!sidecar.open(sidecarPath)) {
+            std::cerr << "ERROR: " << sidecar.getLastError() << std::endl;
             return false;
         }
+    }
 
-        std::string jsonStr = j.dump(2);  // Pretty print with 2-space indent
-        std::cout << "Writing " << jsonStr.length() << " bytes to file..." << std::endl;
-
-        file << jsonStr;
-        file.close();
+    // Labels are written as they are visited; only the output buffers are
+    // held in memory
+    JsonWriter writer(out);
+    writer.beginObject();
+    if (binarySidecar) {
+        // Native float32, little-endian on every platform we build for
+        writer.member("voltage_file", fileNameOf(sidecarPath));
+        writer.member("voltage_format", "float32le");
+    }
+    writer.key("labels");
+    writer.beginArray();
 
-        if (file.fail()) {
-            std::cerr << "ERROR: Failed to write to file: " << filePath.toStdString() << std::endl;
-            return false;
+    size_t totalSamples = 0;
+    for (const auto& label : m_labels) {
+        writer.beginObject();
+        writer.member("start_index", label->getStartIndex());
+        writer.member("end_index", label->getEndIndex());
+        writer.member("start_time", label->getStartTime());
+        writer.member("end_time", label->getEndTime());
+        writer.member("label", label->getLabel());
+        writer.member("color", label->getColor());
+
+        // Voltages are read from the channel buffer only here
+        SampleView voltages = label->getSamples();
+        if (binarySidecar) {
+            writer.member("voltage_offset", sidecar.getBytesWritten());
+            writer.member("voltage_count", voltages.size());
+            sidecar.write(reinterpret_cast<const char*>(voltages.data()),
+                          voltages.size() * sizeof(float));
+        } else {
+            writer.key("voltage_data");
+            writer.floatArray(voltages);
+        }
+        totalSamples += voltages.size();
+
+        // Voltage statistics from the channel's range index, without
+        // rescanning the segment
+        RangeStats stats;
+        if (segmentStatistics(*label, stats)) {
+            writer.member("voltage_min", static_cast<float>(stats.min));
+            writer.member("voltage_max", static_cast<float>(stats.max));
+            writer.member("voltage_avg", static_cast<float>(stats.mean));
+            writer.member("voltage_std", static_cast<float>(stats.std));
+            writer.member("voltage_rms", static_cast<float>(stats.rms));
         }
 
-        std::cout << "\n✓ SUCCESS!" << std::endl;
-        std::cout << "✓ Saved " << m_labels.size() << " labels to: " << filePath.toStdString() << std::endl;
-        std::cout << "✓ File size: " << jsonStr.length() << " bytes" << std::endl;
-        std::cout << "========================================\n" << std::endl;
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "✗ Exception while saving labels: " << e.what() << std::endl;
+        writer.endObject();
+    }
+
+    writer.endArray();
+    writer.endObject();
+
+    bool ok = out.close();
+    if (!ok) {
+        std::cerr << "ERROR: " << out.getLastError() << std::endl;
+    }
+    if (!sidecar.close()) {
+        std::cerr << "ERROR: " << sidecar.getLastError() << std::endl;
+        ok = false;
+    }
+    if (!ok) {
         return false;
     }
+
+    std::cout << "\n✓ SUCCESS!" << std::endl;
+    std::cout << "✓ Saved " << m_labels.size() << " labels (" << totalSamples
+              << " voltage samples) to: " << path << std::endl;
+    std::cout << "✓ File size: " << out.getBytesWritten() << " bytes" << std::endl;
+    if (binarySidecar) {
+        std::cout << "✓ Sidecar size: " << sidecar.getBytesWritten() << " bytes" << std::endl;
+    }
+    std::cout << "========================================\n" << std::endl;
+    return true;
 }
 
 bool LabelManager::loadFromFile(const QString& filePath) {
@@ -271,6 +346,18 @@ bool LabelManager::loadFromFile(const QString& filePath) {
     }
 }
 
+bool LabelManager::segmentStatistics(const SegmentLabel& label, RangeStats& stats) const {
+    const auto& source = label.getSource();
+    size_t start = label.getStartIndex();
+    size_t end = label.getEndIndex();
+
+    if (!source || start >= end || end > source->size()) {
+        return false;
+    }
+
+    return DataAnalyzer::calculateRangeStatistics(*source, start, end, stats);
+}
+
 std::shared_ptr<SegmentLabel> LabelManager::findLabelById(int id) {
     auto it = std::find_if(m_labels.begin(), m_labels.end(),
                           [id](const std::shared_ptr<SegmentLabel>& label) {
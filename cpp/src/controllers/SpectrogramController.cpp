@@ -0,0 +1,187 @@
+#include "SpectrogramController.h"
+#include "RealFFT.h"
+#include <QVariantMap>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+SpectrogramController::SpectrogramController(QObject *parent)
+    : QObject(parent)
+    , m_sampleRate(0.0f)
+    , m_fftSize(DEFAULT_FFT_SIZE)
+    , m_minDb(-80.0)
+    , m_maxDb(0.0)
+{
+}
+
+SpectrogramController::~SpectrogramController() {
+}
+
+bool SpectrogramController::hasData() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_buffer && !m_buffer->empty();
+}
+
+double SpectrogramController::maxFrequency() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sampleRate / 2.0;
+}
+
+void SpectrogramController::setFftSize(int size) {
+    size_t rounded = RealFFT::nextPowerOfTwo(static_cast<size_t>(std::clamp(size, MIN_FFT_SIZE, MAX_FFT_SIZE)));
+    if (static_cast<int>(rounded) == m_fftSize) {
+        return;
+    }
+    m_fftSize = static_cast<int>(rounded);
+    emit spectrogramChanged();
+}
+
+void SpectrogramController::setMinDb(double value) {
+    if (m_minDb == value) {
+        return;
+    }
+    m_minDb = value;
+    emit spectrogramChanged();
+}
+
+void SpectrogramController::setMaxDb(double value) {
+    if (m_maxDb == value) {
+        return;
+    }
+    m_maxDb = value;
+    emit spectrogramChanged();
+}
+
+void SpectrogramController::setChannelData(std::shared_ptr<ChannelData> channel) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        SampleBuffer::Ptr buffer = channel ? channel->getBuffer() : nullptr;
+        float sampleRate = channel ? channel->getSampleRate() : 0.0f;
+        if (buffer == m_buffer && sampleRate == m_sampleRate) {
+            return;
+        }
+        m_buffer = buffer;
+        m_sampleRate = sampleRate;
+    }
+    emit spectrogramChanged();
+}
+
+QVariantList SpectrogramController::getVisibleTiles(qint64 startSample, qint64 endSample, int pixelWidth) {
+    QVariantList tiles;
+
+    SampleBuffer::Ptr buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffer = m_buffer;
+    }
+
+    if (!buffer || buffer->empty() || pixelWidth <= 0) {
+        return tiles;
+    }
+
+    const qint64 numSamples = static_cast<qint64>(buffer->size());
+    startSample = std::clamp<qint64>(startSample, 0, numSamples);
+    endSample = std::clamp<qint64>(endSample, 0, numSamples);
+    if (startSample >= endSample) {
+        return tiles;
+    }
+
+    // About one column per pixel; columns closer than nfft/8 would only
+    // repeat nearly identical frames
+    double samplesPerPixel = static_cast<double>(endSample - startSample) / pixelWidth;
+    size_t hop = RealFFT::nextPowerOfTwo(static_cast<size_t>(std::max(1.0, std::floor(samplesPerPixel))));
+    hop = std::max(hop, static_cast<size_t>(m_fftSize / 8));
+
+    const size_t tileSpan = Spectrogram::TILE_COLUMNS * hop;
+    const size_t numTiles = Spectrogram::getNumTiles(buffer->size(), hop);
+    const size_t firstTile = (static_cast<size_t>(startSample) + hop / 2) / tileSpan;
+    const size_t lastTile = std::min(numTiles - 1, (static_cast<size_t>(endSample - 1) + hop / 2) / tileSpan);
+
+    for (size_t tile = firstTile; tile <= lastTile; ++tile) {
+        // Column c is centred on sample c * hop and spans half a hop each side
+        size_t firstColumn = tile * Spectrogram::TILE_COLUMNS;
+        size_t numColumns = std::min(Spectrogram::TILE_COLUMNS,
+                                     Spectrogram::getNumColumns(buffer->size(), hop) - firstColumn);
+        double start = static_cast<double>(firstColumn * hop) - hop / 2.0;
+
+        QVariantMap entry;
+        entry["source"] = QString("image://spectrogram/%1/%2/%3/%4/%5/%6")
+                              .arg(buffer->getVersion())
+                              .arg(m_fftSize)
+                              .arg(hop)
+                              .arg(m_minDb)
+                              .arg(m_maxDb)
+                              .arg(tile);
+        entry["startSample"] = start;
+        entry["endSample"] = start + static_cast<double>(numColumns * hop);
+        tiles.append(entry);
+    }
+
+    return tiles;
+}
+
+QImage SpectrogramController::renderTile(const QString& id) {
+    QStringList parts = id.split('/');
+    if (parts.size() != 6) {
+        return QImage();
+    }
+
+    bool ok[6] = {false, false, false, false, false, false};
+    quint64 version = parts[0].toULongLong(&ok[0]);
+    size_t nfft = parts[1].toULongLong(&ok[1]);
+    size_t hop = parts[2].toULongLong(&ok[2]);
+    double minDb = parts[3].toDouble(&ok[3]);
+    double maxDb = parts[4].toDouble(&ok[4]);
+    size_t tileIndex = parts[5].toULongLong(&ok[5]);
+    if (!std::all_of(ok, ok + 6, [](bool value) { return value; })) {
+        return QImage();
+    }
+
+    SampleBuffer::Ptr buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffer = m_buffer;
+    }
+
+    // A request for a buffer that has since been replaced is dropped; QML
+    // already asked for the new version's tiles
+    if (!buffer || buffer->getVersion() != version) {
+        return QImage();
+    }
+
+    auto tile = m_spectrogram.getTile(buffer, nfft, hop, tileIndex);
+    if (!tile) {
+        return QImage();
+    }
+
+    // One pixel per column and bin, highest frequency on top
+    QImage image(static_cast<int>(tile->numColumns), static_cast<int>(tile->numBins), QImage::Format_RGB32);
+    const double range = std::max(1e-6, maxDb - minDb);
+
+    for (size_t bin = 0; bin < tile->numBins; ++bin) {
+        QRgb* row = reinterpret_cast<QRgb*>(image.scanLine(static_cast<int>(tile->numBins - 1 - bin)));
+        for (size_t column = 0; column < tile->numColumns; ++column) {
+            row[column] = colorMap((tile->at(column, bin) - minDb) / range);
+        }
+    }
+
+    return image;
+}
+
+QRgb SpectrogramController::colorMap(double position) {
+    // Perceptually ordered dark-to-bright ramp (close to "inferno")
+    static const int stops[][3] = {
+        {0, 0, 4}, {66, 10, 104}, {147, 38, 103}, {221, 81, 58}, {252, 165, 10}, {252, 255, 164}
+    };
+    const int numStops = sizeof(stops) / sizeof(stops[0]);
+
+    double scaled = std::clamp(position, 0.0, 1.0) * (numStops - 1);
+    int lower = std::min(static_cast<int>(scaled), numStops - 2);
+    double t = scaled - lower;
+
+    auto mix = [&](int channel) {
+        return static_cast<int>(std::lround(stops[lower][channel] +
+                                            t * (stops[lower + 1][channel] - stops[lower][channel])));
+    };
+    return qRgb(mix(0), mix(1), mix(2));
+}
@@ -0,0 +1,22 @@
+#include "SpectrogramImageProvider.h"
+
+SpectrogramImageProvider::SpectrogramImageProvider(SpectrogramController* controller)
+    : QQuickImageProvider(QQuickImageProvider::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading)
+    , m_controller(controller)
+{
+}
+
+QImage SpectrogramImageProvider::requestImage(const QString& id, QSize* size, const QSize& requestedSize) {
+    QImage image = m_controller ? m_controller->renderTile(id) : QImage();
+
+    // QML stretches the tile over its time span; honour an explicit
+    // sourceSize anyway
+    if (!image.isNull() && requestedSize.isValid()) {
+        image = image.scaled(requestedSize);
+    }
+
+    if (size) {
+        *size = image.size();
+    }
+    return image;
+}
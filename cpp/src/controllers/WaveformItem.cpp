@@ -0,0 +1,182 @@
+#include "WaveformItem.h"
+#include <QSGGeometryNode>
+#include <QSGGeometry>
+#include <QSGFlatColorMaterial>
+#include <algorithm>
+#include <cmath>
+
+WaveformItem::WaveformItem(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_startSample(0.0)
+    , m_endSample(0.0)
+    , m_minValue(-1.0)
+    , m_maxValue(1.0)
+    , m_color("#00aaff")
+    , m_colorChanged(true)
+{
+    setFlag(ItemHasContents, true);
+}
+
+WaveformItem::~WaveformItem() {
+}
+
+void WaveformItem::setController(ApplicationController* controller) {
+    if (m_controller == controller) {
+        return;
+    }
+
+    if (m_controller) {
+        disconnect(m_controller, nullptr, this, nullptr);
+    }
+
+    m_controller = controller;
+
+    if (m_controller) {
+        connect(m_controller, &ApplicationController::waveformUpdated,
+                this, &WaveformItem::onWaveformUpdated);
+    }
+
+    onWaveformUpdated();
+    emit controllerChanged();
+}
+
+void WaveformItem::setStartSample(qreal sample) {
+    if (m_startSample == sample) {
+        return;
+    }
+    m_startSample = sample;
+    emit startSampleChanged();
+    update();
+}
+
+void WaveformItem::setEndSample(qreal sample) {
+    if (m_endSample == sample) {
+        return;
+    }
+    m_endSample = sample;
+    emit endSampleChanged();
+    update();
+}
+
+void WaveformItem::setMinValue(qreal value) {
+    if (m_minValue == value) {
+        return;
+    }
+    m_minValue = value;
+    emit minValueChanged();
+    update();
+}
+
+void WaveformItem::setMaxValue(qreal value) {
+    if (m_maxValue == value) {
+        return;
+    }
+    m_maxValue = value;
+    emit maxValueChanged();
+    update();
+}
+
+void WaveformItem::setColor(const QColor& color) {
+    if (m_color == color) {
+        return;
+    }
+    m_color = color;
+    m_colorChanged = true;
+    emit colorChanged();
+    update();
+}
+
+void WaveformItem::onWaveformUpdated() {
+    // Hold a reference so a reset/filter swapping the controller's channel
+    // can't free the samples while the render thread reads them
+    auto channel = m_controller ? m_controller->getChannelData() : nullptr;
+    m_buffer = channel ? channel->getBuffer() : nullptr;
+    update();
+}
+
+void WaveformItem::geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry) {
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+
+    // Column count and scaling depend on the size
+    if (newGeometry.size() != oldGeometry.size()) {
+        update();
+    }
+}
+
+QSGNode* WaveformItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) {
+    Q_UNUSED(data);
+
+    // Runs on the render thread while the GUI thread is blocked, so the
+    // members and the channel's samples are safe to read here
+    auto* node = static_cast<QSGGeometryNode*>(oldNode);
+
+    SampleView samples = m_buffer ? m_buffer->view() : SampleView();
+    const qreal itemWidth = width();
+    const qreal itemHeight = height();
+    const qreal sampleSpan = m_endSample - m_startSample;
+    const qreal valueSpan = m_maxValue - m_minValue;
+
+    // Visible sample range, widened by one sample so the trace reaches the edges
+    const qreal total = static_cast<qreal>(samples.size());
+    const size_t first = static_cast<size_t>(std::clamp(std::floor(m_startSample), 0.0, total));
+    const size_t last = static_cast<size_t>(std::clamp(std::ceil(m_endSample) + 1.0, 0.0, total));
+
+    if (samples.empty() || itemWidth <= 0 || itemHeight <= 0 ||
+        sampleSpan <= 0 || valueSpan <= 0 || first >= last) {
+        delete node;
+        return nullptr;
+    }
+
+    if (!node) {
+        node = new QSGGeometryNode;
+
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+        geometry->setLineWidth(1.0f);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+
+        node->setMaterial(new QSGFlatColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+        m_colorChanged = true;
+    }
+
+    if (m_colorChanged) {
+        static_cast<QSGFlatColorMaterial*>(node->material())->setColor(m_color);
+        node->markDirty(QSGNode::DirtyMaterial);
+        m_colorChanged = false;
+    }
+
+    const qreal xScale = itemWidth / sampleSpan;
+    const qreal yScale = itemHeight / valueSpan;
+    auto toX = [&](size_t index) { return static_cast<float>((index - m_startSample) * xScale); };
+    auto toY = [&](float value) { return static_cast<float>(itemHeight - (value - m_minValue) * yScale); };
+
+    QSGGeometry* geometry = node->geometry();
+    const size_t columns = static_cast<size_t>(std::ceil(itemWidth));
+
+    if (last - first > columns) {
+        // More samples than pixels: zig-zag through each column's min and max
+        auto buckets = m_buffer->getPyramid().getEnvelope(first, last, columns);
+
+        geometry->allocate(static_cast<int>(buckets.size() * 2));
+        QSGGeometry::Point2D* vertices = geometry->vertexDataAsPoint2D();
+
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            float x = toX(buckets[i].index);
+            vertices[2 * i].set(x, toY(buckets[i].min));
+            vertices[2 * i + 1].set(x, toY(buckets[i].max));
+        }
+    } else {
+        // Zoomed in past one sample per pixel: connect the raw samples
+        geometry->allocate(static_cast<int>(last - first));
+        QSGGeometry::Point2D* vertices = geometry->vertexDataAsPoint2D();
+
+        for (size_t i = first; i < last; ++i) {
+            vertices[i - first].set(toX(i), toY(samples[i]));
+        }
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
@@ -1,12 +1,16 @@
 #include <QApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QtQml>
 #include <QIcon>
 #include <iostream>
 
 #include "ApplicationController.h"
 #include "FilterController.h"
 #include "LabelManager.h"
+#include "WaveformItem.h"
+#include "SpectrogramController.h"
+#include "SpectrogramImageProvider.h"
 
 int main(int argc, char *argv[])
 {
@@ -21,6 +25,10 @@ int main(int argc, char *argv[])
     ApplicationController appController;
     FilterController filterController;
     LabelManager labelManager;
+    SpectrogramController spectrogramController;
+
+    // Filter results are committed to the channel without leaving C++
+    appController.setFilterController(&filterController);
 
     // Connect application controller to filter controller and label manager
     // When app loads data, pass it to filter controller and label manager
@@ -42,10 +50,14 @@ int main(int argc, char *argv[])
                 std::cout << "  No original data, using current data" << std::endl;
                 filterController.setChannelData(channelData);
             }
+            filterController.setChannels(appController.getOriginalChannels());
 
             // Update label manager with current (possibly filtered) voltage data
             labelManager.setSampleRate(channelData->getSampleRate());
-            labelManager.setVoltageData(channelData->getData());
+            labelManager.setVoltageData(channelData->getBuffer());
+
+            // Spectrogram follows the displayed (possibly filtered) channel
+            spectrogramController.setChannelData(channelData);
 
             std::cout << "Controllers updated successfully" << std::endl;
         } else {
@@ -54,6 +66,25 @@ int main(int argc, char *argv[])
         std::cout << "===========================\n" << std::endl;
     });
 
+    // Whole-recording filtering replaces every channel at once
+    QObject::connect(&filterController, &FilterController::allChannelsFiltered, [&]() {
+        appController.updateChannels(filterController.getFilteredChannels());
+    });
+
+    // EDF+ annotations of a loaded file replace the current labels
+    QObject::connect(&appController, &ApplicationController::annotationsLoaded, [&](const QVariantList& labels) {
+        labelManager.clearLabels();
+        for (const QVariant& item : labels) {
+            QVariantMap label = item.toMap();
+            labelManager.addLabel(label.value("startIndex").toInt(), label.value("endIndex").toInt(),
+                                  label.value("label").toString(), "#FFA500");
+        }
+        std::cout << "Loaded " << labels.size() << " EDF+ annotations as labels" << std::endl;
+    });
+
+    // Register the scene-graph waveform renderer
+    qmlRegisterType<WaveformItem>("ACQProcessor", 1, 0, "WaveformItem");
+
     // Create QML engine
     QQmlApplicationEngine engine;
 
@@ -61,6 +92,10 @@ int main(int argc, char *argv[])
     engine.rootContext()->setContextProperty("appController", &appController);
     engine.rootContext()->setContextProperty("filterController", &filterController);
     engine.rootContext()->setContextProperty("labelManager", &labelManager);
+    engine.rootContext()->setContextProperty("spectrogramController", &spectrogramController);
+
+    // Spectrogram tiles for WaveformView (engine takes ownership)
+    engine.addImageProvider("spectrogram", new SpectrogramImageProvider(&spectrogramController));
 
     // Load main QML file
     const QUrl url(QStringLiteral("qrc:/main.qml"));
@@ -1,4 +1,5 @@
 #include "ChannelData.h"
+#include "MappedFile.h"
 #include <fstream>
 #include <iostream>
 #include <cstring>
@@ -8,6 +9,9 @@ ChannelData::ChannelData()
     , sampleRate(0.0f)
     , numSamples(0)
     , duration(0.0f)
+    , adcScaled(false)
+    , adcScale(1.0f)
+    , adcOffset(0.0f)
     , min(0.0f)
     , max(0.0f)
     , mean(0.0f)
@@ -25,7 +29,36 @@ void ChannelData::setStatistics(float minVal, float maxVal, float meanVal, float
     std = stdVal;
 }
 
+void ChannelData::setAdcScale(float scale, float offset) {
+    adcScaled = true;
+    adcScale = scale;
+    adcOffset = offset;
+}
+
 bool ChannelData::loadBinaryData(const std::string& filepath) {
+    auto mapping = std::make_shared<MappedFile>();
+
+    if (!mapping->open(filepath)) {
+        std::cerr << "Memory mapping failed (" << mapping->getLastError()
+                  << "), reading file instead" << std::endl;
+        return readBinaryData(filepath);
+    }
+
+    // Calculate number of float32 values
+    size_t numFloats = mapping->size() / sizeof(float);
+
+    if (numFloats != numSamples) {
+        std::cerr << "Warning: File size mismatch. Expected " << numSamples
+                  << " samples but got " << numFloats << std::endl;
+    }
+
+    buffer = SampleBuffer::create(std::move(mapping), numFloats);
+
+    std::cout << "Mapped " << buffer->size() << " samples from " << filepath << std::endl;
+    return true;
+}
+
+bool ChannelData::readBinaryData(const std::string& filepath) {
     std::ifstream file(filepath, std::ios::binary | std::ios::ate);
 
     if (!file.is_open()) {
@@ -46,8 +79,8 @@ bool ChannelData::loadBinaryData(const std::string& filepath) {
     }
 
     // Read all data
-    data.resize(numFloats);
-    file.read(reinterpret_cast<char*>(data.data()), fileSize);
+    std::vector<float> samples(numFloats);
+    file.read(reinterpret_cast<char*>(samples.data()), fileSize);
 
     if (!file) {
         std::cerr << "Error reading binary data from: " << filepath << std::endl;
@@ -56,11 +89,27 @@ bool ChannelData::loadBinaryData(const std::string& filepath) {
 
     file.close();
 
-    std::cout << "Loaded " << data.size() << " samples from " << filepath << std::endl;
+    std::cout << "Loaded " << samples.size() << " samples from " << filepath << std::endl;
+
+    buffer = SampleBuffer::create(std::move(samples));
     return true;
 }
 
 void ChannelData::setData(const std::vector<float>& newData) {
-    data = newData;
-    numSamples = data.size();
+    setData(std::vector<float>(newData));
+}
+
+void ChannelData::setData(std::vector<float>&& newData) {
+    setBuffer(SampleBuffer::create(std::move(newData)));
+}
+
+void ChannelData::setBuffer(SampleBuffer::Ptr newBuffer) {
+    buffer = std::move(newBuffer);
+    numSamples = buffer ? buffer->size() : 0;
+    adcScaled = false;
+}
+
+const WaveformPyramid& ChannelData::getPyramid() const {
+    static const WaveformPyramid emptyPyramid;
+    return buffer ? buffer->getPyramid() : emptyPyramid;
 }
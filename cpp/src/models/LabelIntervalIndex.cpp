@@ -0,0 +1,90 @@
+#include "LabelIntervalIndex.h"
+#include <algorithm>
+
+LabelIntervalIndex::LabelIntervalIndex() {
+}
+
+void LabelIntervalIndex::build(const std::vector<std::shared_ptr<SegmentLabel>>& labels) {
+    nodes.clear();
+    nodes.reserve(labels.size());
+    for (const auto& label : labels) {
+        nodes.push_back({label->getStartIndex(), label->getEndIndex(), 0, label});
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) {
+        if (a.start != b.start) {
+            return a.start < b.start;
+        }
+        return a.label->getId() < b.label->getId();
+    });
+
+    buildMaxEnd(0, nodes.size());
+}
+
+void LabelIntervalIndex::clear() {
+    nodes.clear();
+}
+
+size_t LabelIntervalIndex::buildMaxEnd(size_t lo, size_t hi) {
+    if (lo >= hi) {
+        return 0;
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    Node& node = nodes[mid];
+    node.maxEnd = std::max({node.end, buildMaxEnd(lo, mid), buildMaxEnd(mid + 1, hi)});
+    return node.maxEnd;
+}
+
+void LabelIntervalIndex::collect(size_t lo, size_t hi, size_t start, size_t end,
+                                 std::vector<std::shared_ptr<SegmentLabel>>& hits) const {
+    if (lo >= hi) {
+        return;
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    const Node& node = nodes[mid];
+
+    // Nothing in this subtree reaches the query
+    if (node.maxEnd < start) {
+        return;
+    }
+
+    collect(lo, mid, start, end, hits);
+
+    // Everything from here on starts after the query
+    if (node.start > end) {
+        return;
+    }
+
+    if (node.end >= start) {
+        hits.push_back(node.label);
+    }
+
+    collect(mid + 1, hi, start, end, hits);
+}
+
+std::shared_ptr<SegmentLabel> LabelIntervalIndex::findAt(size_t index) const {
+    std::vector<std::shared_ptr<SegmentLabel>> hits;
+    collect(0, nodes.size(), index, index, hits);
+
+    if (hits.empty()) {
+        return nullptr;
+    }
+
+    // Ids grow with creation, so the smallest is the one a scan finds first
+    return *std::min_element(hits.begin(), hits.end(),
+                             [](const std::shared_ptr<SegmentLabel>& a,
+                                const std::shared_ptr<SegmentLabel>& b) {
+                                 return a->getId() < b->getId();
+                             });
+}
+
+std::vector<std::shared_ptr<SegmentLabel>> LabelIntervalIndex::findOverlapping(size_t start,
+                                                                               size_t end) const {
+    std::vector<std::shared_ptr<SegmentLabel>> hits;
+    if (start <= end) {
+        collect(0, nodes.size(), start, end, hits);
+    }
+    return hits;
+}
@@ -0,0 +1,122 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : mappedData(nullptr)
+    , mappedSize(0)
+#ifdef _WIN32
+    , fileHandle(nullptr)
+    , mappingHandle(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        lastError = "Failed to open file for mapping: " + filepath;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        lastError = "Cannot map empty file: " + filepath;
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        lastError = "Failed to create file mapping: " + filepath;
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        lastError = "Failed to map view of file: " + filepath;
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    mappedData = view;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mappedData) {
+        UnmapViewOfFile(mappedData);
+        mappedData = nullptr;
+    }
+    if (mappingHandle) {
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        mappingHandle = nullptr;
+    }
+    if (fileHandle) {
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        fileHandle = nullptr;
+    }
+    mappedSize = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        lastError = "Failed to open file for mapping: " + filepath;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        lastError = "Cannot map empty file: " + filepath;
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps its own reference to the file
+
+    if (view == MAP_FAILED) {
+        lastError = "Failed to map file: " + filepath;
+        return false;
+    }
+
+    mappedData = view;
+    mappedSize = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mappedData) {
+        munmap(mappedData, mappedSize);
+        mappedData = nullptr;
+    }
+    mappedSize = 0;
+}
+
+#endif
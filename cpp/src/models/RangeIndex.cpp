@@ -0,0 +1,133 @@
+#include "RangeIndex.h"
+#include <algorithm>
+#include <cmath>
+
+void RangeIndex::Moments::merge(double otherCount, double otherMean, double otherM2) {
+    if (otherCount <= 0.0) {
+        return;
+    }
+
+    // Chan et al. pairwise merge of (count, mean, M2)
+    const double total = count + otherCount;
+    const double delta = otherMean - mean;
+    mean += delta * otherCount / total;
+    m2 += otherM2 + delta * delta * count * otherCount / total;
+    count = total;
+}
+
+RangeIndex::RangeIndex()
+    : pyramid(nullptr)
+{
+}
+
+void RangeIndex::build(SampleView newData, const WaveformPyramid* newPyramid) {
+    clear();
+    data = newData;
+    pyramid = newPyramid;
+
+    const size_t numBlocks = data.size() / BLOCK_SIZE;
+    if (numBlocks == 0) {
+        return;
+    }
+
+    levels.emplace_back(numBlocks);
+    for (size_t block = 0; block < numBlocks; ++block) {
+        Moments moments = scan(block * BLOCK_SIZE, (block + 1) * BLOCK_SIZE);
+        levels[0][block] = {moments.mean, moments.m2};
+    }
+
+    // Each level merges pairs of the one below; both halves hold the same count
+    for (double count = BLOCK_SIZE; levels.back().size() >= 2; count *= 2.0) {
+        const std::vector<Node>& below = levels.back();
+        std::vector<Node> above(below.size() / 2);
+        for (size_t i = 0; i < above.size(); ++i) {
+            Moments moments{count, below[2 * i].mean, below[2 * i].m2};
+            moments.merge(count, below[2 * i + 1].mean, below[2 * i + 1].m2);
+            above[i] = {moments.mean, moments.m2};
+        }
+        levels.push_back(std::move(above));
+    }
+}
+
+void RangeIndex::clear() {
+    data = SampleView();
+    pyramid = nullptr;
+    levels.clear();
+}
+
+RangeIndex::Moments RangeIndex::scan(size_t start, size_t end) const {
+    Moments moments;
+    if (start >= end) {
+        return moments;
+    }
+
+    double sum = 0.0;
+    for (size_t i = start; i < end; ++i) {
+        sum += data[i];
+    }
+    moments.count = static_cast<double>(end - start);
+    moments.mean = sum / moments.count;
+
+    for (size_t i = start; i < end; ++i) {
+        double d = data[i] - moments.mean;
+        moments.m2 += d * d;
+    }
+    return moments;
+}
+
+bool RangeIndex::getStats(size_t start, size_t end, RangeStats& stats) const {
+    end = std::min(end, data.size());
+    if (start >= end) {
+        return false;
+    }
+
+    const size_t firstBlock = (start + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const size_t lastBlock = end / BLOCK_SIZE;
+
+    Moments moments;
+    if (lastBlock < firstBlock + SCAN_BLOCKS) {
+        // Short range: exact two-pass scan
+        moments = scan(start, end);
+    } else {
+        // Ragged ends from the samples, whole blocks from the tree
+        moments = scan(start, firstBlock * BLOCK_SIZE);
+        Moments tail = scan(lastBlock * BLOCK_SIZE, end);
+        moments.merge(tail.count, tail.mean, tail.m2);
+
+        size_t left = firstBlock;
+        size_t right = lastBlock;
+        double count = BLOCK_SIZE;
+        for (size_t level = 0; left < right; ++level, count *= 2.0) {
+            if (left & 1) {
+                const Node& node = levels[level][left++];
+                moments.merge(count, node.mean, node.m2);
+            }
+            if (right & 1) {
+                const Node& node = levels[level][--right];
+                moments.merge(count, node.mean, node.m2);
+            }
+            left /= 2;
+            right /= 2;
+        }
+    }
+
+    const double variance = moments.m2 / moments.count;
+
+    stats.count = end - start;
+    stats.mean = moments.mean;
+    stats.std = std::sqrt(variance);
+    stats.rms = std::sqrt(stats.mean * stats.mean + variance);
+
+    float lo = 0.0f;
+    float hi = 0.0f;
+    if (pyramid) {
+        pyramid->getMinMax(start, end, lo, hi);
+    } else {
+        auto range = std::minmax_element(data.begin() + start, data.begin() + end);
+        lo = *range.first;
+        hi = *range.second;
+    }
+    stats.min = lo;
+    stats.max = hi;
+    return true;
+}
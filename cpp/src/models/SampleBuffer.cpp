@@ -0,0 +1,52 @@
+#include "SampleBuffer.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+uint64_t nextVersion() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+}
+
+SampleBuffer::SampleBuffer()
+    : version(nextVersion())
+{
+}
+
+SampleBuffer::Ptr SampleBuffer::create(std::vector<float>&& samples) {
+    std::shared_ptr<SampleBuffer> buffer(new SampleBuffer());
+    buffer->owned = std::move(samples);
+    buffer->samples = SampleView(buffer->owned);
+    return buffer;
+}
+
+SampleBuffer::Ptr SampleBuffer::create(std::shared_ptr<const MappedFile> mapping, size_t count) {
+    return create(std::move(mapping), 0, count);
+}
+
+SampleBuffer::Ptr SampleBuffer::create(std::shared_ptr<const MappedFile> mapping, size_t byteOffset, size_t count) {
+    if (byteOffset % sizeof(float) != 0) {
+        return nullptr;
+    }
+
+    std::shared_ptr<SampleBuffer> buffer(new SampleBuffer());
+    byteOffset = std::min(byteOffset, mapping->size());
+    count = std::min(count, (mapping->size() - byteOffset) / sizeof(float));
+    buffer->samples = SampleView(reinterpret_cast<const float*>(mapping->data() + byteOffset), count);
+    buffer->mapping = std::move(mapping);
+    return buffer;
+}
+
+const WaveformPyramid& SampleBuffer::getPyramid() const {
+    std::call_once(pyramidOnce, [this] { pyramid.build(samples); });
+    return pyramid;
+}
+
+const RangeIndex& SampleBuffer::getRangeIndex() const {
+    std::call_once(rangeIndexOnce, [this] { rangeIndex.build(samples, &getPyramid()); });
+    return rangeIndex;
+}
@@ -27,6 +27,13 @@ SegmentLabel::SegmentLabel(size_t start, size_t end, const std::string& lbl, con
 SegmentLabel::~SegmentLabel() {
 }
 
+SampleView SegmentLabel::getSamples() const {
+    if (!source || startIndex >= endIndex || endIndex > source->size()) {
+        return SampleView();
+    }
+    return source->view().subview(startIndex, endIndex - startIndex);
+}
+
 bool SegmentLabel::overlaps(size_t start, size_t end) const {
     return !(end < startIndex || start > endIndex);
 }
@@ -0,0 +1,175 @@
+#include "WaveformPyramid.h"
+#include <algorithm>
+
+WaveformPyramid::WaveformPyramid() {
+}
+
+WaveformPyramid::WaveformPyramid(SampleView data) {
+    build(data);
+}
+
+void WaveformPyramid::build(SampleView newData) {
+    clear();
+    data = newData;
+
+    // Level 0: min/max of each full BASE_BIN_SIZE block. A trailing partial
+    // block is never stored; queries scan it from the samples instead.
+    size_t numBins = data.size() / BASE_BIN_SIZE;
+    if (numBins == 0) {
+        return;
+    }
+
+    Level base;
+    base.binSize = BASE_BIN_SIZE;
+    base.mins.resize(numBins);
+    base.maxs.resize(numBins);
+
+    const float* samples = data.data();
+    for (size_t bin = 0; bin < numBins; ++bin) {
+        const float* block = samples + bin * BASE_BIN_SIZE;
+        float lo = block[0];
+        float hi = block[0];
+        for (size_t i = 1; i < BASE_BIN_SIZE; ++i) {
+            lo = std::min(lo, block[i]);
+            hi = std::max(hi, block[i]);
+        }
+        base.mins[bin] = lo;
+        base.maxs[bin] = hi;
+    }
+    levels.push_back(std::move(base));
+
+    // Each further level merges pairs of bins from the one below
+    while (levels.back().mins.size() >= 2) {
+        const Level& below = levels.back();
+        size_t count = below.mins.size() / 2;
+
+        Level level;
+        level.binSize = below.binSize * 2;
+        level.mins.resize(count);
+        level.maxs.resize(count);
+
+        for (size_t bin = 0; bin < count; ++bin) {
+            level.mins[bin] = std::min(below.mins[2 * bin], below.mins[2 * bin + 1]);
+            level.maxs[bin] = std::max(below.maxs[2 * bin], below.maxs[2 * bin + 1]);
+        }
+        levels.push_back(std::move(level));
+    }
+}
+
+void WaveformPyramid::clear() {
+    data = SampleView();
+    levels.clear();
+}
+
+bool WaveformPyramid::getMinMax(size_t start, size_t end, float& minVal, float& maxVal) const {
+    end = std::min(end, data.size());
+    if (start >= end) {
+        return false;
+    }
+
+    float lo = data[start];
+    float hi = data[start];
+    size_t pos = start;
+
+    // Unaligned head
+    while (pos < end && (pos % BASE_BIN_SIZE != 0 || levels.empty())) {
+        lo = std::min(lo, data[pos]);
+        hi = std::max(hi, data[pos]);
+        ++pos;
+    }
+
+    // Aligned middle: take the coarsest bin that starts here and fits
+    while (pos + BASE_BIN_SIZE <= end) {
+        size_t level = 0;
+        while (level + 1 < levels.size()) {
+            const Level& next = levels[level + 1];
+            size_t bin = pos / next.binSize;
+            if (pos % next.binSize != 0 || pos + next.binSize > end || bin >= next.mins.size()) {
+                break;
+            }
+            ++level;
+        }
+
+        const Level& chosen = levels[level];
+        size_t bin = pos / chosen.binSize;
+        if (bin >= chosen.mins.size()) {
+            break;  // Trailing partial block
+        }
+        lo = std::min(lo, chosen.mins[bin]);
+        hi = std::max(hi, chosen.maxs[bin]);
+        pos += chosen.binSize;
+    }
+
+    // Tail
+    for (; pos < end; ++pos) {
+        lo = std::min(lo, data[pos]);
+        hi = std::max(hi, data[pos]);
+    }
+
+    minVal = lo;
+    maxVal = hi;
+    return true;
+}
+
+std::vector<WaveformBucket> WaveformPyramid::getEnvelope(size_t start,
+                                                         size_t end,
+                                                         size_t numBuckets) const {
+    std::vector<WaveformBucket> result;
+
+    end = std::min(end, data.size());
+    if (start >= end || numBuckets == 0) {
+        return result;
+    }
+
+    size_t span = end - start;
+    if (span <= numBuckets) {
+        result.reserve(span);
+        for (size_t i = start; i < end; ++i) {
+            result.push_back({i, data[i], data[i]});
+        }
+        return result;
+    }
+
+    result.reserve(numBuckets);
+    for (size_t b = 0; b < numBuckets; ++b) {
+        size_t bucketStart = start + span * b / numBuckets;
+        size_t bucketEnd = start + span * (b + 1) / numBuckets;
+
+        WaveformBucket bucket{bucketStart, 0.0f, 0.0f};
+        if (getMinMax(bucketStart, bucketEnd, bucket.min, bucket.max)) {
+            result.push_back(bucket);
+        }
+    }
+
+    return result;
+}
+
+std::vector<WaveformBucket> WaveformPyramid::scanEnvelope(SampleView data,
+                                                          size_t start,
+                                                          size_t end,
+                                                          size_t numBuckets) {
+    std::vector<WaveformBucket> result;
+
+    end = std::min(end, data.size());
+    if (start >= end || numBuckets == 0) {
+        return result;
+    }
+
+    size_t span = end - start;
+    size_t count = std::min(span, numBuckets);
+    result.reserve(count);
+
+    for (size_t b = 0; b < count; ++b) {
+        size_t bucketStart = start + span * b / count;
+        size_t bucketEnd = start + span * (b + 1) / count;
+
+        WaveformBucket bucket{bucketStart, data[bucketStart], data[bucketStart]};
+        for (size_t i = bucketStart + 1; i < bucketEnd; ++i) {
+            bucket.min = std::min(bucket.min, data[i]);
+            bucket.max = std::max(bucket.max, data[i]);
+        }
+        result.push_back(bucket);
+    }
+
+    return result;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file test_channel_cache.cpp
+ * @brief Test program for the block codec and the channel cache
+ *
+ * Compile separately with:
+ * g++ -std=c++17 -O2 -I../inc/backend -I../inc/models -I../../thirdparty test_channel_cache.cpp
+ *     ../src/backend/BlockCodec.cpp ../src/backend/ChannelCacheWriter.cpp ../src/backend/ChannelCacheReader.cpp
+ *     ../src/backend/ArrayFileWriter.cpp ../src/backend/BufferedWriter.cpp ../src/backend/JsonWriter.cpp
+ *     ../src/backend/DataAnalyzer.cpp ../src/backend/RealFFT.cpp ../src/models/*.cpp
+ *     -o test_channel_cache -lm -pthread
+ *
+ * Usage:
+ * ./test_channel_cache [cache file (default test_channel_cache.acqc)]
+ */
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include "BlockCodec.h"
+#include "ChannelCacheWriter.h"
+#include "ChannelCacheReader.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static int failures = 0;
+
+void check(bool passed, const std::string& what) {
+    std::cout << (passed ? "  PASS: " : "  FAIL: ") << what << std::endl;
+    if (!passed) {
+        ++failures;
+    }
+}
+
+bool sameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() &&
+           (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0);
+}
+
+/**
+ * @brief 16-bit ADC codes decoded the way ACQReader decodes them
+ */
+std::vector<float> generateAdcSignal(size_t numSamples, float scale, float offset, unsigned seed) {
+    std::vector<float> signal(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        int noise = static_cast<int>((seed >> 16) % 41) - 20;
+        int raw = static_cast<int>(8000.0 * std::sin(2.0 * M_PI * 10.0 * i / 2000.0)) + noise;
+        signal[i] = static_cast<float>(raw) * scale + offset;
+    }
+    return signal;
+}
+
+std::shared_ptr<ChannelData> makeChannel(const std::string& name, const std::vector<float>& samples,
+                                         float sampleRate) {
+    auto channel = std::make_shared<ChannelData>();
+    channel->setName(name);
+    channel->setUnits("mV");
+    channel->setSampleRate(sampleRate);
+    channel->setData(samples);
+    return channel;
+}
+
+void testBlockRoundTrip() {
+    std::cout << "\n=== Testing BlockCodec Round Trip ===" << std::endl;
+
+    const float scale = 0.0030517578f;
+    const float offset = -1.25f;
+    const BlockCodec::Grid grid = BlockCodec::adcGrid(scale, offset);
+    auto block = generateAdcSignal(ChannelCacheWriter::BLOCK_SAMPLES, scale, offset, 1);
+
+    std::vector<uint8_t> encoded;
+    BlockCodec::BlockInfo info = BlockCodec::encode(block.data(), block.size(), grid, encoded);
+    std::vector<float> decoded(block.size());
+    bool ok = BlockCodec::decode(encoded.data(), encoded.size(), info, grid, decoded.size(), decoded.data());
+
+    std::cout << "  " << block.size() << " samples -> " << encoded.size() << " bytes, k = "
+              << static_cast<int>(info.riceParameter) << std::endl;
+    check(info.mode == BlockCodec::RICE_DELTA, "ADC block is Rice coded");
+    check(ok && sameBits(block, decoded), "ADC block decodes bit-exactly");
+
+    // Jumps across most of the 16-bit range force the escape code
+    for (size_t i = 100; i < block.size(); i += 500) {
+        block[i] = static_cast<float>(i % 1000 < 500 ? 32000 : -32000) * scale + offset;
+    }
+    encoded.clear();
+    info = BlockCodec::encode(block.data(), block.size(), grid, encoded);
+    ok = BlockCodec::decode(encoded.data(), encoded.size(), info, grid, decoded.size(), decoded.data());
+    check(info.mode == BlockCodec::RICE_DELTA, "block with large jumps is still Rice coded");
+    check(ok && sameBits(block, decoded), "escaped deltas decode bit-exactly");
+
+    // One sample off the grid keeps the whole block raw
+    block[7] += scale * 0.5f;
+    encoded.clear();
+    info = BlockCodec::encode(block.data(), block.size(), grid, encoded);
+    ok = BlockCodec::decode(encoded.data(), encoded.size(), info, grid, decoded.size(), decoded.data());
+    check(info.mode == BlockCodec::RAW_FLOAT, "off-grid block is stored raw");
+    check(ok && sameBits(block, decoded), "raw block decodes bit-exactly");
+
+    // Truncated payloads are reported, not read past
+    encoded.clear();
+    block[7] -= scale * 0.5f;
+    info = BlockCodec::encode(block.data(), block.size(), grid, encoded);
+    ok = BlockCodec::decode(encoded.data(), encoded.size() / 2, info, grid, decoded.size(), decoded.data());
+    check(!ok, "truncated block is rejected");
+}
+
+void testCacheRoundTrip(const std::string& path) {
+    std::cout << "\n=== Testing Channel Cache Round Trip ===" << std::endl;
+
+    const float scale = 0.0061035156f;
+    const float offset = 0.5f;
+    auto adcSamples = generateAdcSignal(100003, scale, offset, 7);
+    auto adcChannel = makeChannel("ECG", adcSamples, 2000.0f);
+    adcChannel->setAdcScale(scale, offset);
+
+    // Converter output: no known scaling, stored raw
+    std::vector<float> floatSamples(31251);
+    for (size_t i = 0; i < floatSamples.size(); ++i) {
+        floatSamples[i] = static_cast<float>(std::sin(0.01 * i) * 3.7 + 1000.0);
+    }
+    auto floatChannel = makeChannel("Resp", floatSamples, 31.25f);
+
+    ChannelCacheWriter writer;
+    writer.setSource(123456, 987654321);
+    writer.addChannel(adcChannel);
+    writer.addChannel(floatChannel);
+    bool written = writer.writeFile(path);
+    check(written, "cache written (" + std::to_string(writer.getBytesWritten()) + " bytes)");
+    if (!written) {
+        std::cerr << "  " << writer.getLastError() << std::endl;
+        return;
+    }
+
+    ChannelCacheReader reader;
+    auto file = reader.readFile(path, 123456, 987654321);
+    check(file != nullptr, "current cache loads");
+    if (!file) {
+        std::cerr << "  " << reader.getLastError() << std::endl;
+        return;
+    }
+
+    const auto& channels = file->getChannels();
+    check(channels.size() == 2, "both channels present");
+    if (channels.size() == 2) {
+        check(sameBits(channels[0]->getData().toVector(), adcSamples), "ADC channel is bit-exact");
+        check(channels[0]->hasAdcScale() && channels[0]->getAdcScale() == scale &&
+              channels[0]->getAdcOffset() == offset, "ADC scaling restored");
+        check(sameBits(channels[1]->getData().toVector(), floatSamples), "float channel is bit-exact");
+        check(channels[1]->getSampleRate() == 31.25f, "sample rate restored");
+    }
+
+    // A changed source stamp makes the cache stale
+    ChannelCacheReader staleReader;
+    check(staleReader.readFile(path, 123457, 987654321) == nullptr, "changed source size is rejected");
+    check(staleReader.readFile(path, 123456, 987654322) == nullptr, "changed source mtime is rejected");
+}
+
+void testCorruption(const std::string& path) {
+    std::cout << "\n=== Testing Checksum Rejection ===" << std::endl;
+
+    // Flip one payload byte just after the header
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(100);
+        char byte = 0;
+        file.read(&byte, 1);
+        byte ^= 0x10;
+        file.seekp(100);
+        file.write(&byte, 1);
+    }
+
+    ChannelCacheReader reader;
+    check(reader.readFile(path, 123456, 987654321) == nullptr, "corrupt payload is rejected");
+    std::cout << "  Reader error: " << reader.getLastError() << std::endl;
+
+    // Flip one index byte (the footer's CRC covers the index)
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    bytes[100] ^= 0x10;                // Undo the payload flip
+    bytes[bytes.size() - 30] ^= 0x01;  // Inside the index
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    check(reader.readFile(path, 123456, 987654321) == nullptr, "corrupt index is rejected");
+    std::cout << "  Reader error: " << reader.getLastError() << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Channel Cache Test Suite" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    std::string path = argc > 1 ? argv[1] : "test_channel_cache.acqc";
+
+    testBlockRoundTrip();
+    testCacheRoundTrip(path);
+    testCorruption(path);
+    std::remove(path.c_str());
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  " << (failures == 0 ? "All tests passed!" : std::to_string(failures) + " test(s) failed")
+              << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -3,13 +3,20 @@
  * @brief Test program for DSP filters
  *
  * Compile separately with:
- * g++ -std=c++17 -I../inc/backend test_filters.cpp ../src/backend/DSPFilters.cpp -o test_filters -lm
+ * g++ -std=c++17 -O2 -I../inc/backend -I../inc/models test_filters.cpp ../src/backend/DSPFilters.cpp -o test_filters -lm -pthread
+ *
+ * Usage:
+ * ./test_filters [benchmark samples (default 10000000)] [parallel benchmark samples (default 100000000)]
  */
 
 #include <iostream>
 #include <vector>
 #include <cmath>
 #include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
 #include "DSPFilters.h"
 
 #ifndef M_PI
@@ -204,7 +211,297 @@ void testNotch(DSPFilters& filters, const std::vector<float>& signal, float samp
     saveToCSV("notch_test.csv", signal, filtered);
 }
 
-int main() {
+/**
+ * @brief Test narrow powerline notch filter
+ */
+void testPowerlineNotch(DSPFilters& filters, const std::vector<float>& signal, float sampleRate) {
+    std::cout << "\n=== Testing Powerline Notch Filter ===" << std::endl;
+
+    float notchFreq = 50.0f;
+    float q = 30.0f;
+
+    std::cout << "Applying narrow notch: " << notchFreq << " Hz, Q=" << q << std::endl;
+
+    auto filtered = filters.narrowNotch(signal, sampleRate, notchFreq, q);
+
+    if (!filters.getLastError().empty()) {
+        std::cerr << "Error: " << filters.getLastError() << std::endl;
+        return;
+    }
+
+    float originalRMS = calculateRMS(signal);
+    float filteredRMS = calculateRMS(filtered);
+
+    std::cout << "Original RMS: " << originalRMS << std::endl;
+    std::cout << "Filtered RMS: " << filteredRMS << std::endl;
+    std::cout << "Only the 50 Hz component should be removed" << std::endl;
+
+    saveToCSV("powerline_notch_test.csv", signal, filtered);
+}
+
+void testProgressAndCancel(float sampleRate) {
+    std::cout << "\n=== Testing Progress and Cancellation ===" << std::endl;
+
+    std::vector<float> signal(4000000, 1.0f);
+    DSPFilters filters;
+
+    int reports = 0;
+    double lastProgress = 0.0;
+    filters.setProgressCallback([&](double progress) {
+        ++reports;
+        lastProgress = progress;
+        return true;
+    });
+    bool completed = filters.applyFilterInPlace(signal.data(), signal.size(), sampleRate,
+                                                DSPFilters::LOWPASS, 100.0f, 0.0f, 4, true);
+    std::cout << "Zero-phase run: " << (completed ? "completed" : "failed") << ", "
+              << reports << " progress reports, last " << lastProgress << std::endl;
+
+    // Cancel halfway through
+    filters.setProgressCallback([](double progress) { return progress < 0.5; });
+    completed = filters.applyFilterInPlace(signal.data(), signal.size(), sampleRate,
+                                           DSPFilters::LOWPASS, 100.0f, 0.0f, 4);
+    std::cout << "Cancelled run: " << (completed ? "completed (unexpected)" : filters.getLastError())
+              << std::endl;
+}
+
+void testInvalidBand(DSPFilters& filters, const std::vector<float>& signal, float sampleRate) {
+    std::cout << "\n=== Testing Band Filters Without Upper Edge ===" << std::endl;
+
+    // freq2 = 0 must be rejected (input returned), not designed into NaN sections
+    auto filtered = filters.bandpass(signal, sampleRate, 10.0f, 0.0f, 4);
+    std::cout << "Bandpass 10/0 Hz: " << (filtered == signal ? "unchanged" : "changed (unexpected)")
+              << ", error: " << (filters.getLastError().empty() ? "none (unexpected)" : filters.getLastError())
+              << std::endl;
+
+    auto range = filters.applyFilterRange(signal, 0, signal.size() / 2, sampleRate,
+                                          DSPFilters::NOTCH, 40.0f, 0.0f, 4);
+    bool finite = std::all_of(range.begin(), range.end(), [](float v) { return std::isfinite(v); });
+    std::cout << "Range band-stop 40/0 Hz: " << (finite ? "finite" : "NaN (unexpected)")
+              << ", error: " << (filters.getLastError().empty() ? "none (unexpected)" : filters.getLastError())
+              << std::endl;
+}
+
+void testZeroPhase(DSPFilters& filters, const std::vector<float>& signal, float sampleRate) {
+    std::cout << "\n=== Testing Zero-Phase Lowpass ===" << std::endl;
+
+    float cutoff = 30.0f;
+    int order = 4;
+
+    std::cout << "Applying lowpass forward and backward: cutoff=" << cutoff
+              << " Hz, order=" << order << std::endl;
+
+    auto causal = filters.lowpass(signal, sampleRate, cutoff, order);
+    auto zeroPhase = filters.lowpass(signal, sampleRate, cutoff, order, true);
+
+    if (!filters.getLastError().empty()) {
+        std::cerr << "Error: " << filters.getLastError() << std::endl;
+        return;
+    }
+
+    // Compare against the DC + 10 Hz part of the signal, which should pass
+    // unchanged and, without phase shift, stay aligned with the input.
+    // The outer 10% are skipped: the reflected padding pins each end of the
+    // zero-phase output to the raw end sample, 50/200 Hz content included.
+    float causalError = 0.0f;
+    float zeroPhaseError = 0.0f;
+    size_t margin = signal.size() / 10;
+    for (size_t i = margin; i < signal.size() - margin; ++i) {
+        float expected = 2.0f + std::sin(2.0f * M_PI * 10.0f * (i / sampleRate));
+        causalError = std::max(causalError, std::abs(causal[i] - expected));
+        zeroPhaseError = std::max(zeroPhaseError, std::abs(zeroPhase[i] - expected));
+    }
+
+    std::cout << "Max error vs. DC + 10 Hz, causal:     " << causalError << std::endl;
+    std::cout << "Max error vs. DC + 10 Hz, zero-phase: " << zeroPhaseError << std::endl;
+    std::cout << "Zero-phase output should follow the input without delay" << std::endl;
+
+    saveToCSV("zero_phase_test.csv", signal, zeroPhase);
+}
+
+/**
+ * @brief Legacy per-section IIR (one output and state allocation per section)
+ *
+ * Kept here as the baseline for benchmarkCascade().
+ */
+std::vector<float> legacyApplyIIR(const std::vector<float>& data,
+                                  const std::vector<double>& b,
+                                  const std::vector<double>& a) {
+    std::vector<float> output(data.size(), 0.0f);
+    std::vector<double> state(a.size() - 1, 0.0);
+
+    for (size_t n = 0; n < data.size(); ++n) {
+        double x = data[n];
+        double y = b[0] * x + state[0];
+        output[n] = static_cast<float>(y);
+
+        for (size_t i = 0; i < state.size() - 1; ++i) {
+            state[i] = state[i + 1] + b[i + 1] * x - a[i + 1] * y;
+        }
+        size_t last = state.size() - 1;
+        state[last] = b[last + 1] * x - a[last + 1] * y;
+    }
+
+    return output;
+}
+
+std::vector<float> legacyCascade(const std::vector<float>& data,
+                                 const std::vector<DSPFilters::ButterworthCoeffs>& sections) {
+    std::vector<float> result = data;
+    for (const auto& s : sections) {
+        result = legacyApplyIIR(result, {s.b0, s.b1, s.b2}, {1.0, s.a1, s.a2});
+    }
+    return result;
+}
+
+/**
+ * @brief Benchmark the fused in-place cascade against the legacy path
+ */
+void benchmarkCascade(DSPFilters& filters, size_t numSamples, float sampleRate) {
+    std::cout << "\n=== Benchmark: Biquad Cascade ===" << std::endl;
+
+    int order = 8;
+    float cutoff = 100.0f;
+    std::cout << "Lowpass order " << order << ", " << numSamples << " samples" << std::endl;
+
+    std::vector<float> signal(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        signal[i] = std::sin(2.0f * M_PI * 10.0f * (i / sampleRate)) +
+                    0.1f * std::sin(2.0f * M_PI * 400.0f * (i / sampleRate));
+    }
+
+    auto sections = filters.getSections(DSPFilters::LOWPASS, sampleRate, cutoff, 0.0f, order);
+
+    auto start = std::chrono::steady_clock::now();
+    auto legacy = legacyCascade(signal, sections);
+    double legacyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<float> fused = signal;
+    start = std::chrono::steady_clock::now();
+    filters.applyFilterInPlace(fused.data(), fused.size(), sampleRate, DSPFilters::LOWPASS, cutoff, 0.0f, order);
+    double fusedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < numSamples; ++i) {
+        maxDiff = std::max(maxDiff, std::abs(legacy[i] - fused[i]));
+    }
+
+    std::cout << "Legacy per-section: " << legacyMs << " ms" << std::endl;
+    std::cout << "Fused in-place:     " << fusedMs << " ms" << std::endl;
+    std::cout << "Speedup: " << (legacyMs / fusedMs) << "x, max |diff| = " << maxDiff << std::endl;
+}
+
+/**
+ * @brief Benchmark the SIMD multi-channel cascade against one channel at a time
+ */
+void benchmarkMultiChannel(DSPFilters& filters, size_t numSamples, float sampleRate) {
+    std::cout << "\n=== Benchmark: Multi-Channel Cascade ===" << std::endl;
+
+    const size_t numChannels = 8;
+    const size_t perChannel = numSamples / numChannels;
+    int order = 8;
+    float cutoff = 100.0f;
+    std::cout << "Lowpass order " << order << ", " << numChannels << " channels x "
+              << perChannel << " samples, " << DSPFilters::getSimdLaneCount()
+              << " SIMD lanes" << std::endl;
+
+    std::vector<std::vector<float>> channels(numChannels, std::vector<float>(perChannel));
+    for (size_t c = 0; c < numChannels; ++c) {
+        for (size_t i = 0; i < perChannel; ++i) {
+            channels[c][i] = std::sin(2.0f * M_PI * (5.0f + c) * (i / sampleRate)) +
+                             0.1f * std::sin(2.0f * M_PI * 400.0f * (i / sampleRate));
+        }
+    }
+
+    auto scalar = channels;
+    auto start = std::chrono::steady_clock::now();
+    for (auto& channel : scalar) {
+        filters.applyFilterInPlace(channel.data(), channel.size(), sampleRate,
+                                   DSPFilters::LOWPASS, cutoff, 0.0f, order);
+    }
+    double scalarMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    auto lanes = channels;
+    std::vector<float*> pointers;
+    for (auto& channel : lanes) {
+        pointers.push_back(channel.data());
+    }
+    start = std::chrono::steady_clock::now();
+    filters.applyFilterMultiChannel(pointers, perChannel, sampleRate,
+                                    DSPFilters::LOWPASS, cutoff, 0.0f, order);
+    double lanesMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    float maxDiff = 0.0f;
+    for (size_t c = 0; c < numChannels; ++c) {
+        for (size_t i = 0; i < perChannel; ++i) {
+            maxDiff = std::max(maxDiff, std::abs(scalar[c][i] - lanes[c][i]));
+        }
+    }
+
+    std::cout << "Per channel (scalar): " << scalarMs << " ms" << std::endl;
+    std::cout << "SIMD lanes:           " << lanesMs << " ms" << std::endl;
+    std::cout << "Speedup: " << (scalarMs / lanesMs) << "x, max |diff| = " << maxDiff << std::endl;
+}
+
+/**
+ * @brief Scaling of the chunk-parallel cascade over 1..N threads
+ */
+void benchmarkParallel(size_t numSamples, float sampleRate) {
+    std::cout << "\n=== Benchmark: Chunk-Parallel Cascade ===" << std::endl;
+
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    int order = 8;
+    float cutoff = 100.0f;
+    std::cout << "Lowpass order " << order << ", " << numSamples << " samples, up to "
+              << maxThreads << " threads" << std::endl;
+
+    std::vector<float> signal(numSamples);
+    for (size_t i = 0; i < numSamples; ++i) {
+        signal[i] = 1.0f + std::sin(2.0f * M_PI * 10.0f * (i / sampleRate)) +
+                    0.1f * std::sin(2.0f * M_PI * 400.0f * (i / sampleRate));
+    }
+
+    DSPFilters serial;
+    serial.setNumThreads(1);
+    std::vector<float> reference = signal;
+    auto start = std::chrono::steady_clock::now();
+    serial.applyFilterInPlace(reference.data(), reference.size(), sampleRate,
+                              DSPFilters::LOWPASS, cutoff, 0.0f, order);
+    double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Serial: " << serialMs << " ms" << std::endl;
+
+    std::vector<float> work;
+    for (int mode = DSPFilters::PARALLEL_EXACT; mode <= DSPFilters::PARALLEL_WARMUP; ++mode) {
+        std::cout << (mode == DSPFilters::PARALLEL_EXACT ? "Exact state propagation:" : "Overlap warm-up:") << std::endl;
+
+        // 1, 2, 4, ... threads, always ending on maxThreads
+        for (unsigned threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+            DSPFilters filters;
+            filters.setNumThreads(threads);
+            filters.setParallelMode(static_cast<DSPFilters::ParallelMode>(mode));
+
+            work = signal;
+            start = std::chrono::steady_clock::now();
+            filters.applyFilterInPlace(work.data(), work.size(), sampleRate,
+                                       DSPFilters::LOWPASS, cutoff, 0.0f, order);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            float maxDiff = 0.0f;
+            for (size_t i = 0; i < numSamples; ++i) {
+                maxDiff = std::max(maxDiff, std::abs(work[i] - reference[i]));
+            }
+
+            std::cout << "  " << threads << " threads: " << ms << " ms, speedup "
+                      << (serialMs / ms) << "x, max |diff| = " << maxDiff << std::endl;
+
+            if (threads == maxThreads) {
+                break;
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
     std::cout << "========================================" << std::endl;
     std::cout << "  DSP Filters Test Suite" << std::endl;
     std::cout << "========================================" << std::endl;
@@ -234,6 +531,18 @@ int main() {
     testHighpass(filters, signal, sampleRate);
     testBandpass(filters, signal, sampleRate);
     testNotch(filters, signal, sampleRate);
+    testPowerlineNotch(filters, signal, sampleRate);
+    testZeroPhase(filters, signal, sampleRate);
+    testInvalidBand(filters, signal, sampleRate);
+    testProgressAndCancel(sampleRate);
+
+    // Benchmarks
+    size_t benchSamples = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    benchmarkCascade(filters, benchSamples, sampleRate);
+    benchmarkMultiChannel(filters, benchSamples, sampleRate);
+
+    size_t parallelSamples = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000000;
+    benchmarkParallel(parallelSamples, sampleRate);
 
     std::cout << "\n========================================" << std::endl;
     std::cout << "  All tests completed!" << std::endl;
@@ -243,6 +552,8 @@ int main() {
     std::cout << "  - highpass_test.csv" << std::endl;
     std::cout << "  - bandpass_test.csv" << std::endl;
     std::cout << "  - notch_test.csv" << std::endl;
+    std::cout << "  - powerline_notch_test.csv" << std::endl;
+    std::cout << "  - zero_phase_test.csv" << std::endl;
     std::cout << "\nVisualize with: python3 -c \"import pandas as pd; import matplotlib.pyplot as plt; ..." << std::endl;
 
     return 0;
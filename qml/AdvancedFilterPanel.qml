@@ -163,7 +163,7 @@ Rectangle {
                             id: lowpassOrderSpin
                             Layout.columnSpan: 2
                             from: 1
-                            to: 8
+                            to: 10
                             value: filterOrder
                             onValueChanged: filterOrder = value
                         }
@@ -242,7 +242,7 @@ Rectangle {
                             id: highpassOrderSpin
                             Layout.columnSpan: 2
                             from: 1
-                            to: 8
+                            to: 10
                             value: filterOrder
                             onValueChanged: filterOrder = value
                         }
@@ -364,7 +364,7 @@ Rectangle {
                             id: bandpassOrderSpin
                             Layout.columnSpan: 2
                             from: 1
-                            to: 8
+                            to: 10
                             value: filterOrder
                             onValueChanged: filterOrder = value
                         }
@@ -486,7 +486,7 @@ Rectangle {
                             id: notchOrderSpin
                             Layout.columnSpan: 2
                             from: 1
-                            to: 8
+                            to: 10
                             value: filterOrder
                             onValueChanged: filterOrder = value
                         }
@@ -19,6 +19,13 @@ Window {
     property int highpassOrderValue: 4
     property int bandpassOrderValue: 4
     property real notchFrequency: 50.0  // Default 50 Hz
+    property bool zeroPhase: false      // Forward-backward filtering
+    property bool allChannels: false    // Apply to every channel of the recording
+    property int filterJobId: -1        // Running filter job
+    property int filterProgress: 0
+
+    onZeroPhaseChanged: updatePreview()
+    onVisibleChanged: visible ? updatePreview() : filterController.clearPreview()
 
     onLowpassOrderValueChanged: updateFrequencyResponse()
     onHighpassOrderValueChanged: updateFrequencyResponse()
@@ -30,6 +37,13 @@ Window {
 
     // Function to update frequency response preview
     function updateFrequencyResponse() {
+        // A running job was started with the old parameters
+        if (filterController.isFiltering) {
+            filterController.cancelFilter()
+        }
+
+        updatePreview()
+
         frequencyResponseSeries.clear()
 
         var sampleRate = appController.sampleRate
@@ -45,6 +59,27 @@ Window {
         }
     }
 
+    // Filter just the visible part of the waveform while parameters change;
+    // the whole recording is only filtered on Apply
+    function updatePreview() {
+        if (!visible || !appController.hasData) {
+            return
+        }
+
+        if (lowpassSwitch.checked) {
+            filterController.updatePreview("lowpass", lowpassSlider.value, 0, lowpassOrderValue, zeroPhase)
+        } else if (highpassSwitch.checked) {
+            filterController.updatePreview("highpass", highpassSlider.value, 0, highpassOrderValue, zeroPhase)
+        } else if (bandpassSwitch.checked) {
+            filterController.updatePreview("bandpass", bandpassLowSlider.value, bandpassHighSlider.value,
+                                           bandpassOrderValue, zeroPhase)
+        } else if (notchSwitch.checked) {
+            filterController.updatePreview("powerline", notchFrequency, 30, 4, zeroPhase)
+        } else {
+            filterController.clearPreview()
+        }
+    }
+
     // Calculate filter magnitude response at given frequency
     function calculateFilterMagnitude(freq, sampleRate) {
         var nyquist = sampleRate / 2
@@ -1331,6 +1366,119 @@ Window {
                                     }
                                 }
 
+                                // Zero-phase option
+                                Row {
+                                    Layout.fillWidth: true
+                                    spacing: 10
+
+                                    Rectangle {
+                                        width: 3
+                                        height: 20
+                                        color: "#00aaff"
+                                        radius: 2
+                                    }
+
+                                    Text {
+                                        text: "Zero Phase"
+                                        font.pixelSize: 13
+                                        font.bold: true
+                                        color: "#e0e0e0"
+                                        anchors.verticalCenter: parent.verticalCenter
+                                    }
+
+                                    Rectangle {
+                                        width: parent.width - 200
+                                        height: 1
+                                    }
+
+                                    Switch {
+                                        id: zeroPhaseSwitch
+                                        checked: zeroPhase
+                                        enabled: !allChannels
+                                        anchors.verticalCenter: parent.verticalCenter
+                                        onCheckedChanged: zeroPhase = checked
+
+                                        indicator: Rectangle {
+                                            implicitWidth: 40
+                                            implicitHeight: 20
+                                            x: parent.leftPadding
+                                            y: parent.height / 2 - height / 2
+                                            radius: 10
+                                            color: parent.checked ? "#00aaff" : "#2a3f5f"
+                                            border.color: parent.checked ? "#00aaff" : "#2a3f5f"
+
+                                            Rectangle {
+                                                x: parent.parent.checked ? parent.width - width - 2 : 2
+                                                y: 2
+                                                width: 16
+                                                height: 16
+                                                radius: 8
+                                                color: "#e0e0e0"
+
+                                                Behavior on x {
+                                                    NumberAnimation { duration: 100 }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+
+                                // All-channels option (single pass, no zero-phase)
+                                Row {
+                                    Layout.fillWidth: true
+                                    spacing: 10
+
+                                    Rectangle {
+                                        width: 3
+                                        height: 20
+                                        color: "#00aaff"
+                                        radius: 2
+                                    }
+
+                                    Text {
+                                        text: "All Channels"
+                                        font.pixelSize: 13
+                                        font.bold: true
+                                        color: "#e0e0e0"
+                                        anchors.verticalCenter: parent.verticalCenter
+                                    }
+
+                                    Rectangle {
+                                        width: parent.width - 200
+                                        height: 1
+                                    }
+
+                                    Switch {
+                                        id: allChannelsSwitch
+                                        checked: allChannels
+                                        anchors.verticalCenter: parent.verticalCenter
+                                        onCheckedChanged: allChannels = checked
+
+                                        indicator: Rectangle {
+                                            implicitWidth: 40
+                                            implicitHeight: 20
+                                            x: parent.leftPadding
+                                            y: parent.height / 2 - height / 2
+                                            radius: 10
+                                            color: parent.checked ? "#00aaff" : "#2a3f5f"
+                                            border.color: parent.checked ? "#00aaff" : "#2a3f5f"
+
+                                            Rectangle {
+                                                x: parent.parent.checked ? parent.width - width - 2 : 2
+                                                y: 2
+                                                width: 16
+                                                height: 16
+                                                radius: 8
+                                                color: "#e0e0e0"
+
+                                                Behavior on x {
+                                                    NumberAnimation { duration: 100 }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+
                                 Rectangle {
                                     Layout.fillHeight: true
                                 }
@@ -1370,7 +1518,9 @@ Window {
                                     Button {
                                         width: parent.width
                                         height: 46
-                                        text: "Apply Configuration"
+                                        text: filterController.isFiltering
+                                              ? "Filtering... " + filterProgress + "%"
+                                              : "Apply Configuration"
                                         enabled: appController.hasData
 
                                         background: Rectangle {
@@ -1399,43 +1549,112 @@ Window {
     }
 
     function applyFilter() {
-        var filtered
+        var jobId
+
+        if (allChannels) {
+            applyFilterAllChannels()
+            return
+        }
 
         if (lowpassSwitch.checked) {
             var cutoff = lowpassSlider.value
             var order = lowpassOrderValue
 
             console.log("Applying lowpass filter:", cutoff, "Hz, order", order)
-            filtered = filterController.applyLowpass(cutoff, order)
+            jobId = filterController.startFilter("lowpass", cutoff, 0, order, zeroPhase)
         } else if (highpassSwitch.checked) {
             var cutoff = highpassSlider.value
             var order = highpassOrderValue
 
             console.log("Applying highpass filter:", cutoff, "Hz, order", order)
-            filtered = filterController.applyHighpass(cutoff, order)
+            jobId = filterController.startFilter("highpass", cutoff, 0, order, zeroPhase)
         } else if (bandpassSwitch.checked) {
             var low = bandpassLowSlider.value
             var high = bandpassHighSlider.value
             var order = bandpassOrderValue
 
             console.log("Applying bandpass filter:", low, "-", high, "Hz, order", order)
-            filtered = filterController.applyBandpass(low, high, order)
+            jobId = filterController.startFilter("bandpass", low, high, order, zeroPhase)
+        } else if (notchSwitch.checked) {
+            console.log("Applying powerline notch:", notchFrequency, "Hz, Q 30")
+            jobId = filterController.startFilter("powerline", notchFrequency, 30, 4, zeroPhase)
         } else {
             console.log("No filters enabled")
             return
         }
 
-        console.log("Filter returned:", filtered ? filtered.length : 0, "points")
-
-        if (filtered && filtered.length > 0) {
-            console.log("Applying filter with", filtered.length, "points")
-            appController.applyFilteredData(filtered)
-            console.log("Filter applied successfully")
-            filterWindow.close()
-        } else {
-            console.error("Filter failed or returned no data")
+        if (jobId < 0) {
+            console.error("Filter could not be started:", filterController.lastError)
             console.error("  Has data:", filterController.hasData)
             console.error("  Sample rate:", filterController.getSampleRate())
+            return
+        }
+
+        // Runs in the background; results arrive in onFilterFinished
+        filterJobId = jobId
+        filterProgress = 0
+    }
+
+    // Every channel of the recording in one multi-channel pass (forward only)
+    function applyFilterAllChannels() {
+        var jobId
+
+        if (lowpassSwitch.checked) {
+            console.log("Applying lowpass filter to all channels:", lowpassSlider.value, "Hz")
+            jobId = filterController.startFilterAllChannels("lowpass", lowpassSlider.value, 0, lowpassOrderValue)
+        } else if (highpassSwitch.checked) {
+            console.log("Applying highpass filter to all channels:", highpassSlider.value, "Hz")
+            jobId = filterController.startFilterAllChannels("highpass", highpassSlider.value, 0, highpassOrderValue)
+        } else if (bandpassSwitch.checked) {
+            console.log("Applying bandpass filter to all channels:", bandpassLowSlider.value, "-",
+                        bandpassHighSlider.value, "Hz")
+            jobId = filterController.startFilterAllChannels("bandpass", bandpassLowSlider.value,
+                                                            bandpassHighSlider.value, bandpassOrderValue)
+        } else if (notchSwitch.checked) {
+            console.log("Applying powerline notch to all channels:", notchFrequency, "Hz, Q 30")
+            jobId = filterController.startFilterAllChannels("powerline", notchFrequency, 30, 4)
+        } else {
+            console.log("No filters enabled")
+            return
+        }
+
+        if (jobId < 0) {
+            console.error("Filter could not be started:", filterController.lastError)
+            return
+        }
+
+        // main.cpp swaps in the filtered channels on allChannelsFiltered
+        filterJobId = jobId
+        filterProgress = 0
+    }
+
+    Connections {
+        target: filterController
+
+        function onFilterProgress(jobId, percent) {
+            if (jobId === filterJobId) {
+                filterProgress = percent
+            }
+        }
+
+        function onFilterFinished(jobId, filterType) {
+            if (jobId !== filterJobId) {
+                return
+            }
+
+            // The samples stay in C++; only the job id crosses into QML
+            if (appController.commitFilterResult(jobId)) {
+                console.log("Filter applied successfully")
+                filterWindow.close()
+            } else {
+                console.error("Filter failed or returned no data")
+            }
+        }
+
+        function onAllChannelsFiltered(filterType) {
+            console.log("Filter applied to all channels:", filterType)
+            filterJobId = -1
+            filterWindow.close()
         }
     }
 }
@@ -151,7 +151,7 @@ Rectangle {
                             id: lowpassOrder
                             Layout.fillWidth: true
                             from: 1
-                            to: 8
+                            to: 10
                             value: 4
                         }
 
@@ -196,7 +196,7 @@ Rectangle {
                             id: highpassOrder
                             Layout.fillWidth: true
                             from: 1
-                            to: 8
+                            to: 10
                             value: 2
                         }
 
@@ -250,7 +250,7 @@ Rectangle {
                             id: bandpassOrder
                             Layout.fillWidth: true
                             from: 1
-                            to: 8
+                            to: 10
                             value: 4
                         }
 
@@ -307,7 +307,7 @@ Rectangle {
                             id: notchOrder
                             Layout.fillWidth: true
                             from: 1
-                            to: 8
+                            to: 10
                             value: 4
                         }
 
@@ -586,6 +586,39 @@ Item {
                             }
                         }
 
+                        // Spectrogram toggle
+                        Button {
+                            width: 90
+                            height: 32
+                            text: "Spectrogram"
+                            checkable: true
+                            checked: waveformView.spectrogramVisible
+                            enabled: appController.hasData
+                            ToolTip.visible: hovered
+                            ToolTip.text: "Show the time-frequency spectrogram behind the waveform"
+                            ToolTip.delay: 500
+
+                            background: Rectangle {
+                                color: parent.checked ? "#00aaff" : (parent.enabled ? (parent.hovered ? "#2a3f5f" : "#1a2844") : "#1a1f2e")
+                                border.color: parent.enabled ? "#00aaff" : "#2a3f5f"
+                                border.width: 1
+                                radius: 4
+                            }
+
+                            contentItem: Text {
+                                text: parent.text
+                                font.pixelSize: 9
+                                color: parent.checked ? "#0a0e1a" : (parent.enabled ? "#00aaff" : "#505050")
+                                horizontalAlignment: Text.AlignHCenter
+                                verticalAlignment: Text.AlignVCenter
+                                font.bold: parent.checked
+                            }
+
+                            onClicked: {
+                                waveformView.spectrogramVisible = !waveformView.spectrogramVisible
+                            }
+                        }
+
                         Rectangle {
                             width: 1
                             height: 24
@@ -631,7 +664,7 @@ Item {
                         Button {
                             width: 100
                             height: 32
-                            text: "Export CSV"
+                            text: "Export"
                             enabled: appController.hasData
 
                             background: Rectangle {
@@ -744,11 +777,11 @@ Item {
     FileDialog {
         id: fileDialog
         title: "Select ACQ File"
-        nameFilters: ["ACQ files (*.acq)", "All files (*)"]
+        nameFilters: ["ACQ files (*.acq)", "EDF / EDF+ files (*.edf)", "NumPy / raw float32 exports (*.npy *.npz *.f32)", "All files (*)"]
         onAccepted: {
             var path = fileDialog.selectedFile.toString()
             path = path.replace(/^file:\/\//, "")
-            appController.loadACQFile(path)
+            appController.loadFile(path)
         }
     }
 
@@ -757,7 +790,8 @@ Item {
         id: saveDialog
         title: "Save Labels as JSON"
         fileMode: FileDialog.SaveFile
-        nameFilters: ["JSON files (*.json)", "All files (*)"]
+        // The second filter writes voltages to a packed float32 sidecar
+        nameFilters: ["JSON files (*.json)", "JSON + binary voltages (*.json)", "All files (*)"]
         defaultSuffix: "json"
 
         currentFolder: {
@@ -786,9 +820,10 @@ Item {
             console.log("Save dialog accepted, raw path:", path)
             path = path.replace(/^file:\/\//, "")
             console.log("Cleaned path:", path)
-            console.log("Saving", labelManager.labelCount, "labels to:", path)
+            var binarySidecar = saveDialog.selectedNameFilter.index === 1
+            console.log("Saving", labelManager.labelCount, "labels to:", path, binarySidecar ? "(binary voltages)" : "")
 
-            if (labelManager.saveToFile(path)) {
+            if (labelManager.saveToFile(path, binarySidecar)) {
                 console.log("✓ SUCCESS: Saved", labelManager.labelCount, "labels to", path)
                 console.log("✓ You can now open the file:", path)
             } else {
@@ -804,9 +839,18 @@ Item {
     // CSV export dialog
     FileDialog {
         id: csvExportDialog
-        title: "Export Waveform as CSV"
+        title: "Export Waveform"
         fileMode: FileDialog.SaveFile
-        nameFilters: ["CSV files (*.csv)", "All files (*)"]
+        // Filter index selects what is exported
+        nameFilters: ["CSV, displayed channel (*.csv)",
+                      "CSV, all channels (*.csv)",
+                      "CSV, labelled segments of all channels (*.csv)",
+                      "NumPy archive, all channels (*.npz)",
+                      "NumPy archive, labelled segments (*.npz)",
+                      "NumPy array, displayed channel (*.npy)",
+                      "Raw float32 + JSON header, all channels (*.f32)",
+                      "EDF+, all channels with labels as annotations (*.edf)",
+                      "All files (*)"]
         defaultSuffix: "csv"
 
         currentFolder: {
@@ -836,7 +880,39 @@ Item {
             path = path.replace(/^file:\/\//, "")
             console.log("Cleaned path:", path)
 
-            if (appController.exportToCSV(path)) {
+            // Binary formats are chosen by extension, so make sure it matches
+            var index = csvExportDialog.selectedNameFilter.index
+            var suffixes = [".csv", ".csv", ".csv", ".npz", ".npz", ".npy", ".f32", ".edf"]
+            if (index < suffixes.length && !path.toLowerCase().endsWith(suffixes[index])) {
+                path = path.replace(/\.csv$/i, "") + suffixes[index]
+            }
+
+            var ok
+            switch (index) {
+            case 1:
+                ok = appController.exportToCSV(path, true)
+                break
+            case 2:
+                ok = appController.exportLabelsToCSV(path, labelManager.labels, true)
+                break
+            case 3:
+            case 6:
+                ok = appController.exportArrays(path, true)
+                break
+            case 4:
+                ok = appController.exportLabelArrays(path, labelManager.labels, true)
+                break
+            case 5:
+                ok = appController.exportArrays(path)
+                break
+            case 7:
+                ok = appController.exportToEDF(path, labelManager.labels)
+                break
+            default:
+                ok = appController.exportToCSV(path)
+            }
+
+            if (ok) {
                 console.log("✓ SUCCESS: Exported waveform to", path)
             } else {
                 console.error("✗ ERROR: Failed to export waveform to", path)
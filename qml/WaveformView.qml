@@ -1,6 +1,7 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtCharts 2.15
+import ACQProcessor 1.0
 
 Rectangle {
     id: waveformView
@@ -19,6 +20,8 @@ Rectangle {
     property bool zoomModeActive: false
     property real zoomBoxStartX: -1
     property real zoomBoxEndX: -1
+    property bool spectrogramVisible: false
+    property var spectrogramTiles: []
 
     // Update overlay selection when selectedLabelId changes
     onSelectedLabelIdChanged: {
@@ -73,23 +76,18 @@ Rectangle {
     property real yPanPosition: 0.5
 
     function loadWaveform() {
-        lineSeries.clear()
-
-        var points = appController.getWaveformData(10000)
+        var numSamples = appController.numSamples
         var sampleRate = appController.sampleRate
 
-        if (points && points.length > 0 && sampleRate > 0) {
-            var minY = points[0].y
-            var maxY = points[0].y
+        // Whole-file min/max; the trace itself is drawn by waveformItem
+        var extent = appController.getWaveformExtent(0, numSamples)
 
-            for (var i = 0; i < points.length; i++) {
-                var timeInSeconds = points[i].x / sampleRate
-                lineSeries.append(timeInSeconds, points[i].y)
-                if (points[i].y < minY) minY = points[i].y
-                if (points[i].y > maxY) maxY = points[i].y
-            }
+        if (extent.min !== undefined && sampleRate > 0) {
+            var minY = extent.min
+            var maxY = extent.max
 
-            var totalTimeInSeconds = (points[points.length - 1].x) / sampleRate
+            var totalTimeInSeconds = (numSamples - 1) / sampleRate
+            axisX.min = 0
             axisX.max = totalTimeInSeconds
             axisY.min = minY - Math.abs(minY * 0.1)
             axisY.max = maxY + Math.abs(maxY * 0.1)
@@ -118,33 +116,22 @@ Rectangle {
         updateLabelOverlays()
     }
 
-    property var visibleData: []
-
     function updateYAxisForVisibleRange() {
         var startTime = axisX.min
         var endTime = axisX.max
 
-        var startIdx = Math.floor(startTime * appController.sampleRate)
+        var startIdx = Math.max(0, Math.floor(startTime * appController.sampleRate))
         var endIdx = Math.ceil(endTime * appController.sampleRate)
 
-        var minVoltage = Number.MAX_VALUE
-        var maxVoltage = -Number.MAX_VALUE
-
-        for (var i = 0; i < visibleData.length; i++) {
-            var point = visibleData[i]
-            var sampleIdx = point.x
-            var voltage = point.y
-
-            if (sampleIdx >= startIdx && sampleIdx <= endIdx) {
-                minVoltage = Math.min(minVoltage, voltage)
-                maxVoltage = Math.max(maxVoltage, voltage)
-            }
-        }
-
-        if (minVoltage === Number.MAX_VALUE || maxVoltage === -Number.MAX_VALUE) {
+        // Exact min/max of the visible samples from the C++ pyramid
+        var extent = appController.getWaveformExtent(startIdx, endIdx + 1)
+        if (extent.min === undefined) {
             return
         }
 
+        var minVoltage = extent.min
+        var maxVoltage = extent.max
+
         var voltageRange = maxVoltage - minVoltage
 
         var zoomFactor = (originalXMax - originalXMin) / (endTime - startTime)
@@ -258,12 +245,18 @@ Rectangle {
             labelOverlayContainer.children[i].destroy()
         }
 
-        var labels = labelManager.labels
-        console.log("Updating label overlays, count:", labels.length)
+        if (!dataLoaded || appController.sampleRate <= 0) {
+            return
+        }
+
+        // Only labels intersecting the visible range get an overlay
+        var labels = labelManager.getLabelsInRange(Math.floor(axisX.min * appController.sampleRate),
+                                                   Math.ceil(axisX.max * appController.sampleRate))
+        console.log("Updating label overlays, visible count:", labels.length)
 
+        var overlayComponent = Qt.createComponent("LabelOverlay.qml")
         for (var j = 0; j < labels.length; j++) {
             var label = labels[j]
-            console.log("  Label #" + j + ": ID=" + label.id + ", Name='" + label.label + "', Color=" + label.color + ", Indices=" + label.startIndex + "-" + label.endIndex)
 
             var startTime = label.startIndex / appController.sampleRate
             var endTime = label.endIndex / appController.sampleRate
@@ -274,10 +267,8 @@ Rectangle {
             var overlayX = startPos.x - chart.plotArea.x
             var overlayWidth = endPos.x - startPos.x
 
-            console.log("    Calculated overlay position: x=" + overlayX + ", width=" + overlayWidth + ", startPos.x=" + startPos.x + ", endPos.x=" + endPos.x)
-
             if (overlayWidth > 0) {
-                var overlay = Qt.createComponent("LabelOverlay.qml").createObject(
+                var overlay = overlayComponent.createObject(
                     labelOverlayContainer,
                     {
                         labelText: label.label,
@@ -300,8 +291,6 @@ Rectangle {
                     return
                 }
 
-                console.log("    ✓ Created label overlay successfully: x=" + overlay.x + ", width=" + overlay.width + ", visible=" + overlay.visible + ", color=" + overlay.labelColor)
-
                 overlay.deleteRequested.connect(function(id) {
                     console.log("Right-click delete requested for label ID:", id)
                     labelManager.removeLabel(id)
@@ -366,6 +355,7 @@ Rectangle {
             minorGridLineColor: "#13182b"
         }
 
+        // Carries the axes for mapToPosition/mapToValue; holds no points
         LineSeries {
             id: lineSeries
             name: "Signal"
@@ -373,6 +363,80 @@ Rectangle {
             axisY: axisY
             width: 1.5
             color: "#00aaff"
+        }
+
+        // Spectrogram behind the trace: one Image per STFT tile in view,
+        // computed on demand by the "spectrogram" image provider
+        Item {
+            id: spectrogramLayer
+            x: chart.plotArea.x
+            y: chart.plotArea.y
+            width: chart.plotArea.width
+            height: chart.plotArea.height
+            clip: true
+            visible: dataLoaded && spectrogramVisible
+
+            property real visibleStart: axisX.min * appController.sampleRate
+            property real visibleSpan: (axisX.max - axisX.min) * appController.sampleRate
+
+            Repeater {
+                model: spectrogramTiles
+
+                Image {
+                    x: (modelData.startSample - spectrogramLayer.visibleStart) / spectrogramLayer.visibleSpan * spectrogramLayer.width
+                    width: (modelData.endSample - modelData.startSample) / spectrogramLayer.visibleSpan * spectrogramLayer.width
+                    height: spectrogramLayer.height
+                    source: modelData.source
+                    fillMode: Image.Stretch
+                    asynchronous: true
+                    smooth: true
+                }
+            }
+
+            Text {
+                anchors.top: parent.top
+                anchors.left: parent.left
+                anchors.margins: 4
+                text: spectrogramController.maxFrequency.toFixed(0) + " Hz"
+                font.pixelSize: 9
+                color: "#e0e0e0"
+            }
+
+            Text {
+                anchors.bottom: parent.bottom
+                anchors.left: parent.left
+                anchors.margins: 4
+                text: "0 Hz"
+                font.pixelSize: 9
+                color: "#e0e0e0"
+            }
+        }
+
+        // Scene-graph trace over the plot area, fed straight from ChannelData
+        WaveformItem {
+            id: waveformItem
+            x: chart.plotArea.x
+            y: chart.plotArea.y
+            width: chart.plotArea.width
+            height: chart.plotArea.height
+            clip: true
+            visible: dataLoaded
+            controller: appController
+            startSample: axisX.min * appController.sampleRate
+            endSample: axisX.max * appController.sampleRate
+            minValue: axisY.min
+            maxValue: axisY.max
+            color: lineSeries.color
+        }
+
+        // Live filter preview of the visible range (from FilterDesignWindow)
+        LineSeries {
+            id: previewSeries
+            name: "Filter Preview"
+            axisX: axisX
+            axisY: axisY
+            width: 1
+            color: "#ffaa00"
             useOpenGL: true
         }
 
@@ -763,6 +827,77 @@ Rectangle {
         }
     }
 
+    // Fetch the spectrogram tiles covering the visible time range
+    function updateSpectrogramTiles() {
+        var sampleRate = appController.sampleRate
+        if (!dataLoaded || !spectrogramVisible || sampleRate <= 0) {
+            spectrogramTiles = []
+            return
+        }
+        spectrogramTiles = spectrogramController.getVisibleTiles(Math.floor(axisX.min * sampleRate),
+                                                                 Math.ceil(axisX.max * sampleRate) + 1,
+                                                                 Math.round(chart.plotArea.width))
+    }
+
+    onSpectrogramVisibleChanged: updateSpectrogramTiles()
+    onDataLoadedChanged: updateSpectrogramTiles()
+
+    // Tell the filter controller what is visible, for previews
+    function updatePreviewRange() {
+        var sampleRate = appController.sampleRate
+        if (!dataLoaded || sampleRate <= 0) {
+            return
+        }
+        filterController.setPreviewRange(Math.floor(axisX.min * sampleRate),
+                                         Math.ceil(axisX.max * sampleRate) + 1,
+                                         Math.round(chart.plotArea.width))
+    }
+
+    Connections {
+        target: axisX
+
+        function onMinChanged() {
+            updatePreviewRange()
+            updateSpectrogramTiles()
+            labelOverlayTimer.restart()
+        }
+        function onMaxChanged() {
+            updatePreviewRange()
+            updateSpectrogramTiles()
+            labelOverlayTimer.restart()
+        }
+    }
+
+    // Coalesces the min/max change pair of one pan/zoom step into a single
+    // rebuild of the visible label overlays
+    Timer {
+        id: labelOverlayTimer
+        interval: 0
+        onTriggered: updateLabelOverlays()
+    }
+
+    Connections {
+        target: spectrogramController
+
+        function onSpectrogramChanged() { updateSpectrogramTiles() }
+    }
+
+    Connections {
+        target: filterController
+
+        function onPreviewUpdated(points) {
+            var sampleRate = appController.sampleRate
+            previewSeries.clear()
+            for (var i = 0; i < points.length; i++) {
+                previewSeries.append(points[i].x / sampleRate, points[i].y)
+            }
+        }
+
+        function onPreviewCleared() {
+            previewSeries.clear()
+        }
+    }
+
     // Listen to label manager changes
     Connections {
         target: labelManager